@@ -0,0 +1,104 @@
+#version 450 core
+
+layout (local_size_x = 64) in;
+
+#include "include/clipping_planes.glsl"
+#include "include/objects.glsl"
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430, binding = 2) writeonly buffer CommandBuffer {
+    DrawCommand commands[];
+};
+
+layout (std430, binding = 3) buffer CountBuffer {
+    uint drawCounts[];
+};
+
+// The GPU-driven objects are one contiguous range of the object buffer.
+uniform int u_FirstObject;
+uniform int u_ObjectCount;
+uniform vec4 u_FrustumPlanes[6];
+
+// Depth pyramid of the previous frame, each texel the farthest depth of the
+// pixels below it, and the matrix that frame was drawn with.
+layout (binding = 0) uniform sampler2D u_HiZ;
+uniform bool u_UseHiZ;
+uniform mat4 u_HiZViewProjection;
+
+bool outsidePlane(vec4 plane, vec3 center, vec3 extents) {
+    return dot(plane.xyz, center) + dot(abs(plane.xyz), extents) + plane.w < 0.0;
+}
+
+bool occludedByHiZ(vec3 boundsMin, vec3 boundsMax) {
+    vec3 ndcMin = vec3(1.0e30);
+    vec3 ndcMax = vec3(-1.0e30);
+    for (int i = 0; i < 8; i++) {
+        vec3 corner = vec3((i & 1) != 0 ? boundsMax.x : boundsMin.x,
+                           (i & 2) != 0 ? boundsMax.y : boundsMin.y,
+                           (i & 4) != 0 ? boundsMax.z : boundsMin.z);
+        vec4 clip = u_HiZViewProjection * vec4(corner, 1.0);
+        // Reaching the near plane: the box surrounds the eye.
+        if (clip.w <= 0.0 || clip.z < -clip.w)
+            return false;
+        vec3 ndc = clip.xyz / clip.w;
+        ndcMin = min(ndcMin, ndc);
+        ndcMax = max(ndcMax, ndc);
+    }
+
+    vec2 hiZSize = vec2(textureSize(u_HiZ, 0));
+    vec2 pixelMin = clamp(ndcMin.xy * 0.5 + 0.5, 0.0, 1.0) * hiZSize;
+    vec2 pixelMax = clamp(ndcMax.xy * 0.5 + 0.5, 0.0, 1.0) * hiZSize;
+    vec2 size = pixelMax - pixelMin;
+
+    // The level where the rectangle spans at most two texels per axis.
+    int levels = textureQueryLevels(u_HiZ);
+    int level = int(ceil(log2(max(max(size.x, size.y), 1.0))));
+    level = clamp(level, 0, levels - 1);
+
+    // Odd edges are folded into the last texel of each level, so clamping
+    // to it stays conservative.
+    ivec2 levelSize = textureSize(u_HiZ, level);
+    ivec2 texelMin = min(ivec2(pixelMin) >> level, levelSize - 1);
+    ivec2 texelMax = min(ivec2(pixelMax) >> level, levelSize - 1);
+
+    float farthest = 0.0;
+    for (int y = texelMin.y; y <= texelMax.y; y++)
+        for (int x = texelMin.x; x <= texelMax.x; x++)
+            farthest = max(farthest, texelFetch(u_HiZ, ivec2(x, y), level).r);
+
+    return ndcMin.z * 0.5 + 0.5 > farthest;
+}
+
+void main() {
+    if (gl_GlobalInvocationID.x >= uint(u_ObjectCount))
+        return;
+    uint index = uint(u_FirstObject) + gl_GlobalInvocationID.x;
+
+    ObjectData object = objects[index];
+    vec3 center = (object.boundsMin.xyz + object.boundsMax.xyz) * 0.5;
+    vec3 extents = (object.boundsMax.xyz - object.boundsMin.xyz) * 0.5;
+
+    for (int i = 0; i < 6; i++)
+        if (outsidePlane(u_FrustumPlanes[i], center, extents))
+            return;
+    for (int i = 0; i < u_ActiveClippingPlanes; i++)
+        if (outsidePlane(u_ClippingPlanes[i], center, extents))
+            return;
+    if (u_UseHiZ &&
+        occludedByHiZ(object.boundsMin.xyz, object.boundsMax.xyz))
+        return;
+
+    uint slot = object.commandOffset + atomicAdd(drawCounts[object.batch], 1u);
+    commands[slot].count = object.indexCount;
+    commands[slot].instanceCount = 1u;
+    commands[slot].firstIndex = object.firstIndex;
+    commands[slot].baseVertex = object.baseVertex;
+    commands[slot].baseInstance = index;
+}
\ No newline at end of file
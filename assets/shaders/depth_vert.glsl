@@ -0,0 +1,17 @@
+#version 460 core
+layout (location = 0) in vec3 aPosition;
+
+#include "include/camera.glsl"
+#include "include/clipping.glsl"
+#include "include/objects.glsl"
+
+// Same expression as vert.glsl: with `invariant` both programs produce
+// bit-identical depth, which the GL_LEQUAL main pass relies on.
+invariant gl_Position;
+
+void main() {
+    vec3 worldPos = vec3(objects[gl_BaseInstance].model * vec4(aPosition, 1.0));
+    applyClipping(worldPos);
+
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
\ No newline at end of file
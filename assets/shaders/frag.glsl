@@ -1,48 +1,104 @@
 #version 460 core
 
+#ifdef BINDLESS_TEXTURES
+#extension GL_ARB_bindless_texture : require
+#endif
+
 out vec4 FragColor;
 
 in vec2 TexCoord;
 in vec3 Normal;
 in vec3 FragPos;
 
-layout (std140) uniform CameraData {
-    mat4 view;
-    mat4 projection;
-    vec3 viewPos;
+#include "include/camera.glsl"
+#include "include/lights.glsl"
+#include "include/shadows.glsl"
+
+#if defined(BINDLESS_TEXTURES) || defined(ARRAY_TEXTURES)
+// .xy = bindless handle or array index + layer, .z = texture present
+struct MaterialData {
+    uvec4 diffuse;
+    uvec4 specular;
 };
 
+layout (std430, binding = 0) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+};
+
+flat in int MaterialIndex;
+#endif
+
+#ifdef ARRAY_TEXTURES
+#define MAX_TEXTURE_ARRAYS 12
+layout (binding = 0) uniform sampler2DArray u_TextureArrays[MAX_TEXTURE_ARRAYS];
+#endif
+
+#if !defined(BINDLESS_TEXTURES) && !defined(ARRAY_TEXTURES)
 uniform sampler2D texture_diffuse;
 uniform sampler2D texture_specular;
+#endif
 uniform float materialShininess;
 uniform vec3 lightPos;
 
-#define MAX_CLIPPING_PLANES 8
-uniform int u_ActiveClippingPlanes;
-uniform vec4 u_ClippingPlanes[MAX_CLIPPING_PLANES];
+#if defined(BINDLESS_TEXTURES) || defined(ARRAY_TEXTURES)
+vec4 sampleMaterialTexture(uvec4 ref, vec4 fallback) {
+    if (ref.z == 0u) return fallback;
+#ifdef BINDLESS_TEXTURES
+    return texture(sampler2D(ref.xy), TexCoord);
+#else
+    // ref.x only depends on the draw's material, so it is the same across
+    // every invocation of a draw.
+    return texture(u_TextureArrays[ref.x], vec3(TexCoord, float(ref.y)));
+#endif
+}
+#endif
 
-void main() {
-    for (int i = 0; i < u_ActiveClippingPlanes; i++) {
-        if (dot(vec4(FragPos, 1.0), u_ClippingPlanes[i]) < 0.0) discard;
-    }
+void addLight(vec3 lightDir, vec3 radiance, vec3 norm, vec3 viewDir,
+              inout vec3 diffuse, inout vec3 specular) {
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
+    diffuse += diff * radiance;
+    specular += spec * radiance;
+}
 
+void main() {
     float ambientStrength = 0.1;
     vec3 ambient = ambientStrength * vec3(1.0, 1.0, 1.0);
 
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 viewDir = normalize(viewPos - FragPos);
 
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * vec3(1.0, 1.0, 1.0);
+    vec3 diffuse = vec3(0.0);
+    vec3 spec = vec3(0.0);
+    addLight(normalize(lightPos - FragPos), vec3(mainLightShadow(FragPos)),
+             norm, viewDir, diffuse, spec);
 
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32.0);
+    // Only the lights binned into this fragment's cluster.
+    float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+    uvec2 cluster = lightCluster(viewDepth);
+    for (uint i = 0u; i < cluster.y; i++) {
+        PointLight light = lights[lightIndices[cluster.x + i]];
+        vec3 toLight = light.positionRadius.xyz - FragPos;
+        float distance = length(toLight);
+        if (distance >= light.positionRadius.w)
+            continue;
+        vec3 radiance = light.colorIntensity.rgb * light.colorIntensity.w *
+                        lightAttenuation(distance, light.positionRadius.w);
+        addLight(toLight / max(distance, 1.0e-4), radiance, norm, viewDir,
+                 diffuse, spec);
+    }
 
+#if defined(BINDLESS_TEXTURES) || defined(ARRAY_TEXTURES)
+    MaterialData material = materials[MaterialIndex];
+    vec3 specularMapColor = sampleMaterialTexture(material.specular, vec4(0.0)).rgb;
+    vec4 objectColor = sampleMaterialTexture(material.diffuse, vec4(1.0));
+#else
     vec3 specularMapColor = vec3(texture(texture_specular, TexCoord));
+    vec4 objectColor = texture(texture_diffuse, TexCoord);
+#endif
 
     vec3 specular = 0.5 * spec * specularMapColor;
-    vec4 objectColor = texture(texture_diffuse, TexCoord);
     vec3 result = (ambient + diffuse) * objectColor.rgb + specular;
 
     float gamma = 1.1;
@@ -0,0 +1,37 @@
+#version 450 core
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+// Level 0 copies the depth buffer; every other level keeps the farthest of
+// the 2x2 (up to 3x3 next to an odd edge) texels below it.
+layout (binding = 0) uniform sampler2D u_Depth;
+layout (r32f, binding = 0) readonly uniform image2D u_Source;
+layout (r32f, binding = 1) writeonly uniform image2D u_Destination;
+
+uniform bool u_FromDepth;
+
+void main() {
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(u_Destination);
+    if (texel.x >= size.x || texel.y >= size.y)
+        return;
+
+    if (u_FromDepth) {
+        imageStore(u_Destination, texel, vec4(texelFetch(u_Depth, texel, 0).r));
+        return;
+    }
+
+    ivec2 sourceSize = imageSize(u_Source);
+    ivec2 first = texel * 2;
+    ivec2 last = first + 1;
+    if (texel.x == size.x - 1)
+        last.x = sourceSize.x - 1;
+    if (texel.y == size.y - 1)
+        last.y = sourceSize.y - 1;
+
+    float farthest = 0.0;
+    for (int y = first.y; y <= last.y; y++)
+        for (int x = first.x; x <= last.x; x++)
+            farthest = max(farthest, imageLoad(u_Source, ivec2(x, y)).r);
+    imageStore(u_Destination, texel, vec4(farthest));
+}
\ No newline at end of file
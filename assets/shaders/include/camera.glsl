@@ -0,0 +1,5 @@
+layout (std140) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+};
\ No newline at end of file
@@ -0,0 +1,17 @@
+#include "clipping_planes.glsl"
+
+out float gl_ClipDistance[MAX_CLIPPING_PLANES];
+
+// Clipping happens in hardware after the vertex stage, so fragment shaders
+// never discard and early depth testing stays on.
+void applyClipping(vec3 worldPos) {
+    for (int i = 0; i < u_ActiveClippingPlanes; i++)
+        gl_ClipDistance[i] = dot(vec4(worldPos, 1.0), u_ClippingPlanes[i]);
+}
+
+// For geometry that should ignore the planes (every enabled distance has to
+// be written).
+void disableClipping() {
+    for (int i = 0; i < u_ActiveClippingPlanes; i++)
+        gl_ClipDistance[i] = 1.0;
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#define MAX_CLIPPING_PLANES 8
+
+layout (std140) uniform ClippingData {
+    vec4 u_ClippingPlanes[MAX_CLIPPING_PLANES];
+    int u_ActiveClippingPlanes;
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+// Clustered point lights (LightClusters). Each cluster of the froxel grid
+// holds an (offset, count) range of lightIndices.
+struct PointLight {
+    vec4 positionRadius;
+    vec4 colorIntensity;
+};
+
+layout (std430, binding = 4) readonly buffer LightBuffer {
+    PointLight lights[];
+};
+
+layout (std430, binding = 5) readonly buffer ClusterBuffer {
+    uvec2 clusters[];
+};
+
+layout (std430, binding = 6) readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
+
+layout (std140) uniform LightingData {
+    uvec4 clusterGrid; // xyz = grid size, w = light count
+    vec2 clusterDepthParams; // slice = log(depth) * x + y
+    vec2 clusterTileSize; // in pixels
+};
+
+uvec2 lightCluster(float viewDepth) {
+    uvec3 cell;
+    cell.xy = min(uvec2(gl_FragCoord.xy / clusterTileSize),
+                  clusterGrid.xy - 1u);
+    float slice = log(max(viewDepth, 1.0e-4)) * clusterDepthParams.x +
+                  clusterDepthParams.y;
+    cell.z = uint(clamp(slice, 0.0, float(clusterGrid.z - 1u)));
+    return clusters[(cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x];
+}
+
+// Smooth falloff that reaches exactly zero at the light's radius.
+float lightAttenuation(float distance, float radius) {
+    float ratio = distance / radius;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window / (distance * distance + 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+// Per-draw data, indexed by gl_BaseInstance. Mirrors ObjectData in
+// ObjectBuffer.hpp (std430).
+struct ObjectData {
+    mat4 model;
+    mat3 normalMatrix;
+    vec4 boundsMin;
+    vec4 boundsMax;
+    uint indexCount;
+    uint firstIndex;
+    int baseVertex;
+    int materialIndex;
+    uint commandOffset;
+    uint batch;
+    uint padding0;
+    uint padding1;
+};
+
+layout (std430, binding = 1) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+};
\ No newline at end of file
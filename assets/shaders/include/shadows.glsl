@@ -0,0 +1,21 @@
+// Cube shadow map of the main light (ShadowMap), holding the distance to
+// the light over the far plane.
+layout (std140) uniform ShadowData {
+    vec4 shadowLight; // xyz = light position, w = far plane (0 = no shadows)
+    vec4 shadowParams; // x = depth bias relative to distance
+};
+
+layout (binding = 15) uniform samplerCubeShadow u_ShadowMap;
+
+// 1 where the main light reaches `worldPos`, 0 in its shadow, filtered by
+// the hardware comparison in between.
+float mainLightShadow(vec3 worldPos) {
+    if (shadowLight.w <= 0.0)
+        return 1.0;
+    vec3 toFragment = worldPos - shadowLight.xyz;
+    float depth = length(toFragment) / shadowLight.w;
+    if (depth >= 1.0)
+        return 1.0;
+    float reference = depth * (1.0 - shadowParams.x);
+    return texture(u_ShadowMap, vec4(toFragment, reference));
+}
\ No newline at end of file
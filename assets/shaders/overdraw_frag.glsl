@@ -0,0 +1,8 @@
+#version 460 core
+out vec4 FragColor;
+
+// Drawn with additive blending: every shaded fragment adds one step, so the
+// image brightens with the number of times a pixel was shaded.
+void main() {
+    FragColor = vec4(0.08, 0.04, 0.01, 1.0);
+}
\ No newline at end of file
@@ -1,14 +1,13 @@
 #version 460 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 model;
-layout (std140) uniform CameraData {
-  mat4 view;
-  mat4 projection;
-  vec3 viewPos;
-};
+#include "include/camera.glsl"
+#include "include/clipping.glsl"
+#include "include/objects.glsl"
 
 void main()
 {
-  gl_Position = projection * view * model * vec4(aPos, 1.0);
+  gl_Position = projection * view * objects[gl_BaseInstance].model *
+                vec4(aPos, 1.0);
+  disableClipping();
 }
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 460 core
+
+in vec3 WorldPos;
+
+uniform vec3 u_LightPos;
+uniform float u_FarPlane;
+
+// Linear distance to the light, so every face of the cube shares one scale.
+void main() {
+    gl_FragDepth = length(WorldPos - u_LightPos) / u_FarPlane;
+}
\ No newline at end of file
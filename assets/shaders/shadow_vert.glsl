@@ -0,0 +1,17 @@
+#version 460 core
+layout (location = 0) in vec3 aPosition;
+
+#include "include/clipping.glsl"
+#include "include/objects.glsl"
+
+// One cube face of the main light's shadow map.
+uniform mat4 u_LightViewProjection;
+
+out vec3 WorldPos;
+
+void main() {
+    WorldPos = vec3(objects[gl_BaseInstance].model * vec4(aPosition, 1.0));
+    applyClipping(WorldPos);
+
+    gl_Position = u_LightViewProjection * vec4(WorldPos, 1.0);
+}
\ No newline at end of file
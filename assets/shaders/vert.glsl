@@ -4,22 +4,30 @@ layout (location = 0) in vec3 aPosition;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
-layout (std140) uniform CameraData {
-    mat4 view;
-    mat4 projection;
-    vec3 viewPos;
-};
+#include "include/camera.glsl"
+#include "include/clipping.glsl"
+#include "include/objects.glsl"
 
 out vec2 TexCoord;
 out vec3 Normal;
 out vec3 FragPos;
 
-uniform mat4 model;
+#if defined(BINDLESS_TEXTURES) || defined(ARRAY_TEXTURES)
+flat out int MaterialIndex;
+#endif
+
+invariant gl_Position;
 
 void main() {
-    FragPos = vec3(model * vec4(aPosition, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    ObjectData object = objects[gl_BaseInstance];
+#if defined(BINDLESS_TEXTURES) || defined(ARRAY_TEXTURES)
+    MaterialIndex = object.materialIndex;
+#endif
+
+    FragPos = vec3(object.model * vec4(aPosition, 1.0));
+    Normal = object.normalMatrix * aNormal;
     TexCoord = aTexCoords;
+    applyClipping(FragPos);
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "App.hpp"
 #include "Core/Input.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/Log.hpp"
 #include "Editor/EditorLayer.hpp"
 
@@ -16,6 +17,29 @@ App::App(const Config &config, std::filesystem::path modelPath) {
 
   Input::init(m_window->getHandle());
 
+  m_targetFps = config.window.TargetFPS;
+  m_backgroundFps = config.window.BackgroundFPS;
+
+  m_exitAfterReplay = config.system.ExitAfterReplay;
+  if (!config.system.ReplayInput.empty())
+    m_inputRecorder.startReplay(config.system.ReplayInput,
+                                m_window->getWidth(), m_window->getHeight());
+  else if (!config.system.RecordInput.empty())
+    m_inputRecorder.startRecording(config.system.RecordInput,
+                                   m_window->getWidth(),
+                                   m_window->getHeight());
+
+  // Workers outlive the layers (the singleton shuts down at exit), so layers
+  // can still wait on their jobs while being destroyed.
+  const bool pinWorkers = config.system.PinWorkerThreads;
+  JobSystem::get().init(
+      config.system.WorkerThreads, [pinWorkers](unsigned int index) {
+        JobSystem::setCurrentThreadName("Worker " + std::to_string(index));
+        // Core 0 is left to the main thread.
+        if (pinWorkers)
+          JobSystem::setCurrentThreadAffinity(index + 1);
+      });
+
   for (const auto &[action, key] : config.bindings) {
     m_inputManager.setBinding(action, key);
   }
@@ -31,13 +55,27 @@ App::~App() { glfwTerminate(); }
 
 void App::run() {
   while (m_isRunning) {
+    // Waiting here rather than after the swap means the frame is built from
+    // input polled just after the wait, not from input a whole frame old.
+    m_framePacer.setTargetFps(m_window->isActive() ? m_targetFps
+                                                   : m_backgroundFps);
+    m_framePacer.wait();
+
+    // Everything polled is delivered to the layers in one batch.
+    m_window->pollEvents();
+    m_window->dispatchEvents();
+    if (!m_isRunning)
+      break;
+
     float time = (float)glfwGetTime();
     float dt = time - m_lastFrameTime;
     m_lastFrameTime = time;
 
-    Input::update();
+    updateInput(dt);
     m_inputManager.update();
 
+    JobSystem::get().executeMainThreadJobs();
+
     for (Layer *layer : m_layerStack) {
       layer->onUpdate(dt);
     }
@@ -48,16 +86,41 @@ void App::run() {
     }
     m_imguiLayer->end();
 
-    m_window->onUpdate();
+    m_window->swapBuffers();
   }
 }
 
+void App::updateInput(float &dt) {
+  if (m_inputRecorder.isReplaying()) {
+    InputSnapshot snapshot;
+    if (m_inputRecorder.replayFrame(
+            dt, snapshot, [this](Event &e) { this->dispatchEvent(e); })) {
+      Input::update(snapshot);
+      return;
+    }
+    if (m_exitAfterReplay)
+      m_isRunning = false;
+  }
+
+  Input::update();
+  m_inputRecorder.recordFrame(dt, Input::getSnapshot());
+}
+
 void App::onEvent(Event &e) {
   if (e.getType() == EventType::WindowClose) {
     m_isRunning = false;
     return;
   }
 
+  // While replaying, the log is the only source of input.
+  if (m_inputRecorder.isReplaying() && e.isInCategory(EventCategoryInput))
+    return;
+  m_inputRecorder.recordEvent(e);
+
+  dispatchEvent(e);
+}
+
+void App::dispatchEvent(Event &e) {
   for (auto it = m_layerStack.rbegin(); it != m_layerStack.rend(); ++it) {
     (*it)->onEvent(e);
     if (e.m_handled) {
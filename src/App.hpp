@@ -2,7 +2,9 @@
 
 #include "Config.hpp"
 #include "Core/Event.hpp"
+#include "Core/FramePacer.hpp"
 #include "Core/InputManager.hpp"
+#include "Core/InputRecorder.hpp"
 #include "Core/LayerStack.hpp"
 #include "Core/Window.hpp"
 #include "UI/ImGuiLayer.hpp"
@@ -19,6 +21,9 @@ public:
   void onEvent(Event &e);
 
 private:
+  void dispatchEvent(Event &e);
+  void updateInput(float &dt);
+
   std::unique_ptr<Window> m_window;
   bool m_isRunning = true;
 
@@ -26,6 +31,12 @@ private:
   ImGuiLayer *m_imguiLayer;
 
   InputManager m_inputManager;
+  InputRecorder m_inputRecorder;
+  bool m_exitAfterReplay = false;
 
   float m_lastFrameTime = 0.0f;
+
+  FramePacer m_framePacer;
+  float m_targetFps = 0.0f;
+  float m_backgroundFps = 0.0f;
 };
\ No newline at end of file
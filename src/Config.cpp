@@ -44,6 +44,40 @@ Action stringToAction(const std::string &str) {
   return Action::None;
 }
 
+VSyncMode stringToVSyncMode(const std::string &str) {
+  if (str == "Off")
+    return VSyncMode::Off;
+  if (str == "On")
+    return VSyncMode::On;
+  return VSyncMode::Adaptive;
+}
+
+TextureBindingMode stringToTextureBindingMode(const std::string &str) {
+  if (str == "Classic")
+    return TextureBindingMode::Classic;
+  if (str == "Arrays")
+    return TextureBindingMode::Arrays;
+  if (str == "Bindless")
+    return TextureBindingMode::Bindless;
+  return TextureBindingMode::Auto;
+}
+
+DepthPrePassMode stringToDepthPrePassMode(const std::string &str) {
+  if (str == "Off")
+    return DepthPrePassMode::Off;
+  if (str == "On")
+    return DepthPrePassMode::On;
+  return DepthPrePassMode::Auto;
+}
+
+ImportPreset stringToImportPreset(const std::string &str) {
+  if (str == "Fast")
+    return ImportPreset::Fast;
+  if (str == "MaxQuality")
+    return ImportPreset::MaxQuality;
+  return ImportPreset::Balanced;
+}
+
 Config Config::load(const std::string &path) {
   Config config;
 
@@ -74,6 +108,12 @@ Config Config::load(const std::string &path) {
         config.window.Height = w["Height"];
       if (w.contains("Title"))
         config.window.Title = w["Title"];
+      if (w.contains("VSync"))
+        config.window.VSync = stringToVSyncMode(w["VSync"]);
+      if (w.contains("TargetFPS"))
+        config.window.TargetFPS = w["TargetFPS"];
+      if (w.contains("BackgroundFPS"))
+        config.window.BackgroundFPS = w["BackgroundFPS"];
     }
 
     if (j.contains("Render")) {
@@ -82,6 +122,34 @@ Config Config::load(const std::string &path) {
         r["ClearColor"].get_to(config.render.ClearColor);
       if (r.contains("LightPosition"))
         r["LightPosition"].get_to(config.render.LightPosition);
+      if (r.contains("TextureBinding"))
+        config.render.TextureBinding =
+            stringToTextureBindingMode(r["TextureBinding"]);
+      if (r.contains("ShaderCache"))
+        config.render.ShaderCache = r["ShaderCache"];
+      if (r.contains("ShaderHotReload"))
+        config.render.ShaderHotReload = r["ShaderHotReload"];
+      if (r.contains("ShaderCacheDirectory"))
+        config.render.ShaderCacheDirectory = r["ShaderCacheDirectory"];
+      if (r.contains("DepthPrePass"))
+        config.render.DepthPrePass =
+            stringToDepthPrePassMode(r["DepthPrePass"]);
+      if (r.contains("DepthPrePassOverdraw"))
+        config.render.DepthPrePassOverdraw = r["DepthPrePassOverdraw"];
+      if (r.contains("OcclusionCulling"))
+        config.render.OcclusionCulling = r["OcclusionCulling"];
+      if (r.contains("GPUCulling"))
+        config.render.GPUCulling = r["GPUCulling"];
+      if (r.contains("MeshletCulling"))
+        config.render.MeshletCulling = r["MeshletCulling"];
+      if (r.contains("BackfaceCulling"))
+        config.render.BackfaceCulling = r["BackfaceCulling"];
+      if (r.contains("Shadows"))
+        config.render.Shadows = r["Shadows"];
+      if (r.contains("ShadowMapSize"))
+        config.render.ShadowMapSize = r["ShadowMapSize"];
+      if (r.contains("ShadowFarPlane"))
+        config.render.ShadowFarPlane = r["ShadowFarPlane"];
     }
 
     if (j.contains("Camera")) {
@@ -98,6 +166,53 @@ Config Config::load(const std::string &path) {
         config.camera.NearPlane = c["NearPlane"];
       if (c.contains("FarPlane"))
         config.camera.FarPlane = c["FarPlane"];
+      if (c.contains("LateLatch"))
+        config.camera.LateLatch = c["LateLatch"];
+    }
+
+    if (j.contains("Texture")) {
+      auto &t = j["Texture"];
+      if (t.contains("Compress"))
+        config.texture.Compress = t["Compress"];
+      if (t.contains("HighQualityDiffuse"))
+        config.texture.HighQualityDiffuse = t["HighQualityDiffuse"];
+      if (t.contains("CacheDirectory"))
+        config.texture.CacheDirectory = t["CacheDirectory"];
+      if (t.contains("Streaming"))
+        config.texture.Streaming = t["Streaming"];
+      if (t.contains("StreamingInitialSize"))
+        config.texture.StreamingInitialSize = t["StreamingInitialSize"];
+      if (t.contains("StreamingBudgetMB"))
+        config.texture.StreamingBudgetMB = t["StreamingBudgetMB"];
+      if (t.contains("StreamingUploadMBPerFrame"))
+        config.texture.StreamingUploadMBPerFrame =
+            t["StreamingUploadMBPerFrame"];
+    }
+
+    if (j.contains("Import")) {
+      auto &i = j["Import"];
+      if (i.contains("Preset"))
+        config.import.Preset = stringToImportPreset(i["Preset"]);
+      if (i.contains("LogStages"))
+        config.import.LogStages = i["LogStages"];
+      if (i.contains("Split16BitMeshes"))
+        config.import.Split16BitMeshes = i["Split16BitMeshes"];
+      if (i.contains("Meshlets"))
+        config.import.Meshlets = i["Meshlets"];
+    }
+
+    if (j.contains("System")) {
+      auto &s = j["System"];
+      if (s.contains("WorkerThreads"))
+        config.system.WorkerThreads = s["WorkerThreads"];
+      if (s.contains("PinWorkerThreads"))
+        config.system.PinWorkerThreads = s["PinWorkerThreads"];
+      if (s.contains("RecordInput"))
+        config.system.RecordInput = s["RecordInput"];
+      if (s.contains("ReplayInput"))
+        config.system.ReplayInput = s["ReplayInput"];
+      if (s.contains("ExitAfterReplay"))
+        config.system.ExitAfterReplay = s["ExitAfterReplay"];
     }
 
     if (j.contains("Paths")) {
@@ -108,6 +223,22 @@ Config Config::load(const std::string &path) {
         config.paths.ShaderVert = p["ShaderVert"];
       if (p.contains("ShaderFrag"))
         config.paths.ShaderFrag = p["ShaderFrag"];
+      if (p.contains("DepthShaderVert"))
+        config.paths.DepthShaderVert = p["DepthShaderVert"];
+      if (p.contains("DepthShaderFrag"))
+        config.paths.DepthShaderFrag = p["DepthShaderFrag"];
+      if (p.contains("OverdrawShaderFrag"))
+        config.paths.OverdrawShaderFrag = p["OverdrawShaderFrag"];
+      if (p.contains("CullShaderComp"))
+        config.paths.CullShaderComp = p["CullShaderComp"];
+      if (p.contains("HiZShaderComp"))
+        config.paths.HiZShaderComp = p["HiZShaderComp"];
+      if (p.contains("ShadowShaderVert"))
+        config.paths.ShadowShaderVert = p["ShadowShaderVert"];
+      if (p.contains("ShadowShaderFrag"))
+        config.paths.ShadowShaderFrag = p["ShadowShaderFrag"];
+      if (p.contains("SceneSnapshot"))
+        config.paths.SceneSnapshot = p["SceneSnapshot"];
     }
 
     if (j.contains("Bindings")) {
@@ -6,15 +6,51 @@
 #include <map>
 #include <string>
 
+// Adaptive only syncs when the frame is on time and tears instead of
+// stalling a whole refresh when it is late; it needs the
+// *_EXT_swap_control_tear extension and falls back to On otherwise.
+enum class VSyncMode { Off = 0, On, Adaptive };
+
 struct WindowConfig {
   unsigned int Width = 1280;
   unsigned int Height = 960;
   std::string Title = "Deltaviewer";
+
+  VSyncMode VSync = VSyncMode::Adaptive;
+  // Frame rate caps, 0 = uncapped. BackgroundFPS applies while the window is
+  // unfocused or minimized.
+  float TargetFPS = 0.0f;
+  float BackgroundFPS = 30.0f;
 };
 
+// How materials reach their textures. Auto picks Bindless when the driver
+// exposes ARB_bindless_texture and falls back to Arrays otherwise.
+enum class TextureBindingMode { Auto = 0, Classic, Arrays, Bindless };
+
+// Depth-only pass over the opaque queue before shading it. Auto turns it on
+// while the estimated opaque overdraw exceeds DepthPrePassOverdraw.
+enum class DepthPrePassMode { Off = 0, On, Auto };
+
 struct RenderConfig {
   glm::vec4 ClearColor = {0.1f, 0.1f, 0.2f, 1.0f};
   glm::vec3 LightPosition = {2.0f, 2.0f, 2.0f};
+  TextureBindingMode TextureBinding = TextureBindingMode::Auto;
+  bool ShaderCache = true;
+  bool ShaderHotReload = true;
+  std::string ShaderCacheDirectory = "cache/shaders";
+  DepthPrePassMode DepthPrePass = DepthPrePassMode::Auto;
+  float DepthPrePassOverdraw = 2.5f;
+  bool OcclusionCulling = true;
+  bool GPUCulling = true;
+  bool MeshletCulling = true;
+  // Two-sided rendering when off, which also rules out dropping meshlets
+  // that face away from the camera.
+  bool BackfaceCulling = false;
+  // Cube shadow map for the main light. Static casters are cached and only
+  // faces that changed are redrawn.
+  bool Shadows = true;
+  int ShadowMapSize = 1024;
+  float ShadowFarPlane = 50.0f;
 };
 
 struct CameraConfig {
@@ -24,6 +60,53 @@ struct CameraConfig {
   float NearPlane = 0.1f;
   float FarPlane = 100.0f;
   glm::vec3 StartPosition = {0.0f, 0.0f, 7.5f};
+  // Re-read the mouse right before the scene is drawn and re-upload the
+  // camera, instead of using the look direction from the top of the frame.
+  // CPU occlusion culling is skipped while this is on.
+  bool LateLatch = true;
+};
+
+struct TextureConfig {
+  bool Compress = true;
+  bool HighQualityDiffuse = false;
+  std::string CacheDirectory = "cache/textures";
+
+  bool Streaming = true;
+  int StreamingInitialSize = 128;
+  unsigned int StreamingBudgetMB = 512;
+  unsigned int StreamingUploadMBPerFrame = 32;
+};
+
+// Model import pipeline. Fast runs only the steps the renderer needs;
+// Balanced also drops degenerate and non-triangle faces, generates smooth
+// normals, welds identical vertices and reorders triangles for the
+// post-transform cache; MaxQuality always goes through Assimp (bypassing the
+// native OBJ/GLB readers) and also validates the data and merges small
+// meshes. Missing normals are filled in under every preset.
+enum class ImportPreset { Fast = 0, Balanced, MaxQuality };
+
+struct ImportConfig {
+  ImportPreset Preset = ImportPreset::Balanced;
+  // Logs each stage's wall time, vertex counts and geometry size.
+  bool LogStages = true;
+  // Splits meshes with more than 65,535 vertices into chunks that can use
+  // 16-bit indices, at the cost of a few duplicated vertices and draws.
+  bool Split16BitMeshes = false;
+  // Partitions meshes of at least Meshlet::MIN_MESH_TRIANGLES triangles into
+  // clusters the renderer can cull one by one.
+  bool Meshlets = true;
+};
+
+struct SystemConfig {
+  // 0 = one worker per hardware thread, minus the main thread.
+  unsigned int WorkerThreads = 0;
+  bool PinWorkerThreads = false;
+
+  // Input log to capture the session to, or to play back instead of live
+  // input (see InputRecorder). Also settable with --record / --replay.
+  std::string RecordInput;
+  std::string ReplayInput;
+  bool ExitAfterReplay = false;
 };
 
 struct PathConfig {
@@ -32,12 +115,23 @@ struct PathConfig {
   std::string ShaderFrag = "assets/shaders/frag.glsl";
   std::string PlaneShaderVert = "assets/shaders/plane_vert.glsl";
   std::string PlaneShaderFrag = "assets/shaders/plane_frag.glsl";
+  std::string DepthShaderVert = "assets/shaders/depth_vert.glsl";
+  std::string DepthShaderFrag = "assets/shaders/depth_frag.glsl";
+  std::string OverdrawShaderFrag = "assets/shaders/overdraw_frag.glsl";
+  std::string CullShaderComp = "assets/shaders/cull_comp.glsl";
+  std::string HiZShaderComp = "assets/shaders/hiz_comp.glsl";
+  std::string ShadowShaderVert = "assets/shaders/shadow_vert.glsl";
+  std::string ShadowShaderFrag = "assets/shaders/shadow_frag.glsl";
+  std::string SceneSnapshot = "scene.dvscene";
 };
 
 struct Config {
   WindowConfig window;
   RenderConfig render;
   CameraConfig camera;
+  TextureConfig texture;
+  ImportConfig import;
+  SystemConfig system;
   PathConfig paths;
 
   std::map<Action, KeyCode> bindings;
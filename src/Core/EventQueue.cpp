@@ -0,0 +1,42 @@
+#include "Core/EventQueue.hpp"
+#include "Core/Log.hpp"
+
+EventQueue::~EventQueue() {
+  for (Pool &pool : m_pools)
+    pool.clear();
+}
+
+void EventQueue::Pool::clear() {
+  for (size_t i = 0; i < count; i++)
+    at(i).~Event();
+  count = 0;
+}
+
+void EventQueue::dispatch() {
+  if (m_dispatching)
+    return;
+
+  Pool &front = m_pools[m_back];
+  m_back ^= 1;
+
+  m_dispatching = true;
+  if (m_handler) {
+    for (size_t i = 0; i < front.count; i++)
+      m_handler(front.at(i));
+  }
+  m_dispatching = false;
+
+  front.clear();
+}
+
+void EventQueue::onOverflow() {
+  // Outside a dispatch the backlog can simply be delivered early. During one,
+  // the other pool is still being walked, so there is nowhere to put more.
+  if (!m_dispatching) {
+    dispatch();
+    return;
+  }
+  LOG_CORE_WARN("EventQueue: more than {0} events queued during dispatch, "
+                "dropping",
+                CAPACITY);
+}
\ No newline at end of file
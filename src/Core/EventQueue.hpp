@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Core/Event.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Collects window events between polls and hands them to the layers in one
+// batch per frame. Events are placement-constructed into fixed slots of two
+// preallocated pools (one being filled while the other is dispatched), so a
+// burst of input never allocates. Runs of mouse moves and resizes keep only
+// the latest event, and runs of scrolls add up into one.
+class EventQueue {
+public:
+  using Handler = std::function<void(Event &)>;
+
+  static constexpr size_t CAPACITY = 512;
+
+  EventQueue() = default;
+  ~EventQueue();
+
+  EventQueue(const EventQueue &) = delete;
+  EventQueue &operator=(const EventQueue &) = delete;
+
+  void setHandler(const Handler &handler) { m_handler = handler; }
+
+  template <typename T, typename... Args> void push(Args &&...args);
+
+  // Delivers everything queued so far, in order. Events pushed by the
+  // handlers themselves are kept for the next dispatch.
+  void dispatch();
+
+  [[nodiscard]] size_t size() const { return m_pools[m_back].count; }
+  [[nodiscard]] size_t getCoalescedCount() const { return m_coalesced; }
+
+private:
+  static constexpr size_t SLOT_SIZE = std::max(
+      {sizeof(KeyPressedEvent), sizeof(KeyReleasedEvent),
+       sizeof(KeyTypedEvent), sizeof(MouseMovedEvent),
+       sizeof(MouseScrolledEvent), sizeof(MouseButtonPressedEvent),
+       sizeof(MouseButtonReleasedEvent), sizeof(WindowResizeEvent),
+       sizeof(WindowCloseEvent)});
+  static constexpr size_t SLOT_ALIGN = alignof(std::max_align_t);
+
+  struct alignas(SLOT_ALIGN) Slot {
+    unsigned char bytes[SLOT_SIZE];
+  };
+
+  struct Pool {
+    std::array<Slot, CAPACITY> slots;
+    size_t count = 0;
+
+    Event &at(size_t i) {
+      return *std::launder(reinterpret_cast<Event *>(slots[i].bytes));
+    }
+    void clear();
+  };
+
+  std::array<Pool, 2> m_pools;
+  size_t m_back = 0;
+  bool m_dispatching = false;
+  size_t m_coalesced = 0;
+  Handler m_handler;
+
+  template <typename T> bool coalesce(const T &event);
+  void onOverflow();
+};
+
+template <typename T, typename... Args>
+void EventQueue::push(Args &&...args) {
+  static_assert(std::is_base_of_v<Event, T>, "EventQueue only holds events");
+  static_assert(sizeof(T) <= SLOT_SIZE && alignof(T) <= SLOT_ALIGN,
+                "Event type does not fit an EventQueue slot");
+
+  T event(std::forward<Args>(args)...);
+  if (coalesce(event)) {
+    m_coalesced++;
+    return;
+  }
+
+  if (m_pools[m_back].count == CAPACITY)
+    onOverflow();
+  Pool &pool = m_pools[m_back];
+  if (pool.count == CAPACITY)
+    return;
+
+  new (pool.slots[pool.count].bytes) T(std::move(event));
+  pool.count++;
+}
+
+template <typename T> bool EventQueue::coalesce(const T &event) {
+  Pool &pool = m_pools[m_back];
+  if (pool.count == 0)
+    return false;
+  Event &last = pool.at(pool.count - 1);
+  if (last.getType() != event.getType())
+    return false;
+
+  if constexpr (std::is_same_v<T, MouseMovedEvent> ||
+                std::is_same_v<T, WindowResizeEvent>) {
+    static_cast<T &>(last) = event;
+    return true;
+  } else if constexpr (std::is_same_v<T, MouseScrolledEvent>) {
+    auto &scroll = static_cast<MouseScrolledEvent &>(last);
+    scroll = MouseScrolledEvent(scroll.getXOffset() + event.getXOffset(),
+                                scroll.getYOffset() + event.getYOffset());
+    return true;
+  } else {
+    return false;
+  }
+}
\ No newline at end of file
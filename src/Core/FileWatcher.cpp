@@ -0,0 +1,116 @@
+#include "Core/FileWatcher.hpp"
+#include "Core/Log.hpp"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher() {
+#ifdef __linux__
+  m_inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotifyFD < 0)
+    LOG_CORE_WARN("FileWatcher: inotify unavailable, polling timestamps");
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+  if (m_inotifyFD >= 0)
+    close(m_inotifyFD);
+#endif
+}
+
+std::string FileWatcher::normalize(const std::string &path) {
+  std::error_code ec;
+  auto normalized = std::filesystem::weakly_canonical(path, ec);
+  return ec ? path : normalized.string();
+}
+
+void FileWatcher::watch(const std::string &path) {
+  std::string file = normalize(path);
+  if (m_files.find(file) != m_files.end())
+    return;
+
+  std::error_code ec;
+  m_files[file] = std::filesystem::last_write_time(file, ec);
+
+#ifdef __linux__
+  if (m_inotifyFD < 0)
+    return;
+
+  std::string directory = std::filesystem::path(file).parent_path().string();
+  for (const auto &[wd, watched] : m_directories) {
+    if (watched == directory)
+      return;
+  }
+
+  int wd = inotify_add_watch(m_inotifyFD, directory.c_str(),
+                             IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (wd < 0) {
+    LOG_CORE_WARN("FileWatcher: Cannot watch {0}", directory);
+    return;
+  }
+  m_directories[wd] = directory;
+#endif
+}
+
+std::vector<std::string> FileWatcher::poll() {
+  std::vector<std::string> changed =
+      m_inotifyFD >= 0 ? pollInotify() : pollTimestamps();
+
+  std::sort(changed.begin(), changed.end());
+  changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+  return changed;
+}
+
+std::vector<std::string> FileWatcher::pollInotify() {
+  std::vector<std::string> changed;
+
+#ifdef __linux__
+  alignas(inotify_event) char buffer[4096];
+  while (true) {
+    ssize_t length = read(m_inotifyFD, buffer, sizeof(buffer));
+    if (length <= 0)
+      break;
+
+    for (ssize_t offset = 0; offset < length;) {
+      const auto *event = reinterpret_cast<const inotify_event *>(buffer +
+                                                                  offset);
+      offset += sizeof(inotify_event) + event->len;
+
+      auto directory = m_directories.find(event->wd);
+      if (directory == m_directories.end() || event->len == 0)
+        continue;
+
+      std::string file =
+          (std::filesystem::path(directory->second) / event->name).string();
+      if (m_files.find(file) != m_files.end())
+        changed.push_back(file);
+    }
+  }
+#endif
+
+  return changed;
+}
+
+std::vector<std::string> FileWatcher::pollTimestamps() {
+  std::vector<std::string> changed;
+
+  auto now = std::chrono::steady_clock::now();
+  if (now - m_lastScan < std::chrono::milliseconds(250))
+    return changed;
+  m_lastScan = now;
+
+  for (auto &[file, lastWrite] : m_files) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(file, ec);
+    if (!ec && time != lastWrite) {
+      lastWrite = time;
+      changed.push_back(file);
+    }
+  }
+  return changed;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Reports modified files without blocking. Uses inotify on Linux (watching
+// parent directories, since editors often save by renaming over the file)
+// and falls back to comparing timestamps a few times per second elsewhere.
+class FileWatcher {
+public:
+  FileWatcher();
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher &other) = delete;
+  FileWatcher &operator=(const FileWatcher &other) = delete;
+
+  void watch(const std::string &path);
+
+  // Normalized paths changed since the last call; each is listed once.
+  std::vector<std::string> poll();
+
+  static std::string normalize(const std::string &path);
+
+private:
+  int m_inotifyFD = -1;
+  std::unordered_map<int, std::string> m_directories;
+  std::unordered_map<std::string, std::filesystem::file_time_type> m_files;
+
+  std::chrono::steady_clock::time_point m_lastScan;
+
+  std::vector<std::string> pollInotify();
+  std::vector<std::string> pollTimestamps();
+};
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "Core/FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+void FramePacer::setTargetFps(float fps) {
+  fps = std::max(fps, 0.0f);
+  if (fps == m_targetFps)
+    return;
+
+  m_targetFps = fps;
+  m_interval = fps > 0.0f ? std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(1.0 / fps))
+                          : Clock::duration::zero();
+  m_nextFrame = Clock::now();
+}
+
+void FramePacer::wait() {
+  auto start = Clock::now();
+  if (m_interval == Clock::duration::zero()) {
+    m_lastWaitMs = 0.0f;
+    return;
+  }
+
+  if (m_nextFrame > start) {
+    preciseSleep(m_nextFrame);
+    m_nextFrame += m_interval;
+  } else {
+    // Running late: start the schedule over rather than rushing the next
+    // few frames to catch up.
+    m_nextFrame = start + m_interval;
+  }
+
+  m_lastWaitMs =
+      std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+void FramePacer::preciseSleep(Clock::time_point until) {
+  using Seconds = std::chrono::duration<double>;
+
+  while (true) {
+    double remaining = Seconds(until - Clock::now()).count();
+    if (remaining <= m_sleepMean + 2.0 * std::sqrt(m_sleepVariance))
+      break;
+
+    auto before = Clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    double observed = Seconds(Clock::now() - before).count();
+
+    // Exponentially weighted, so the estimate follows changes in scheduler
+    // behaviour (power states, timer resolution).
+    constexpr double ALPHA = 0.05;
+    double delta = observed - m_sleepMean;
+    m_sleepMean += ALPHA * delta;
+    m_sleepVariance = (1.0 - ALPHA) * (m_sleepVariance + ALPHA * delta * delta);
+  }
+
+  while (Clock::now() < until)
+    std::this_thread::yield();
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+
+// Caps the frame rate by holding the main loop at the top of each frame.
+// The OS sleep only has millisecond-ish granularity (much worse on some
+// platforms), so the wait sleeps in short slices while the remaining time
+// is comfortably above the observed sleep overshoot and spins for the rest.
+class FramePacer {
+public:
+  // 0 disables the cap.
+  void setTargetFps(float fps);
+  [[nodiscard]] float getTargetFps() const { return m_targetFps; }
+
+  void wait();
+
+  // Time spent in the last wait(), in milliseconds.
+  [[nodiscard]] float getLastWaitMs() const { return m_lastWaitMs; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  float m_targetFps = 0.0f;
+  Clock::duration m_interval = Clock::duration::zero();
+  Clock::time_point m_nextFrame;
+  float m_lastWaitMs = 0.0f;
+
+  // Moving estimate of how long a 1 ms sleep really takes, in seconds.
+  double m_sleepMean = 0.0015;
+  double m_sleepVariance = 0.0;
+
+  void preciseSleep(Clock::time_point until);
+};
\ No newline at end of file
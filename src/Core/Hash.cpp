@@ -0,0 +1,160 @@
+#include "Core/Hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t LANES = 8;
+constexpr size_t STRIPE_SIZE = LANES * sizeof(uint64_t);
+// Lanes are scrambled once per block so long inputs cannot drive the
+// multiply-accumulate state into a degenerate pattern.
+constexpr size_t STRIPES_PER_BLOCK = 16;
+
+constexpr uint64_t PRIME32 = 0x9E3779B1ull;
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+
+// splitmix64 outputs.
+constexpr uint64_t KEY[LANES] = {
+    0xe220a8397b1dcdafull, 0x6e789e6aa1b965f4ull, 0x06c45d188009454full,
+    0xf88bb8a8724c81ecull, 0x1b39896a51a8749bull, 0x53cb9f0c747ea2eaull,
+    0x2c829abe1f4532e1ull, 0xc584133ac916ab3cull};
+constexpr uint64_t FINAL_LOW = 0x3ee5789041c98ac3ull;
+constexpr uint64_t FINAL_HIGH = 0xf3b8488c368cb0a6ull;
+
+uint64_t avalanche(uint64_t h) {
+  h ^= h >> 37;
+  h *= PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+// Low and high halves of the full 128-bit product, folded together.
+uint64_t multiplyFold(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  return static_cast<uint64_t>(product) ^
+         static_cast<uint64_t>(product >> 64);
+#else
+  const uint64_t aLow = a & 0xFFFFFFFFull, aHigh = a >> 32;
+  const uint64_t bLow = b & 0xFFFFFFFFull, bHigh = b >> 32;
+  const uint64_t lowLow = aLow * bLow;
+  const uint64_t highLow = aHigh * bLow;
+  const uint64_t lowHigh = aLow * bHigh;
+  const uint64_t cross =
+      (lowLow >> 32) + (highLow & 0xFFFFFFFFull) + lowHigh;
+  const uint64_t low = (cross << 32) | (lowLow & 0xFFFFFFFFull);
+  const uint64_t high = aHigh * bHigh + (highLow >> 32) + (cross >> 32);
+  return low ^ high;
+#endif
+}
+
+// Each lane adds its neighbour's input and the product of its own keyed
+// input's two halves.
+void accumulate(uint64_t *acc, const unsigned char *data, size_t stripes,
+                const uint64_t *key) {
+#ifdef HASH_SSE2
+  __m128i a[LANES / 2], k[LANES / 2];
+  for (size_t j = 0; j < LANES / 2; j++) {
+    a[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + j * 2));
+    k[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + j * 2));
+  }
+  for (size_t s = 0; s < stripes; s++) {
+    const unsigned char *stripe = data + s * STRIPE_SIZE;
+    for (size_t j = 0; j < LANES / 2; j++) {
+      __m128i d =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(stripe + j * 16));
+      __m128i keyed = _mm_xor_si128(d, k[j]);
+      __m128i high = _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1));
+      __m128i product = _mm_mul_epu32(keyed, high);
+      __m128i swapped = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+      a[j] = _mm_add_epi64(a[j], _mm_add_epi64(product, swapped));
+    }
+  }
+  for (size_t j = 0; j < LANES / 2; j++)
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + j * 2), a[j]);
+#else
+  for (size_t s = 0; s < stripes; s++) {
+    const unsigned char *stripe = data + s * STRIPE_SIZE;
+    for (size_t i = 0; i < LANES; i++) {
+      uint64_t d;
+      std::memcpy(&d, stripe + i * sizeof(uint64_t), sizeof(d));
+      const uint64_t keyed = d ^ key[i];
+      acc[i ^ 1] += d;
+      acc[i] += (keyed & 0xFFFFFFFFull) * (keyed >> 32);
+    }
+  }
+#endif
+}
+
+void scramble(uint64_t *acc, const uint64_t *key) {
+#ifdef HASH_SSE2
+  const __m128i prime = _mm_set1_epi32(static_cast<int>(PRIME32));
+  for (size_t j = 0; j < LANES / 2; j++) {
+    __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + j * 2));
+    a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+    a = _mm_xor_si128(
+        a, _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + j * 2)));
+    // 64 x 32-bit multiply from two 32 x 32 -> 64 products.
+    __m128i low = _mm_mul_epu32(a, prime);
+    __m128i high =
+        _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+    a = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + j * 2), a);
+  }
+#else
+  for (size_t i = 0; i < LANES; i++)
+    acc[i] = (acc[i] ^ (acc[i] >> 47) ^ key[i]) * PRIME32;
+#endif
+}
+
+} // namespace
+
+Hash128 Hash::content128(const void *data, size_t size, const Hash128 &seed) {
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+
+  uint64_t key[LANES];
+  for (size_t i = 0; i < LANES; i++)
+    key[i] = KEY[i] ^ (i & 1 ? seed.high : seed.low);
+  uint64_t acc[LANES] = {PRIME32,   PRIME64_1, PRIME64_2, PRIME64_3,
+                         ~PRIME32,  ~PRIME64_1, ~PRIME64_2, ~PRIME64_3};
+
+  size_t stripes = size / STRIPE_SIZE;
+  while (stripes > 0) {
+    const size_t count = std::min(stripes, STRIPES_PER_BLOCK);
+    accumulate(acc, bytes, count, key);
+    bytes += count * STRIPE_SIZE;
+    stripes -= count;
+    if (count == STRIPES_PER_BLOCK)
+      scramble(acc, key);
+  }
+
+  // The zero padding is told apart from real zeros by the length below.
+  const size_t tail = size % STRIPE_SIZE;
+  if (tail > 0) {
+    unsigned char last[STRIPE_SIZE] = {};
+    std::memcpy(last, bytes, tail);
+    accumulate(acc, last, 1, key);
+  }
+
+  Hash128 result;
+  result.low = FINAL_LOW ^ (static_cast<uint64_t>(size) * PRIME64_1);
+  result.high = FINAL_HIGH ^ (static_cast<uint64_t>(size) * PRIME64_2);
+  for (size_t i = 0; i < LANES; i += 2) {
+    result.low += multiplyFold(acc[i] ^ key[i], acc[i + 1] ^ key[i + 1]);
+    result.high += multiplyFold(acc[i] ^ key[(i + 3) % LANES],
+                                acc[i + 1] ^ key[(i + 6) % LANES]);
+  }
+  result.low = avalanche(result.low);
+  result.high = avalanche(result.high);
+  return result;
+}
\ No newline at end of file
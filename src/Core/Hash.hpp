@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct Hash128 {
+  uint64_t low = 0;
+  uint64_t high = 0;
+
+  bool operator==(const Hash128 &other) const {
+    return low == other.low && high == other.high;
+  }
+  bool operator!=(const Hash128 &other) const { return !(*this == other); }
+
+  struct Hasher {
+    size_t operator()(const Hash128 &hash) const {
+      return static_cast<size_t>(hash.low);
+    }
+  };
+};
+
+class Hash {
+public:
+  static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+  static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+  static uint64_t fnv1a(const void *data, size_t size,
+                        uint64_t seed = FNV_OFFSET) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+      hash ^= bytes[i];
+      hash *= FNV_PRIME;
+    }
+    return hash;
+  }
+
+  static uint64_t fnv1a(const std::string &str, uint64_t seed = FNV_OFFSET) {
+    return fnv1a(str.data(), str.size(), seed);
+  }
+
+  // Fast 128-bit hash for bulk content (vertex, index and texel data),
+  // where FNV-1a's byte loop would cost more than the import itself. Eight
+  // 64-bit multiply-accumulate lanes take 64-byte stripes, two lanes per
+  // SSE2 register; the scalar fallback produces the same values. Not
+  // cryptographic: only for spotting identical content. `seed` chains
+  // several buffers into one hash.
+  static Hash128 content128(const void *data, size_t size,
+                            const Hash128 &seed = Hash128());
+
+  static std::string toHex(uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(16, '0');
+    for (int i = 15; i >= 0; i--) {
+      out[i] = digits[value & 0xF];
+      value >>= 4;
+    }
+    return out;
+  }
+
+  static std::string toHex(const Hash128 &value) {
+    return toHex(value.high) + toHex(value.low);
+  }
+};
\ No newline at end of file
@@ -3,9 +3,11 @@
 #include <GLFW/glfw3.h>
 
 GLFWwindow *Input::s_window = nullptr;
+InputSnapshot Input::s_snapshot;
 glm::vec2 Input::s_mousePos = {0.0f, 0.0f};
 glm::vec2 Input::s_mouseDelta = {0.0f, 0.0f};
 bool Input::s_firstMouse = true;
+bool Input::s_live = true;
 
 void Input::init(GLFWwindow *window) {
   s_window = window;
@@ -19,9 +21,30 @@ void Input::update() {
   if (!s_window)
     return;
 
+  static_assert(InputSnapshot::KEY_COUNT == GLFW_KEY_LAST + 1);
+  static_assert(InputSnapshot::MOUSE_BUTTON_COUNT ==
+                GLFW_MOUSE_BUTTON_LAST + 1);
+
+  InputSnapshot snapshot;
+  for (int key = GLFW_KEY_SPACE; key <= GLFW_KEY_LAST; key++)
+    snapshot.keys[key] = glfwGetKey(s_window, key) == GLFW_PRESS;
+  for (int button = 0; button <= GLFW_MOUSE_BUTTON_LAST; button++) {
+    if (glfwGetMouseButton(s_window, button) == GLFW_PRESS)
+      snapshot.mouseButtons |= uint8_t(1u << button);
+  }
+
   double x, y;
   glfwGetCursorPos(s_window, &x, &y);
-  glm::vec2 currentPos = {(float)x, (float)y};
+  snapshot.mousePosition = {(float)x, (float)y};
+
+  update(snapshot);
+  s_live = true;
+}
+
+void Input::update(const InputSnapshot &snapshot) {
+  s_snapshot = snapshot;
+  s_live = false;
+  glm::vec2 currentPos = snapshot.mousePosition;
 
   if (s_firstMouse) {
     s_mousePos = currentPos;
@@ -34,16 +57,37 @@ void Input::update() {
 }
 
 bool Input::isKeyPressed(KeyCode keycode) {
-  return glfwGetKey(s_window, static_cast<int>(keycode)) == GLFW_PRESS;
+  int key = static_cast<int>(keycode);
+  return key >= 0 && key < InputSnapshot::KEY_COUNT && s_snapshot.keys[key];
 }
 
 bool Input::isMouseButtonPressed(MouseCode button) {
-  return glfwGetMouseButton(s_window, static_cast<int>(button)) == GLFW_PRESS;
+  int index = static_cast<int>(button);
+  return index >= 0 && index < InputSnapshot::MOUSE_BUTTON_COUNT &&
+         (s_snapshot.mouseButtons & (1u << index));
 }
 
 glm::vec2 Input::getMousePosition() { return s_mousePos; }
 glm::vec2 Input::getMouseDelta() { return s_mouseDelta; }
 
+glm::vec2 Input::sampleMouseDelta() {
+  if (!s_window || !s_live || s_firstMouse)
+    return {0.0f, 0.0f};
+
+  // GLFW only updates the cursor position while processing events. Anything
+  // else this picks up stays queued until the next frame's dispatch.
+  glfwPollEvents();
+
+  double x, y;
+  glfwGetCursorPos(s_window, &x, &y);
+  glm::vec2 currentPos = {(float)x, (float)y};
+
+  glm::vec2 delta = currentPos - s_mousePos;
+  delta.y = -delta.y;
+  s_mousePos = currentPos;
+  return delta;
+}
+
 void Input::setCursorMode(CursorMode mode) {
   if (!s_window)
     return;
@@ -3,15 +3,31 @@
 #include "Core/KeyCodes.hpp"
 #include <glm/glm.hpp>
 
+#include <bitset>
+#include <cstdint>
+
 struct GLFWwindow;
 
 enum class CursorMode { Normal = 0, Hidden = 1, Locked = 2 };
 
+// Raw device state for one frame. Everything Input reports is derived from
+// it, so a recorded session can be fed back in place of GLFW polling.
+struct InputSnapshot {
+  static constexpr int KEY_COUNT = 349; // GLFW_KEY_LAST + 1
+  static constexpr int MOUSE_BUTTON_COUNT = 8;
+
+  std::bitset<KEY_COUNT> keys;
+  uint8_t mouseButtons = 0;
+  glm::vec2 mousePosition = {0.0f, 0.0f};
+};
+
 class Input {
 public:
   static void init(GLFWwindow *window);
 
+  // Polls GLFW, or takes the given state instead (input replay).
   static void update();
+  static void update(const InputSnapshot &snapshot);
 
   static bool isKeyPressed(KeyCode keycode);
 
@@ -20,11 +36,20 @@ public:
   static glm::vec2 getMousePosition();
 
   static glm::vec2 getMouseDelta();
+  // Polls the cursor again and returns how far it moved since the last
+  // update or sample, so the view can be re-latched just before rendering.
+  // Zero while replaying recorded input; the recorder does not log these
+  // samples (see InputRecorder).
+  static glm::vec2 sampleMouseDelta();
   static void setCursorMode(CursorMode mode);
 
+  static const InputSnapshot &getSnapshot() { return s_snapshot; }
+
 private:
   static GLFWwindow *s_window;
+  static InputSnapshot s_snapshot;
   static glm::vec2 s_mousePos;
   static glm::vec2 s_mouseDelta;
   static bool s_firstMouse;
+  static bool s_live;
 };
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "Core/InputRecorder.hpp"
+#include "Core/Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+constexpr uint32_t INPUT_LOG_MAGIC = 0x52495644; // "DVIR"
+constexpr uint32_t INPUT_LOG_VERSION = 1;
+
+struct InputLogHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+};
+
+struct FrameRecord {
+  float dt;
+  float mouseX, mouseY;
+  uint16_t keyChangeCount;
+  uint16_t eventCount;
+  uint8_t mouseButtons;
+  uint8_t reserved[3];
+};
+
+static_assert(sizeof(FrameRecord) == 20, "FrameRecord must stay packed");
+static_assert(sizeof(InputRecorder::RecordedEvent) == 12,
+              "RecordedEvent must stay packed");
+
+InputRecorder::RecordedEvent encode(const Event &event) {
+  InputRecorder::RecordedEvent record{};
+  record.type = static_cast<uint8_t>(event.getType());
+
+  switch (event.getType()) {
+  case EventType::KeyPressed: {
+    auto &e = static_cast<const KeyPressedEvent &>(event);
+    record.code = static_cast<uint16_t>(e.getKeyCode());
+    record.repeat = e.isRepeat();
+    break;
+  }
+  case EventType::KeyReleased:
+  case EventType::KeyTyped:
+    record.code = static_cast<uint16_t>(
+        static_cast<const KeyEvent &>(event).getKeyCode());
+    break;
+  case EventType::MouseButtonPressed:
+  case EventType::MouseButtonReleased:
+    record.code = static_cast<uint16_t>(
+        static_cast<const MouseButtonEvent &>(event).getMouseButton());
+    break;
+  case EventType::MouseMoved: {
+    auto &e = static_cast<const MouseMovedEvent &>(event);
+    record.x = e.getX();
+    record.y = e.getY();
+    break;
+  }
+  case EventType::MouseScrolled: {
+    auto &e = static_cast<const MouseScrolledEvent &>(event);
+    record.x = e.getXOffset();
+    record.y = e.getYOffset();
+    break;
+  }
+  case EventType::WindowResize: {
+    auto &e = static_cast<const WindowResizeEvent &>(event);
+    record.x = static_cast<float>(e.getWidth());
+    record.y = static_cast<float>(e.getHeight());
+    break;
+  }
+  default:
+    break;
+  }
+  return record;
+}
+
+void replay(const InputRecorder::RecordedEvent &record,
+            const InputRecorder::EventHandler &dispatch) {
+  switch (static_cast<EventType>(record.type)) {
+  case EventType::KeyPressed: {
+    KeyPressedEvent event((KeyCode)record.code, record.repeat != 0);
+    dispatch(event);
+    break;
+  }
+  case EventType::KeyReleased: {
+    KeyReleasedEvent event((KeyCode)record.code);
+    dispatch(event);
+    break;
+  }
+  case EventType::KeyTyped: {
+    KeyTypedEvent event((KeyCode)record.code);
+    dispatch(event);
+    break;
+  }
+  case EventType::MouseButtonPressed: {
+    MouseButtonPressedEvent event((MouseCode)record.code);
+    dispatch(event);
+    break;
+  }
+  case EventType::MouseButtonReleased: {
+    MouseButtonReleasedEvent event((MouseCode)record.code);
+    dispatch(event);
+    break;
+  }
+  case EventType::MouseMoved: {
+    MouseMovedEvent event(record.x, record.y);
+    dispatch(event);
+    break;
+  }
+  case EventType::MouseScrolled: {
+    MouseScrolledEvent event(record.x, record.y);
+    dispatch(event);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+} // namespace
+
+InputRecorder::~InputRecorder() { stop(); }
+
+bool InputRecorder::startRecording(const std::string &path,
+                                   unsigned int width, unsigned int height) {
+  stop();
+
+  m_output.open(path, std::ios::binary | std::ios::trunc);
+  if (!m_output.is_open()) {
+    LOG_CORE_ERROR("InputRecorder: Cannot write {0}", path);
+    return false;
+  }
+
+  InputLogHeader header{INPUT_LOG_MAGIC, INPUT_LOG_VERSION, width, height};
+  m_output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  m_path = path;
+  m_lastSnapshot = InputSnapshot();
+  m_frameCount = 0;
+  LOG_CORE_INFO("Recording input to {0}", path);
+  return true;
+}
+
+bool InputRecorder::startReplay(const std::string &path, unsigned int width,
+                                unsigned int height) {
+  stop();
+
+  if (!m_replay.open(path) || m_replay.size() < sizeof(InputLogHeader)) {
+    LOG_CORE_ERROR("InputRecorder: Cannot read {0}", path);
+    m_replay.close();
+    return false;
+  }
+
+  InputLogHeader header;
+  std::memcpy(&header, m_replay.data(), sizeof(header));
+  if (header.magic != INPUT_LOG_MAGIC || header.version != INPUT_LOG_VERSION) {
+    LOG_CORE_ERROR("InputRecorder: {0} is not an input log", path);
+    m_replay.close();
+    return false;
+  }
+  if (header.width != width || header.height != height)
+    LOG_CORE_WARN("InputRecorder: {0} was recorded at {1}x{2}, replaying at "
+                  "{3}x{4}",
+                  path, header.width, header.height, width, height);
+
+  m_path = path;
+  m_cursor = sizeof(InputLogHeader);
+  m_lastSnapshot = InputSnapshot();
+  m_frameCount = 0;
+  m_frameTimes.clear();
+  LOG_CORE_INFO("Replaying input from {0}", path);
+  return true;
+}
+
+void InputRecorder::stop() {
+  if (m_output.is_open()) {
+    m_output.close();
+    LOG_CORE_INFO("Input recording saved to {0} ({1} frames)", m_path,
+                  m_frameCount);
+  }
+  m_pendingEvents.clear();
+  m_replay.close();
+}
+
+bool InputRecorder::isRecordable(const Event &event) {
+  return (event.getCategoryFlags() & EventCategoryInput) ||
+         event.getType() == EventType::WindowResize;
+}
+
+void InputRecorder::recordEvent(const Event &event) {
+  if (isRecording() && isRecordable(event) &&
+      m_pendingEvents.size() < UINT16_MAX)
+    m_pendingEvents.push_back(encode(event));
+}
+
+void InputRecorder::recordFrame(float dt, const InputSnapshot &snapshot) {
+  if (!isRecording())
+    return;
+
+  std::vector<uint16_t> keyChanges;
+  auto changed = snapshot.keys ^ m_lastSnapshot.keys;
+  if (changed.any()) {
+    for (int key = 0; key < InputSnapshot::KEY_COUNT; key++) {
+      if (changed[key])
+        keyChanges.push_back(static_cast<uint16_t>(key));
+    }
+  }
+  m_lastSnapshot = snapshot;
+
+  FrameRecord frame{};
+  frame.dt = dt;
+  frame.mouseX = snapshot.mousePosition.x;
+  frame.mouseY = snapshot.mousePosition.y;
+  frame.keyChangeCount = static_cast<uint16_t>(keyChanges.size());
+  frame.eventCount = static_cast<uint16_t>(m_pendingEvents.size());
+  frame.mouseButtons = snapshot.mouseButtons;
+
+  m_output.write(reinterpret_cast<const char *>(&frame), sizeof(frame));
+  m_output.write(reinterpret_cast<const char *>(keyChanges.data()),
+                 keyChanges.size() * sizeof(uint16_t));
+  m_output.write(reinterpret_cast<const char *>(m_pendingEvents.data()),
+                 m_pendingEvents.size() * sizeof(RecordedEvent));
+  m_pendingEvents.clear();
+  m_frameCount++;
+
+  if (!m_output) {
+    LOG_CORE_ERROR("InputRecorder: Write to {0} failed, recording stopped",
+                   m_path);
+    m_output.close();
+  }
+}
+
+bool InputRecorder::replayFrame(float &dt, InputSnapshot &snapshot,
+                                const EventHandler &dispatch) {
+  if (!isReplaying())
+    return false;
+
+  const char *data = m_replay.data();
+  const size_t size = m_replay.size();
+
+  FrameRecord frame;
+  bool valid = m_cursor + sizeof(frame) <= size;
+  if (valid) {
+    std::memcpy(&frame, data + m_cursor, sizeof(frame));
+    valid = m_cursor + sizeof(frame) +
+                frame.keyChangeCount * sizeof(uint16_t) +
+                frame.eventCount * sizeof(RecordedEvent) <=
+            size;
+  }
+  if (!valid) {
+    if (m_cursor != size)
+      LOG_CORE_WARN("InputRecorder: {0} is truncated", m_path);
+    printReport();
+    m_replay.close();
+    return false;
+  }
+  m_cursor += sizeof(frame);
+
+  for (uint16_t i = 0; i < frame.keyChangeCount; i++) {
+    uint16_t key;
+    std::memcpy(&key, data + m_cursor, sizeof(key));
+    m_cursor += sizeof(key);
+    if (key < InputSnapshot::KEY_COUNT)
+      m_lastSnapshot.keys.flip(key);
+  }
+  m_lastSnapshot.mouseButtons = frame.mouseButtons;
+  m_lastSnapshot.mousePosition = {frame.mouseX, frame.mouseY};
+
+  for (uint16_t i = 0; i < frame.eventCount; i++) {
+    RecordedEvent record;
+    std::memcpy(&record, data + m_cursor, sizeof(record));
+    m_cursor += sizeof(record);
+    replay(record, dispatch);
+  }
+
+  // The first frame's wall time is dominated by startup, not rendering.
+  if (m_frameCount++ > 0)
+    m_frameTimes.push_back(dt);
+  dt = frame.dt;
+  snapshot = m_lastSnapshot;
+  return true;
+}
+
+void InputRecorder::printReport() const {
+  if (m_frameTimes.empty())
+    return;
+
+  std::vector<float> sorted = m_frameTimes;
+  std::sort(sorted.begin(), sorted.end());
+  auto percentile = [&sorted](float p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5f);
+    return sorted[index] * 1000.0f;
+  };
+  float total = std::accumulate(sorted.begin(), sorted.end(), 0.0f);
+
+  LOG_CORE_INFO("Replay of {0} finished: {1} frames in {2:.2f} s", m_path,
+                m_frameCount, total);
+  LOG_CORE_INFO("  Frame time (ms): avg {0:.2f}, p50 {1:.2f}, p95 {2:.2f}, "
+                "p99 {3:.2f}, max {4:.2f}",
+                total * 1000.0f / sorted.size(), percentile(0.5f),
+                percentile(0.95f), percentile(0.99f), sorted.back() * 1000.0f);
+}
\ No newline at end of file
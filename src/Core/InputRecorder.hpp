@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/Event.hpp"
+#include "Core/Input.hpp"
+#include "Core/MappedFile.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Captures a session's input to a compact binary log and plays it back.
+// Each frame stores its dt, the mouse position and buttons, the keys that
+// changed since the previous frame and the window events delivered just
+// before it. During replay the log stands in for GLFW: Input is fed the
+// recorded state, live input events are ignored and the frame times actually
+// achieved are summarised at the end, so a captured session doubles as a
+// repeatable performance test.
+//
+// Late-latch samples (Input::sampleMouseDelta()) are not logged. A frame's
+// recorded mouse position is taken before them, so on replay that movement
+// lands in the next frame's delta instead: the camera ends up in the same
+// place, one frame later than it did live.
+class InputRecorder {
+public:
+  using EventHandler = std::function<void(Event &)>;
+
+  InputRecorder() = default;
+  ~InputRecorder();
+
+  InputRecorder(const InputRecorder &) = delete;
+  InputRecorder &operator=(const InputRecorder &) = delete;
+
+  bool startRecording(const std::string &path, unsigned int width,
+                      unsigned int height);
+  bool startReplay(const std::string &path, unsigned int width,
+                   unsigned int height);
+  void stop();
+
+  [[nodiscard]] bool isRecording() const { return m_output.is_open(); }
+  [[nodiscard]] bool isReplaying() const { return m_replay.isOpen(); }
+
+  // Recording: events are attached to the frame that follows them.
+  void recordEvent(const Event &event);
+  void recordFrame(float dt, const InputSnapshot &snapshot);
+
+  // Replay: hands the frame's events to `dispatch`, then overwrites `dt`
+  // and `snapshot` with the recorded values. Returns false (and prints the
+  // frame time report) once the log is exhausted.
+  bool replayFrame(float &dt, InputSnapshot &snapshot,
+                   const EventHandler &dispatch);
+
+  // Input events and resizes are logged, but only input events are played
+  // back: the live window keeps its own size.
+  static bool isRecordable(const Event &event);
+
+  struct RecordedEvent {
+    uint8_t type;
+    uint8_t repeat;
+    uint16_t code;
+    float x, y;
+  };
+
+private:
+  std::ofstream m_output;
+  std::string m_path;
+  std::vector<RecordedEvent> m_pendingEvents;
+  InputSnapshot m_lastSnapshot;
+  uint64_t m_frameCount = 0;
+
+  MappedFile m_replay;
+  size_t m_cursor = 0;
+  std::vector<float> m_frameTimes;
+
+  void printReport() const;
+};
\ No newline at end of file
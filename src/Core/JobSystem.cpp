@@ -0,0 +1,379 @@
+#include "Core/JobSystem.hpp"
+#include "Core/Log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+thread_local int t_workerIndex = -1;
+
+} // namespace
+
+struct JobSystem::Task {
+  Job job;
+  JobCounter *counter;
+};
+
+// Chase-Lev deque with a fixed ring (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). Only the owning worker calls
+// push/pop; any thread may steal.
+struct JobSystem::Worker {
+  static constexpr int64_t CAPACITY = 4096;
+  static constexpr int64_t MASK = CAPACITY - 1;
+
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  std::array<std::atomic<Task *>, CAPACITY> buffer{};
+
+  std::thread thread;
+
+  bool push(Task *task) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= CAPACITY)
+      return false;
+
+    // Release on the slot as well as the fence, so a thief's acquire load of
+    // the pointer also publishes the task it points to.
+    buffer[b & MASK].store(task, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  Task *pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    Task *task = buffer[b & MASK].load(std::memory_order_relaxed);
+    if (t == b) {
+      // Last element: race thieves for it.
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed))
+        task = nullptr;
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  Task *steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b)
+      return nullptr;
+
+    Task *task = buffer[t & MASK].load(std::memory_order_acquire);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed))
+      return nullptr;
+    return task;
+  }
+};
+
+JobSystem::JobSystem() = default;
+
+JobSystem::~JobSystem() { shutdown(); }
+
+void JobSystem::init(unsigned int workerCount, ThreadStartHook onThreadStart) {
+  if (m_initialized)
+    return;
+  m_initialized = true;
+
+  if (workerCount == 0)
+    workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+  m_stopping = false;
+  for (unsigned int i = 0; i < workerCount; i++)
+    m_workers.push_back(std::make_unique<Worker>());
+
+  // Threads start only once every deque exists, since they steal from all.
+  for (unsigned int i = 0; i < workerCount; i++)
+    m_workers[i]->thread =
+        std::thread([this, i, onThreadStart]() { workerLoop(i, onThreadStart); });
+
+  m_backgroundStopping = false;
+  for (unsigned int i = 0; i < BACKGROUND_THREADS; i++)
+    m_backgroundThreads.emplace_back([this, i]() { backgroundLoop(i); });
+
+  LOG_CORE_INFO("JobSystem: {0} worker threads, {1} background threads",
+                workerCount, BACKGROUND_THREADS);
+}
+
+void JobSystem::shutdown() {
+  if (!m_initialized)
+    return;
+  m_initialized = false;
+
+  // Background jobs may still be feeding the workers, so they stop first.
+  {
+    std::lock_guard<std::mutex> lock(m_backgroundMutex);
+    m_backgroundStopping = true;
+  }
+  m_backgroundWake.notify_all();
+  for (auto &thread : m_backgroundThreads)
+    thread.join();
+  m_backgroundThreads.clear();
+
+  {
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all();
+
+  for (auto &worker : m_workers)
+    worker->thread.join();
+
+  // Anything still queued runs here so counters are never left hanging.
+  while (runOne()) {
+  }
+  m_workers.clear();
+
+  // No frame is left to run these on.
+  std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+  m_mainThreadJobs.clear();
+}
+
+void JobSystem::run(Job job, JobCounter *counter) {
+  if (counter)
+    counter->m_value.fetch_add(1, std::memory_order_relaxed);
+
+  if (m_workers.empty()) {
+    execute(new Task{std::move(job), counter});
+    return;
+  }
+
+  push(new Task{std::move(job), counter});
+}
+
+void JobSystem::runBackground(Job job, JobCounter *counter) {
+  if (counter)
+    counter->m_value.fetch_add(1, std::memory_order_relaxed);
+
+  if (m_backgroundThreads.empty()) {
+    execute(new Task{std::move(job), counter});
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_backgroundMutex);
+    m_backgroundQueue.push_back(new Task{std::move(job), counter});
+  }
+  m_backgroundWake.notify_one();
+}
+
+void JobSystem::runOnMainThread(Job job) {
+  std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+  m_mainThreadJobs.push_back(std::move(job));
+}
+
+void JobSystem::executeMainThreadJobs(float budgetMs) {
+  const auto start = std::chrono::steady_clock::now();
+  do {
+    Job job;
+    {
+      std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+      if (m_mainThreadJobs.empty())
+        return;
+      job = std::move(m_mainThreadJobs.front());
+      m_mainThreadJobs.pop_front();
+    }
+    job();
+  } while (std::chrono::duration<float, std::milli>(
+               std::chrono::steady_clock::now() - start)
+               .count() < budgetMs);
+}
+
+void JobSystem::wait(JobCounter &counter) {
+  while (!counter.isDone()) {
+    if (!runOne())
+      std::this_thread::yield();
+  }
+}
+
+void JobSystem::parallelFor(size_t count, const RangeJob &job,
+                            size_t minChunk) {
+  if (count == 0)
+    return;
+
+  const size_t threads = m_workers.size() + 1;
+  minChunk = std::max<size_t>(1, minChunk);
+  if (threads == 1 || count <= minChunk) {
+    job(0, count);
+    return;
+  }
+
+  // A few chunks per thread so stealing can even out uneven costs.
+  const size_t chunk =
+      std::max(minChunk, (count + threads * 4 - 1) / (threads * 4));
+  const size_t chunkCount = (count + chunk - 1) / chunk;
+
+  // Chunks are claimed from a shared cursor rather than queued one by one,
+  // so this thread never takes a job that is not part of this loop. Helpers
+  // that only get to run after the loop is over find nothing left to claim,
+  // and never touch `job`.
+  struct Loop {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+  };
+  auto loop = std::make_shared<Loop>();
+  auto runChunks = [loop, &job, count, chunk, chunkCount]() {
+    size_t c;
+    while ((c = loop->next.fetch_add(1, std::memory_order_relaxed)) <
+           chunkCount) {
+      job(c * chunk, std::min(count, (c + 1) * chunk));
+      loop->done.fetch_add(1, std::memory_order_release);
+    }
+  };
+
+  const size_t helpers = std::min(m_workers.size(), chunkCount - 1);
+  for (size_t i = 0; i < helpers; i++)
+    run(runChunks);
+
+  runChunks();
+  // Only chunks other threads are already running are left.
+  while (loop->done.load(std::memory_order_acquire) < chunkCount)
+    std::this_thread::yield();
+}
+
+int JobSystem::getCurrentWorkerIndex() { return t_workerIndex; }
+
+void JobSystem::setCurrentThreadName(const std::string &name) {
+#ifdef __linux__
+  // Linux limits thread names to 15 characters plus the terminator.
+  pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#else
+  (void)name;
+#endif
+}
+
+bool JobSystem::setCurrentThreadAffinity(unsigned int core) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)core;
+  return false;
+#endif
+}
+
+void JobSystem::push(Task *task) {
+  m_queuedTasks.fetch_add(1, std::memory_order_relaxed);
+
+  int index = t_workerIndex;
+  if (index < 0 || !m_workers[index]->push(task)) {
+    std::lock_guard<std::mutex> lock(m_globalMutex);
+    m_globalQueue.push_back(task);
+  }
+
+  {
+    // Taking the lock orders this wake-up after a sleeper's predicate check.
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+  }
+  m_wake.notify_one();
+}
+
+JobSystem::Task *JobSystem::take(int workerIndex) {
+  Task *task = nullptr;
+
+  if (workerIndex >= 0)
+    task = m_workers[workerIndex]->pop();
+
+  if (!task) {
+    std::lock_guard<std::mutex> lock(m_globalMutex);
+    if (!m_globalQueue.empty()) {
+      task = m_globalQueue.back();
+      m_globalQueue.pop_back();
+    }
+  }
+
+  if (!task && !m_workers.empty()) {
+    // Start at a different victim per thread so thieves do not all hammer
+    // the same deque.
+    const size_t count = m_workers.size();
+    const size_t start = static_cast<size_t>(workerIndex + 1) % count;
+    for (size_t i = 0; i < count && !task; i++) {
+      size_t victim = (start + i) % count;
+      if (static_cast<int>(victim) != workerIndex)
+        task = m_workers[victim]->steal();
+    }
+  }
+
+  if (task)
+    m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+  return task;
+}
+
+bool JobSystem::runOne() {
+  Task *task = take(t_workerIndex);
+  if (!task)
+    return false;
+  execute(task);
+  return true;
+}
+
+void JobSystem::execute(Task *task) {
+  task->job();
+  if (task->counter)
+    task->counter->m_value.fetch_sub(1, std::memory_order_release);
+  delete task;
+}
+
+void JobSystem::backgroundLoop(unsigned int index) {
+  setCurrentThreadName("Background " + std::to_string(index));
+
+  while (true) {
+    Task *task;
+    {
+      std::unique_lock<std::mutex> lock(m_backgroundMutex);
+      m_backgroundWake.wait(lock, [this]() {
+        return m_backgroundStopping || !m_backgroundQueue.empty();
+      });
+      // Whatever was queued still runs, so counters never hang.
+      if (m_backgroundQueue.empty())
+        return;
+      task = m_backgroundQueue.front();
+      m_backgroundQueue.pop_front();
+    }
+    execute(task);
+  }
+}
+
+void JobSystem::workerLoop(unsigned int index,
+                           const ThreadStartHook &onThreadStart) {
+  t_workerIndex = static_cast<int>(index);
+
+  if (onThreadStart)
+    onThreadStart(index);
+  else
+    setCurrentThreadName("Worker " + std::to_string(index));
+
+  while (true) {
+    if (runOne())
+      continue;
+
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_wake.wait(lock, [this]() {
+      return m_stopping.load() || m_queuedTasks.load() > 0;
+    });
+    if (m_stopping)
+      return;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Number of jobs still outstanding. A job scheduled against a counter keeps
+// it non-zero until it returns; jobs may schedule children against the same
+// (or their own) counter, and waiting on it waits for the whole tree.
+class JobCounter {
+public:
+  bool isDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+
+private:
+  friend class JobSystem;
+  std::atomic<int> m_value{0};
+};
+
+// Work-stealing scheduler. Each worker owns a Chase-Lev deque it pushes to
+// and pops from at the bottom; idle workers steal from the top of others.
+// Threads that are not workers (the main thread, for instance) submit
+// through a shared queue. Work that runs for seconds (a whole model import)
+// goes to a separate background lane instead, so no waiting thread can ever
+// pick it up and stall on it.
+class JobSystem {
+public:
+  using Job = std::function<void()>;
+  using RangeJob = std::function<void(size_t begin, size_t end)>;
+  // Runs on each worker before it takes jobs; defaults to naming the thread.
+  using ThreadStartHook = std::function<void(unsigned int workerIndex)>;
+
+  static JobSystem &get() {
+    static JobSystem instance;
+    return instance;
+  }
+
+  // 0 workers means one per hardware thread, minus the main thread.
+  void init(unsigned int workerCount = 0,
+            ThreadStartHook onThreadStart = nullptr);
+  void shutdown();
+
+  // For short jobs: whoever waits may end up running them inline.
+  void run(Job job, JobCounter *counter = nullptr);
+  // For long-running jobs, on threads outside the worker pool. They may use
+  // parallelFor() and run() like any other thread.
+  void runBackground(Job job, JobCounter *counter = nullptr);
+
+  // GL work produced by jobs: queued from any thread, executed in order by
+  // executeMainThreadJobs() on the thread that owns the context, once per
+  // frame. Jobs left over when the budget runs out wait for the next frame;
+  // at least one runs per call.
+  void runOnMainThread(Job job);
+  void executeMainThreadJobs(float budgetMs = 4.0f);
+
+  // Executes other jobs on the calling thread until the counter drains.
+  void wait(JobCounter &counter);
+
+  // Splits [0, count) into chunks of at least `minChunk` and blocks until
+  // all have run. Small ranges (or no workers) run inline. The caller only
+  // ever runs chunks of this loop, so the wait is bounded by the loop itself.
+  void parallelFor(size_t count, const RangeJob &job, size_t minChunk = 1);
+
+  unsigned int getWorkerCount() const {
+    return static_cast<unsigned int>(m_workers.size());
+  }
+  // Index of the calling worker, or -1 on any other thread.
+  static int getCurrentWorkerIndex();
+
+  static void setCurrentThreadName(const std::string &name);
+  static bool setCurrentThreadAffinity(unsigned int core);
+
+private:
+  static constexpr unsigned int BACKGROUND_THREADS = 2;
+
+  JobSystem();
+  ~JobSystem();
+
+  struct Task;
+  struct Worker;
+
+  bool m_initialized = false;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+
+  std::mutex m_globalMutex;
+  std::vector<Task *> m_globalQueue;
+
+  std::mutex m_sleepMutex;
+  std::condition_variable m_wake;
+  std::atomic<int> m_queuedTasks{0};
+  std::atomic<bool> m_stopping{false};
+
+  std::vector<std::thread> m_backgroundThreads;
+  std::mutex m_backgroundMutex;
+  std::condition_variable m_backgroundWake;
+  std::deque<Task *> m_backgroundQueue;
+  bool m_backgroundStopping = false;
+
+  std::mutex m_mainThreadMutex;
+  std::deque<Job> m_mainThreadJobs;
+
+  void push(Task *task);
+  Task *take(int workerIndex);
+  bool runOne();
+  void execute(Task *task);
+  void workerLoop(unsigned int index, const ThreadStartHook &onThreadStart);
+  void backgroundLoop(unsigned int index);
+};
\ No newline at end of file
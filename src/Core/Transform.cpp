@@ -4,7 +4,7 @@
 
 Transform::Transform()
     : m_position(0.0f), m_rotation(0.0f), m_scale(1.0f), m_dirty(true),
-      m_cachedMatrix(1.0f) {}
+      m_cachedMatrix(1.0f), m_cachedNormalMatrix(1.0f) {}
 
 const glm::vec3 &Transform::getPosition() const { return m_position; }
 const glm::vec3 &Transform::getRotation() const { return m_rotation; }
@@ -37,7 +37,13 @@ const glm::mat4 &Transform::getModelMatrix() const {
     model = glm::scale(model, m_scale);
 
     m_cachedMatrix = model;
+    m_cachedNormalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
     m_dirty = false;
   }
   return m_cachedMatrix;
+}
+
+const glm::mat3 &Transform::getNormalMatrix() const {
+  getModelMatrix();
+  return m_cachedNormalMatrix;
 }
\ No newline at end of file
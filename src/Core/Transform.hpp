@@ -15,6 +15,8 @@ public:
   void setScale(const glm::vec3 &scale);
 
   const glm::mat4 &getModelMatrix() const;
+  // Inverse-transpose of the model's upper 3x3, cached alongside it.
+  const glm::mat3 &getNormalMatrix() const;
 
 private:
   glm::vec3 m_position;
@@ -23,4 +25,5 @@ private:
 
   mutable bool m_dirty;
   mutable glm::mat4 m_cachedMatrix;
+  mutable glm::mat3 m_cachedNormalMatrix;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Core/Window.hpp"
 #include "Core/Event.hpp"
 #include "Core/Log.hpp"
+#include "Graphics/GLCapabilities.hpp"
 
 #include <glad/glad.h>
 
@@ -56,6 +57,20 @@ Window::Window(const WindowConfig &config) {
   LOG_CORE_INFO("  Renderer: {0}", (const char *)glGetString(GL_RENDERER));
   LOG_CORE_INFO("  Version: {0}", (const char *)glGetString(GL_VERSION));
 
+  GLCapabilities::init((GLCapabilities::LoadProc)glfwGetProcAddress);
+
+  int swapInterval = 0;
+  if (config.VSync == VSyncMode::On) {
+    swapInterval = 1;
+  } else if (config.VSync == VSyncMode::Adaptive) {
+    bool tear = glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                glfwExtensionSupported("GLX_EXT_swap_control_tear");
+    swapInterval = tear ? -1 : 1;
+    if (!tear)
+      LOG_CORE_WARN("Adaptive VSync not supported, using regular VSync");
+  }
+  glfwSwapInterval(swapInterval);
+
 #ifdef DEBUG
   int flags;
   glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
@@ -77,14 +92,12 @@ Window::Window(const WindowConfig &config) {
         data.Width = width;
         data.Height = height;
 
-        WindowResizeEvent event(width, height);
-        data.EventCallback(event);
+        data.Events.push<WindowResizeEvent>(width, height);
       });
 
   glfwSetWindowCloseCallback(m_nativeHandle, [](GLFWwindow *window) {
     WindowData &data = *(WindowData *)glfwGetWindowUserPointer(window);
-    WindowCloseEvent event;
-    data.EventCallback(event);
+    data.Events.push<WindowCloseEvent>();
   });
 
   glfwSetKeyCallback(m_nativeHandle, [](GLFWwindow *window, int key,
@@ -93,18 +106,15 @@ Window::Window(const WindowConfig &config) {
 
     switch (action) {
     case GLFW_PRESS: {
-      KeyPressedEvent event((KeyCode)key, false);
-      data.EventCallback(event);
+      data.Events.push<KeyPressedEvent>((KeyCode)key, false);
       break;
     }
     case GLFW_RELEASE: {
-      KeyReleasedEvent event((KeyCode)key);
-      data.EventCallback(event);
+      data.Events.push<KeyReleasedEvent>((KeyCode)key);
       break;
     }
     case GLFW_REPEAT: {
-      KeyPressedEvent event((KeyCode)key, true);
-      data.EventCallback(event);
+      data.Events.push<KeyPressedEvent>((KeyCode)key, true);
       break;
     }
     }
@@ -114,8 +124,7 @@ Window::Window(const WindowConfig &config) {
       m_nativeHandle, [](GLFWwindow *window, unsigned int keycode) {
         WindowData &data = *(WindowData *)glfwGetWindowUserPointer(window);
 
-        KeyTypedEvent event((KeyCode)keycode);
-        data.EventCallback(event);
+        data.Events.push<KeyTypedEvent>((KeyCode)keycode);
       });
 
   glfwSetMouseButtonCallback(
@@ -124,13 +133,11 @@ Window::Window(const WindowConfig &config) {
 
         switch (action) {
         case GLFW_PRESS: {
-          MouseButtonPressedEvent event((MouseCode)button);
-          data.EventCallback(event);
+          data.Events.push<MouseButtonPressedEvent>((MouseCode)button);
           break;
         }
         case GLFW_RELEASE: {
-          MouseButtonReleasedEvent event((MouseCode)button);
-          data.EventCallback(event);
+          data.Events.push<MouseButtonReleasedEvent>((MouseCode)button);
           break;
         }
         }
@@ -139,15 +146,13 @@ Window::Window(const WindowConfig &config) {
   glfwSetScrollCallback(
       m_nativeHandle, [](GLFWwindow *window, double xOffset, double yOffset) {
         WindowData &data = *(WindowData *)glfwGetWindowUserPointer(window);
-        MouseScrolledEvent event((float)xOffset, (float)yOffset);
-        data.EventCallback(event);
+        data.Events.push<MouseScrolledEvent>((float)xOffset, (float)yOffset);
       });
 
   glfwSetCursorPosCallback(
       m_nativeHandle, [](GLFWwindow *window, double xPos, double yPos) {
         WindowData &data = *(WindowData *)glfwGetWindowUserPointer(window);
-        MouseMovedEvent event((float)xPos, (float)yPos);
-        data.EventCallback(event);
+        data.Events.push<MouseMovedEvent>((float)xPos, (float)yPos);
       });
 }
 
@@ -164,7 +169,11 @@ void Window::init() {
 #endif
 }
 
-void Window::onUpdate() {
-  glfwSwapBuffers(m_nativeHandle);
-  glfwPollEvents();
-};
\ No newline at end of file
+void Window::swapBuffers() { glfwSwapBuffers(m_nativeHandle); }
+
+void Window::pollEvents() { glfwPollEvents(); }
+
+bool Window::isActive() {
+  return glfwGetWindowAttrib(m_nativeHandle, GLFW_FOCUSED) &&
+         !glfwGetWindowAttrib(m_nativeHandle, GLFW_ICONIFIED);
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Config.hpp"
 #include "Core/Event.hpp"
+#include "Core/EventQueue.hpp"
 
 #include <functional>
 #include <string>
@@ -16,15 +17,21 @@ public:
   ~Window();
 
   static void init();
-  void onUpdate();
+  void swapBuffers();
+  void pollEvents();
 
+  // GLFW callbacks only queue events; they reach the callback when
+  // dispatchEvents() runs.
   void setEventCallback(const EventCallbackFn &callback) {
-    m_data.EventCallback = callback;
+    m_data.Events.setHandler(callback);
   }
+  void dispatchEvents() { m_data.Events.dispatch(); }
 
   [[nodiscard]] GLFWwindow *getHandle() { return m_nativeHandle; }
   [[nodiscard]] unsigned int getWidth() { return m_data.Width; }
   [[nodiscard]] unsigned int getHeight() { return m_data.Height; }
+  // False while unfocused or minimized.
+  [[nodiscard]] bool isActive();
 
 private:
   GLFWwindow *m_nativeHandle;
@@ -32,7 +39,7 @@ private:
   struct WindowData {
     std::string Title;
     unsigned int Width, Height;
-    EventCallbackFn EventCallback;
+    EventQueue Events;
   };
 
   WindowData m_data;
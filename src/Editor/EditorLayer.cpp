@@ -4,30 +4,59 @@
 #include "Core/Input.hpp"
 #include "Core/KeyCodes.hpp"
 #include "Core/Log.hpp"
-#include "Scene/Model.hpp"
-
+#include "Graphics/MaterialTable.hpp"
+#include "Graphics/ShaderCache.hpp"
+#include "Graphics/TextureStreamer.hpp"
+#include "Scene/SceneSnapshot.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 #include <imgui.h>
+#include <random>
 
 EditorLayer::EditorLayer(const Config &config, const std::string &modelPath,
                          InputManager &inputManager)
-    : m_config(config), m_modelPath(modelPath), m_inputManager(inputManager) {}
+    : m_config(config), m_modelPath(modelPath), m_inputManager(inputManager),
+      m_resourceManager(config.texture), m_modelLoader(m_resourceManager) {}
 
 void EditorLayer::onAttach() {
   m_renderer.init();
   m_renderer.setClearColor(m_config.render.ClearColor);
 
+  ShaderCache::init(m_config.render.ShaderCache,
+                    m_config.render.ShaderCacheDirectory);
+  MaterialTable::get().init(m_config.render.TextureBinding);
+  m_resourceManager.setShaderHotReload(m_config.render.ShaderHotReload);
+  m_resourceManager.setImportConfig(m_config.import);
+
+  // Array layers share one allocation per shape, so individual textures
+  // cannot change their resident mips.
+  if (MaterialTable::get().getMode() == TextureBindingMode::Arrays &&
+      m_config.texture.Streaming) {
+    LOG_CORE_INFO("Texture streaming disabled: not supported with texture "
+                  "arrays");
+    m_config.texture.Streaming = false;
+    m_resourceManager.setTextureConfig(m_config.texture);
+  }
+
+  if (m_config.texture.Streaming)
+    TextureStreamer::get().init(m_config.texture);
+
   m_scene = std::make_unique<Scene>(m_config.camera, m_config.render);
+  std::snprintf(m_snapshotPathBuffer, sizeof(m_snapshotPathBuffer), "%s",
+                m_config.paths.SceneSnapshot.c_str());
 
   m_scene->getCamera().setAspectRatio((float)m_config.window.Width,
                                       (float)m_config.window.Height);
 
   auto shader = m_resourceManager.loadShader(
-      "default", m_config.paths.ShaderVert, m_config.paths.ShaderFrag);
-  Model myModel(m_modelPath, m_resourceManager, shader);
-  myModel.addToScene(*m_scene);
+      "default", m_config.paths.ShaderVert, m_config.paths.ShaderFrag,
+      MaterialTable::get().getShaderDefines());
+  m_modelLoader.load(m_modelPath, *m_scene, shader);
 
   std::vector<Vertex> vertices = {
       {{-1.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}}, // Bottom-Left
@@ -44,11 +73,36 @@ void EditorLayer::onAttach() {
   m_planeMaterial->setVec4("u_Color", glm::vec4(0.8f, 0.8f, 0.8f, 0.1f));
   m_planeMaterial->setTransparent(true);
 
+  m_renderer.setDepthShaders(
+      m_resourceManager.loadShader("depth", m_config.paths.DepthShaderVert,
+                                   m_config.paths.DepthShaderFrag),
+      m_resourceManager.loadShader("overdraw", m_config.paths.DepthShaderVert,
+                                   m_config.paths.OverdrawShaderFrag));
+  m_renderer.setDepthPrePass(m_config.render.DepthPrePass,
+                             m_config.render.DepthPrePassOverdraw);
+  m_renderer.setShadowShader(
+      m_resourceManager.loadShader("shadow", m_config.paths.ShadowShaderVert,
+                                   m_config.paths.ShadowShaderFrag));
+  m_renderer.setShadows(m_config.render.Shadows,
+                        m_config.render.ShadowMapSize,
+                        m_config.render.ShadowFarPlane);
+  m_renderer.setOcclusionCulling(m_config.render.OcclusionCulling);
+  m_renderer.setLateLatch(m_config.camera.LateLatch);
+  m_renderer.setGPUCullingShaders(
+      std::make_shared<Shader>(m_config.paths.CullShaderComp),
+      std::make_shared<Shader>(m_config.paths.HiZShaderComp));
+  m_renderer.setGPUCulling(m_config.render.GPUCulling);
+  m_renderer.setMeshletCulling(m_config.render.MeshletCulling);
+  m_renderer.setBackfaceCulling(m_config.render.BackfaceCulling);
+
   LOG_CORE_INFO("Editor Layer Attached");
 }
 
 void EditorLayer::onDetach() {
   // Resource cleanup handled by destructors
+  if (m_occlusionTexture)
+    glDeleteTextures(1, &m_occlusionTexture);
+  MaterialTable::get().shutdown();
 }
 
 void EditorLayer::onUpdate(float dt) {
@@ -66,6 +120,8 @@ void EditorLayer::onUpdate(float dt) {
     LOG_INFO("Reloading Shaders...");
     m_resourceManager.reloadAllShaders();
   }
+  m_resourceManager.update();
+  m_modelLoader.update();
 
   if (m_viewportFocused) {
     glm::vec2 delta = Input::getMouseDelta();
@@ -96,6 +152,16 @@ void EditorLayer::onUpdate(float dt) {
     m_renderer.submit(m_planeMesh, m_planeMaterial, model);
   }
 
+  // Culling and queue building took a while; pick up any mouse movement
+  // since the top of the frame before the draws go out.
+  if (m_viewportFocused && m_config.camera.LateLatch) {
+    glm::vec2 lateDelta = Input::sampleMouseDelta();
+    if (lateDelta != glm::vec2(0.0f)) {
+      m_scene->onMouseView(lateDelta.x, lateDelta.y);
+      m_renderer.updateCamera(m_scene->getCamera());
+    }
+  }
+
   m_renderer.endScene();
 }
 
@@ -108,9 +174,238 @@ void EditorLayer::onImGuiRender() {
   if (ImGui::CollapsingHeader("Scene", ImGuiTreeNodeFlags_DefaultOpen)) {
     ImGui::DragFloat3("Light Position", &m_scene->getLightPos().x, 0.1f);
 
+    bool shadows = m_renderer.areShadowsEnabled();
+    if (ImGui::Checkbox("Shadows", &shadows)) {
+      m_config.render.Shadows = shadows;
+      m_renderer.setShadows(shadows, m_config.render.ShadowMapSize,
+                            m_config.render.ShadowFarPlane);
+    }
+    if (shadows) {
+      const ShadowMap &shadowMap = m_renderer.getShadowMap();
+      ImGui::SameLine();
+      ImGui::Text("(%d static, %d dynamic faces redrawn)",
+                  shadowMap.getStaticFacesDrawn(),
+                  shadowMap.getDynamicFacesDrawn());
+    }
+
     if (ImGui::ColorEdit3("Clear Color", &m_config.render.ClearColor.x)) {
       m_renderer.setClearColor(m_config.render.ClearColor);
     }
+
+    const char *prePassModes[] = {"Off", "On", "Auto"};
+    int prePassMode = static_cast<int>(m_renderer.getDepthPrePassMode());
+    if (ImGui::Combo("Depth Pre-Pass", &prePassMode, prePassModes, 3)) {
+      m_config.render.DepthPrePass =
+          static_cast<DepthPrePassMode>(prePassMode);
+      m_renderer.setDepthPrePass(m_config.render.DepthPrePass,
+                                 m_config.render.DepthPrePassOverdraw);
+    }
+    ImGui::Text("Estimated overdraw: %.2fx (pre-pass %s)",
+                m_renderer.getEstimatedOverdraw(),
+                m_renderer.isDepthPrePassActive() ? "on" : "off");
+    bool showOverdraw = m_renderer.isShowingOverdraw();
+    if (ImGui::Checkbox("Show Overdraw", &showOverdraw))
+      m_renderer.setShowOverdraw(showOverdraw);
+
+    ImGui::InputText("Snapshot", m_snapshotPathBuffer,
+                     sizeof(m_snapshotPathBuffer));
+    if (ImGui::Button("Save"))
+      SceneSnapshot::save(m_snapshotPathBuffer, *m_scene);
+    ImGui::SameLine();
+    if (ImGui::Button("Restore")) {
+      // Parts still streaming in would land on top of the restored scene.
+      for (const auto &load : m_modelLoader.getActiveLoads())
+        load->cancel();
+      SceneSnapshot::load(m_snapshotPathBuffer, *m_scene, m_resourceManager,
+                          m_resourceManager.getShader("default"));
+    }
+  }
+
+  if (ImGui::CollapsingHeader("Lights")) {
+    auto &lights = m_scene->getPointLights();
+    const LightClusters &clusters = m_renderer.getLightClusters();
+    ImGui::Text("%zu point lights, binned in %.2f ms", lights.size(),
+                clusters.getMilliseconds());
+    ImGui::Text("%zu cluster entries, at most %u in one cluster",
+                clusters.getIndexCount(), clusters.getMaxLightsPerCluster());
+
+    if (ImGui::Button("Add Light")) {
+      PointLight light;
+      light.position = m_scene->getCamera().getPosition();
+      lights.push_back(light);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear Lights"))
+      lights.clear();
+
+    ImGui::SliderInt("##ScatterCount", &m_scatterLightCount, 1, 1024);
+    ImGui::SameLine();
+    if (ImGui::Button("Scatter"))
+      scatterLights(m_scatterLightCount);
+
+    for (size_t i = 0; i < lights.size(); i++) {
+      ImGui::PushID(static_cast<int>(i));
+      if (ImGui::TreeNode("Light", "Light %zu", i)) {
+        ImGui::DragFloat3("Position", &lights[i].position.x, 0.1f);
+        ImGui::ColorEdit3("Color", &lights[i].color.x);
+        ImGui::DragFloat("Radius", &lights[i].radius, 0.05f, 0.1f, 100.0f);
+        ImGui::DragFloat("Intensity", &lights[i].intensity, 0.05f, 0.0f,
+                         100.0f);
+        bool remove = ImGui::Button("Remove");
+        ImGui::TreePop();
+        if (remove) {
+          lights.erase(lights.begin() + i);
+          ImGui::PopID();
+          break;
+        }
+      }
+      ImGui::PopID();
+    }
+  }
+
+  if (ImGui::CollapsingHeader("Occlusion Culling")) {
+    bool enabled = m_renderer.isOcclusionCullingEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled)) {
+      m_config.render.OcclusionCulling = enabled;
+      m_renderer.setOcclusionCulling(enabled);
+    }
+    if (enabled && m_renderer.isLateLatchEnabled() &&
+        !m_renderer.isGPUCullingActive())
+      ImGui::TextDisabled("Paused: \"LateLatch\" is on");
+    const OcclusionStats &stats = m_renderer.getOcclusionStats();
+    ImGui::Text("%zu occluders, %zu triangles (%s)", stats.occluders,
+                stats.triangles,
+                m_renderer.getOcclusionCuller().isUsingAVX2() ? "AVX2"
+                                                              : "scalar");
+    ImGui::Text("Culled %zu entities in %.2f ms", stats.culled,
+                stats.milliseconds);
+    ImGui::Checkbox("Show Buffer", &m_showOcclusionBuffer);
+    if (m_showOcclusionBuffer)
+      drawOcclusionBuffer();
+
+    ImGui::Separator();
+    bool gpuCulling = m_renderer.isGPUCullingEnabled();
+    if (ImGui::Checkbox("GPU-Driven", &gpuCulling)) {
+      m_config.render.GPUCulling = gpuCulling;
+      m_renderer.setGPUCulling(gpuCulling);
+    }
+    if (m_renderer.isGPUCullingActive()) {
+      GPUCuller &gpuCuller = m_renderer.getGPUCuller();
+      bool hiZ = gpuCuller.isHiZEnabled();
+      if (ImGui::Checkbox("Depth Pyramid", &hiZ))
+        gpuCuller.setHiZEnabled(hiZ);
+      ImGui::Text("%zu objects in %zu indirect draws",
+                  gpuCuller.getObjectCount(),
+                  m_renderer.getGPUBatchCount());
+    } else if (gpuCulling) {
+      ImGui::TextDisabled("Unavailable (needs table-driven materials and "
+                          "indirect draw counts)");
+    }
+
+    ImGui::Separator();
+    bool meshletCulling = m_renderer.isMeshletCullingEnabled();
+    if (ImGui::Checkbox("Meshlets", &meshletCulling)) {
+      m_config.render.MeshletCulling = meshletCulling;
+      m_renderer.setMeshletCulling(meshletCulling);
+    }
+    bool backfaceCulling = m_renderer.isBackfaceCullingEnabled();
+    if (ImGui::Checkbox("Backface Culling", &backfaceCulling)) {
+      m_config.render.BackfaceCulling = backfaceCulling;
+      m_renderer.setBackfaceCulling(backfaceCulling);
+    }
+    const MeshletCuller &meshletCuller = m_renderer.getMeshletCuller();
+    if (meshletCulling && meshletCuller.getMeshletCount() > 0)
+      ImGui::Text("%zu / %zu meshlets in %zu draws (%.2f ms)",
+                  meshletCuller.getVisibleCount(),
+                  meshletCuller.getMeshletCount(),
+                  meshletCuller.getCommandCount(),
+                  meshletCuller.getMilliseconds());
+  }
+
+  if (ImGui::CollapsingHeader("Models", ImGuiTreeNodeFlags_DefaultOpen)) {
+    ImGui::InputText("Path", m_loadPathBuffer, sizeof(m_loadPathBuffer));
+    ImGui::SameLine();
+    if (ImGui::Button("Load") && m_loadPathBuffer[0] != '\0') {
+      m_modelLoader.load(m_loadPathBuffer, *m_scene,
+                         m_resourceManager.getShader("default"));
+    }
+
+    const char *presets[] = {"Fast", "Balanced", "Max Quality"};
+    int preset = static_cast<int>(m_config.import.Preset);
+    if (ImGui::Combo("Import Preset", &preset, presets, 3)) {
+      m_config.import.Preset = static_cast<ImportPreset>(preset);
+      m_resourceManager.setImportConfig(m_config.import);
+    }
+    if (ImGui::Checkbox("Split for 16-bit indices",
+                        &m_config.import.Split16BitMeshes))
+      m_resourceManager.setImportConfig(m_config.import);
+    if (ImGui::IsItemHovered())
+      ImGui::SetTooltip("Applies to models loaded from now on; snapshots "
+                        "keep the setting each model was loaded with.");
+    if (ImGui::Checkbox("Build meshlets", &m_config.import.Meshlets))
+      m_resourceManager.setImportConfig(m_config.import);
+
+    const ImportReport &report = m_modelLoader.getLastReport();
+    if (!report.getStages().empty() &&
+        ImGui::TreeNode("Last Import", "Last import: %s (%.1f ms)",
+                        m_modelLoader.getLastReportPath().c_str(),
+                        report.getMilliseconds())) {
+      for (const ImportStage &stage : report.getStages())
+        ImGui::Text("%s: %.2f ms, %zu -> %zu vertices", stage.name.c_str(),
+                    stage.milliseconds, stage.before.vertices,
+                    stage.after.vertices);
+      const GeometryCount &result = report.getStages().back().after;
+      ImGui::Text("Result: %zu meshes, %zu triangles, %.2f MB", result.meshes,
+                  result.indices / 3, result.getBytes() / 1048576.0f);
+      ImGui::TreePop();
+    }
+
+    for (const auto &load : m_modelLoader.getActiveLoads()) {
+      ImGui::PushID(load.get());
+      ImGui::Text("%s", load->getPath().c_str());
+      ImGui::ProgressBar(load->getProgress());
+      ImGui::SameLine();
+      if (!load->isCancelled() && ImGui::Button("Cancel"))
+        load->cancel();
+      ImGui::PopID();
+    }
+
+    const auto &models = m_scene->getModels();
+    if (m_selectedModel >= static_cast<int>(models.size()))
+      m_selectedModel = -1;
+    if (!models.empty()) {
+      ImGui::Separator();
+      const char *selected =
+          m_selectedModel >= 0 ? models[m_selectedModel].path.c_str() : "None";
+      if (ImGui::BeginCombo("Scene Model", selected)) {
+        for (int i = 0; i < static_cast<int>(models.size()); i++) {
+          ImGui::PushID(i);
+          if (ImGui::Selectable(models[i].path.c_str(), i == m_selectedModel))
+            m_selectedModel = i;
+          ImGui::PopID();
+        }
+        ImGui::EndCombo();
+      }
+      if (m_selectedModel >= 0) {
+        bool dynamic = m_scene->isModelDynamic(m_selectedModel);
+        if (ImGui::Checkbox("Dynamic", &dynamic))
+          m_scene->setModelDynamic(m_selectedModel, dynamic);
+        if (ImGui::IsItemHovered())
+          ImGui::SetTooltip("Drawn into the shadow map every frame over the "
+                            "cached faces, for models that keep moving.");
+      }
+    }
+  }
+
+  if (m_config.texture.Streaming &&
+      ImGui::CollapsingHeader("Texture Streaming")) {
+    const auto &stats = TextureStreamer::get().getStats();
+    ImGui::Text("Resident: %.1f / %.1f MB", stats.residentBytes / 1048576.0f,
+                stats.budgetBytes / 1048576.0f);
+    ImGui::Text("Visible: %u / %u textures", stats.visibleCount,
+                stats.textureCount);
+    ImGui::Text("Pending: %u (uploaded %.1f MB this frame)",
+                stats.pendingCount, stats.uploadedBytes / 1048576.0f);
   }
 
   if (ImGui::CollapsingHeader("Clipping Planes",
@@ -177,4 +472,81 @@ bool EditorLayer::onMouseButtonPressed(MouseButtonPressedEvent &e) {
     }
   }
   return false;
+}
+
+void EditorLayer::drawOcclusionBuffer() {
+  constexpr int width = OcclusionCuller::WIDTH;
+  constexpr int height = OcclusionCuller::HEIGHT;
+  const std::vector<float> &depth = m_renderer.getOcclusionCuller().getDepth();
+
+  // Raw depth bunches up near 1, so stretch the covered range: near is
+  // bright, far is dim and empty pixels stay black.
+  float nearest = 1.0f, farthest = 0.0f;
+  for (float d : depth) {
+    if (d < 1.0f) {
+      nearest = std::min(nearest, d);
+      farthest = std::max(farthest, d);
+    }
+  }
+  const float range = std::max(farthest - nearest, 1e-6f);
+  m_occlusionPixels.resize(depth.size());
+  for (size_t i = 0; i < depth.size(); i++) {
+    m_occlusionPixels[i] =
+        depth[i] < 1.0f ? static_cast<unsigned char>(
+                              255.0f - 191.0f * (depth[i] - nearest) / range)
+                        : 0;
+  }
+
+  if (!m_occlusionTexture) {
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_occlusionTexture);
+    glTextureStorage2D(m_occlusionTexture, 1, GL_R8, width, height);
+    glTextureParameteri(m_occlusionTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_occlusionTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    const GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+    glTextureParameteriv(m_occlusionTexture, GL_TEXTURE_SWIZZLE_RGBA,
+                         swizzle);
+  }
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTextureSubImage2D(m_occlusionTexture, 0, 0, 0, width, height, GL_RED,
+                      GL_UNSIGNED_BYTE, m_occlusionPixels.data());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  // Row 0 of the buffer is the bottom of the screen.
+  ImGui::Image((ImTextureID)(intptr_t)m_occlusionTexture,
+               ImVec2(width * 2.0f, height * 2.0f), ImVec2(0.0f, 1.0f),
+               ImVec2(1.0f, 0.0f));
+}
+
+void EditorLayer::scatterLights(int count) {
+  BoundingBox bounds;
+  bool empty = true;
+  for (const Entity &entity : m_scene->getEntities()) {
+    if (!entity.mesh)
+      continue;
+    BoundingBox box =
+        entity.mesh->getBounds().transformed(entity.transform.getModelMatrix());
+    bounds.min = empty ? box.min : glm::min(bounds.min, box.min);
+    bounds.max = empty ? box.max : glm::max(bounds.max, box.max);
+    empty = false;
+  }
+  if (empty) {
+    bounds.min = glm::vec3(-5.0f);
+    bounds.max = glm::vec3(5.0f);
+  }
+
+  std::mt19937 rng(std::random_device{}());
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  // Radii scale with the scene so a few dozen lights cover it sparsely.
+  const float size = glm::length(bounds.max - bounds.min);
+
+  auto &lights = m_scene->getPointLights();
+  for (int i = 0; i < count; i++) {
+    PointLight light;
+    glm::vec3 t(unit(rng), unit(rng), unit(rng));
+    light.position = bounds.min + (bounds.max - bounds.min) * t;
+    light.radius = size * (0.05f + 0.1f * unit(rng));
+    light.color = glm::vec3(unit(rng), unit(rng), unit(rng)) * 0.8f + 0.2f;
+    light.intensity = 1.0f + 3.0f * unit(rng);
+    lights.push_back(light);
+  }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Core/Layer.hpp"
 #include "Graphics/Renderer.hpp"
 #include "Graphics/ResourceManager.hpp"
+#include "Scene/ModelLoader.hpp"
 #include "Scene/Scene.hpp"
 
 class EditorLayer : public Layer {
@@ -27,12 +28,28 @@ private:
   InputManager &m_inputManager;
   Renderer m_renderer;
   std::unique_ptr<Scene> m_scene;
+  // Declared after the scene so in-flight loads stop before it goes away.
+  ModelLoader m_modelLoader;
 
   std::shared_ptr<Mesh> m_planeMesh;
   std::shared_ptr<Material> m_planeMaterial;
 
   std::string m_modelPath;
+  char m_loadPathBuffer[256] = {};
+  char m_snapshotPathBuffer[256] = {};
+  // Index into Scene::getModels(), or -1.
+  int m_selectedModel = -1;
   bool m_viewportFocused = false;
 
+  int m_scatterLightCount = 64;
+
+  bool m_showOcclusionBuffer = false;
+  unsigned int m_occlusionTexture = 0;
+  std::vector<unsigned char> m_occlusionPixels;
+
   bool onMouseButtonPressed(MouseButtonPressedEvent &e);
+  void drawOcclusionBuffer();
+  // Adds `count` randomly placed and coloured point lights within the
+  // bounds of the scene's entities.
+  void scatterLights(int count);
 };
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+struct BoundingBox {
+  glm::vec3 min = glm::vec3(0.0f);
+  glm::vec3 max = glm::vec3(0.0f);
+
+  glm::vec3 center() const { return (min + max) * 0.5f; }
+  glm::vec3 extents() const { return (max - min) * 0.5f; }
+  float radius() const { return glm::length(extents()); }
+
+  // Arvo's method: the tightest axis-aligned box around the transformed box.
+  BoundingBox transformed(const glm::mat4 &m) const {
+    glm::vec3 c = glm::vec3(m * glm::vec4(center(), 1.0f));
+    glm::vec3 e = extents();
+    glm::vec3 r;
+    for (int i = 0; i < 3; i++) {
+      r[i] = glm::abs(m[0][i]) * e.x + glm::abs(m[1][i]) * e.y +
+             glm::abs(m[2][i]) * e.z;
+    }
+    return {c - r, c + r};
+  }
+};
\ No newline at end of file
@@ -57,10 +57,19 @@ void Camera::processMouseMovement(float xoffset, float yoffset,
 }
 
 void Camera::setAspectRatio(float width, float height) {
+  m_viewportWidth = width;
+  m_viewportHeight = height;
   m_projection = glm::perspective(glm::radians(m_fov), width / height,
                                   m_nearPlane, m_farPlane);
 }
 
+void Camera::setPose(const glm::vec3 &position, float yaw, float pitch) {
+  m_position = position;
+  m_yaw = yaw;
+  m_pitch = glm::clamp(pitch, -89.0f, 89.0f);
+  updateCameraVectors();
+}
+
 void Camera::updateCameraVectors() {
   glm::vec3 front;
   front.x = cos(glm::radians(m_yaw)) * cos(glm::radians(m_pitch));
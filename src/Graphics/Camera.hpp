@@ -22,6 +22,16 @@ public:
 
   void setAspectRatio(float width, float height);
 
+  float getYaw() const { return m_yaw; }
+  float getPitch() const { return m_pitch; }
+  void setPose(const glm::vec3 &position, float yaw, float pitch);
+
+  float getFov() const { return m_fov; }
+  float getNearPlane() const { return m_nearPlane; }
+  float getFarPlane() const { return m_farPlane; }
+  float getViewportWidth() const { return m_viewportWidth; }
+  float getViewportHeight() const { return m_viewportHeight; }
+
 private:
   glm::vec3 m_position;
   glm::vec3 m_front;
@@ -37,6 +47,8 @@ private:
   float m_fov;
   float m_nearPlane;
   float m_farPlane;
+  float m_viewportWidth = 1.0f;
+  float m_viewportHeight = 1.0f;
 
   glm::mat4 m_projection;
 
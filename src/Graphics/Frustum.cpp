@@ -0,0 +1,44 @@
+#include "Graphics/Frustum.hpp"
+
+Frustum Frustum::fromMatrix(const glm::mat4 &m) {
+  Frustum frustum;
+
+  glm::vec4 rows[4];
+  for (int i = 0; i < 4; i++)
+    rows[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+  frustum.m_planes[0] = rows[3] + rows[0]; // left
+  frustum.m_planes[1] = rows[3] - rows[0]; // right
+  frustum.m_planes[2] = rows[3] + rows[1]; // bottom
+  frustum.m_planes[3] = rows[3] - rows[1]; // top
+  frustum.m_planes[4] = rows[3] + rows[2]; // near
+  frustum.m_planes[5] = rows[3] - rows[2]; // far
+
+  for (auto &plane : frustum.m_planes) {
+    float length = glm::length(glm::vec3(plane));
+    if (length > 0.0f)
+      plane /= length;
+  }
+
+  return frustum;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const {
+  for (const auto &plane : m_planes) {
+    if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+      return false;
+  }
+  return true;
+}
+
+bool Frustum::intersectsBox(const BoundingBox &box) const {
+  glm::vec3 center = box.center();
+  glm::vec3 extents = box.extents();
+  for (const auto &plane : m_planes) {
+    float r = extents.x * glm::abs(plane.x) + extents.y * glm::abs(plane.y) +
+              extents.z * glm::abs(plane.z);
+    if (glm::dot(glm::vec3(plane), center) + plane.w < -r)
+      return false;
+  }
+  return true;
+}
\ No newline at end of file
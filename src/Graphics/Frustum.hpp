@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Graphics/BoundingBox.hpp"
+
+#include <glm/glm.hpp>
+
+class Frustum {
+public:
+  static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+  bool intersectsSphere(const glm::vec3 &center, float radius) const;
+  bool intersectsBox(const BoundingBox &box) const;
+
+  const glm::vec4 &getPlane(int index) const { return m_planes[index]; }
+
+private:
+  glm::vec4 m_planes[6];
+};
\ No newline at end of file
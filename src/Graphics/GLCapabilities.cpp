@@ -0,0 +1,121 @@
+#include "Graphics/GLCapabilities.hpp"
+#include "Core/Log.hpp"
+
+#include <glad/glad.h>
+
+namespace {
+
+typedef GLuint64(APIENTRYP PFNGETTEXTUREHANDLEARB)(GLuint texture);
+typedef void(APIENTRYP PFNMAKETEXTUREHANDLERESIDENTARB)(GLuint64 handle);
+typedef void(APIENTRYP PFNMAKETEXTUREHANDLENONRESIDENTARB)(GLuint64 handle);
+typedef void(APIENTRYP PFNMAXSHADERCOMPILERTHREADS)(GLuint count);
+typedef void(APIENTRYP PFNMULTIDRAWELEMENTSINDIRECTCOUNT)(
+    GLenum mode, GLenum type, const void *indirect, GLintptr drawcount,
+    GLsizei maxdrawcount, GLsizei stride);
+
+PFNGETTEXTUREHANDLEARB s_getTextureHandle = nullptr;
+PFNMAKETEXTUREHANDLERESIDENTARB s_makeHandleResident = nullptr;
+PFNMAKETEXTUREHANDLENONRESIDENTARB s_makeHandleNonResident = nullptr;
+PFNMAXSHADERCOMPILERTHREADS s_maxShaderCompilerThreads = nullptr;
+PFNMULTIDRAWELEMENTSINDIRECTCOUNT s_multiDrawElementsIndirectCount = nullptr;
+
+} // namespace
+
+std::unordered_set<std::string> GLCapabilities::s_extensions;
+
+void GLCapabilities::init(LoadProc loader) {
+  s_extensions.clear();
+
+  int count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (int i = 0; i < count; i++) {
+    const char *name =
+        reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+    if (name)
+      s_extensions.insert(name);
+  }
+
+  if (hasExtension("GL_ARB_bindless_texture")) {
+    s_getTextureHandle = reinterpret_cast<PFNGETTEXTUREHANDLEARB>(
+        loader("glGetTextureHandleARB"));
+    s_makeHandleResident = reinterpret_cast<PFNMAKETEXTUREHANDLERESIDENTARB>(
+        loader("glMakeTextureHandleResidentARB"));
+    s_makeHandleNonResident =
+        reinterpret_cast<PFNMAKETEXTUREHANDLENONRESIDENTARB>(
+            loader("glMakeTextureHandleNonResidentARB"));
+  }
+
+  if (hasExtension("GL_KHR_parallel_shader_compile"))
+    s_maxShaderCompilerThreads = reinterpret_cast<PFNMAXSHADERCOMPILERTHREADS>(
+        loader("glMaxShaderCompilerThreadsKHR"));
+  else if (hasExtension("GL_ARB_parallel_shader_compile"))
+    s_maxShaderCompilerThreads = reinterpret_cast<PFNMAXSHADERCOMPILERTHREADS>(
+        loader("glMaxShaderCompilerThreadsARB"));
+
+  // 0xFFFFFFFF lets the driver pick its own thread count.
+  if (s_maxShaderCompilerThreads)
+    s_maxShaderCompilerThreads(0xFFFFFFFFu);
+
+  // Core in 4.6; older contexts may still expose the ARB entry point.
+  s_multiDrawElementsIndirectCount =
+      reinterpret_cast<PFNMULTIDRAWELEMENTSINDIRECTCOUNT>(
+          loader("glMultiDrawElementsIndirectCount"));
+  if (!s_multiDrawElementsIndirectCount &&
+      hasExtension("GL_ARB_indirect_parameters"))
+    s_multiDrawElementsIndirectCount =
+        reinterpret_cast<PFNMULTIDRAWELEMENTSINDIRECTCOUNT>(
+            loader("glMultiDrawElementsIndirectCountARB"));
+
+  LOG_CORE_INFO("  Extensions: {0}", s_extensions.size());
+  LOG_CORE_INFO("  Bindless Textures: {0}",
+                supportsBindlessTextures() ? "YES" : "NO");
+  LOG_CORE_INFO("  Parallel Shader Compile: {0}",
+                supportsParallelShaderCompile() ? "YES" : "NO");
+  LOG_CORE_INFO("  Indirect Draw Count: {0}",
+                supportsIndirectCount() ? "YES" : "NO");
+}
+
+bool GLCapabilities::hasExtension(const std::string &name) {
+  return s_extensions.find(name) != s_extensions.end();
+}
+
+bool GLCapabilities::supportsS3TC() {
+  return hasExtension("GL_EXT_texture_compression_s3tc");
+}
+
+bool GLCapabilities::supportsBindlessTextures() {
+  return s_getTextureHandle && s_makeHandleResident && s_makeHandleNonResident;
+}
+
+bool GLCapabilities::supportsParallelShaderCompile() {
+  return s_maxShaderCompilerThreads != nullptr;
+}
+
+bool GLCapabilities::supportsIndirectCount() {
+  return s_multiDrawElementsIndirectCount != nullptr;
+}
+
+uint64_t GLCapabilities::getTextureHandle(unsigned int texture) {
+  return s_getTextureHandle ? s_getTextureHandle(texture) : 0;
+}
+
+void GLCapabilities::makeTextureHandleResident(uint64_t handle,
+                                               bool resident) {
+  if (handle == 0)
+    return;
+  if (resident && s_makeHandleResident)
+    s_makeHandleResident(handle);
+  else if (!resident && s_makeHandleNonResident)
+    s_makeHandleNonResident(handle);
+}
+
+void GLCapabilities::multiDrawElementsIndirectCount(unsigned int indexType,
+                                                    intptr_t commandOffset,
+                                                    intptr_t countOffset,
+                                                    int maxDrawCount) {
+  if (!s_multiDrawElementsIndirectCount || maxDrawCount <= 0)
+    return;
+  s_multiDrawElementsIndirectCount(
+      GL_TRIANGLES, indexType, reinterpret_cast<const void *>(commandOffset),
+      countOffset, maxDrawCount, 0);
+}
\ No newline at end of file
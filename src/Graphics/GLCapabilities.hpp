@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+class GLCapabilities {
+public:
+  using LoadProc = void *(*)(const char *name);
+
+  // Must be called once a context is current. Queries are read-only
+  // afterwards, so they are safe to call from worker threads.
+  static void init(LoadProc loader);
+
+  static bool hasExtension(const std::string &name);
+
+  static bool supportsS3TC();
+  static bool supportsBindlessTextures();
+  // KHR/ARB_parallel_shader_compile: compiles and links return immediately
+  // and GL_COMPLETION_STATUS_KHR can be polled without stalling.
+  static bool supportsParallelShaderCompile();
+  // glMultiDrawElementsIndirectCount (GL 4.6 or ARB_indirect_parameters):
+  // the draw count is read from a GPU buffer.
+  static bool supportsIndirectCount();
+
+  // --- ARB_bindless_texture (not part of the core-profile loader) ---
+  static uint64_t getTextureHandle(unsigned int texture);
+  static void makeTextureHandleResident(uint64_t handle, bool resident);
+
+  // Draws GL_TRIANGLES with `indexType` indices from the bound
+  // GL_DRAW_INDIRECT_BUFFER, with the count at `countOffset` in the bound
+  // GL_PARAMETER_BUFFER.
+  static void multiDrawElementsIndirectCount(unsigned int indexType,
+                                             intptr_t commandOffset,
+                                             intptr_t countOffset,
+                                             int maxDrawCount);
+
+private:
+  static std::unordered_set<std::string> s_extensions;
+};
\ No newline at end of file
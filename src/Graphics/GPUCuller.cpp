@@ -0,0 +1,168 @@
+#include "Graphics/GPUCuller.hpp"
+#include "Graphics/GLCapabilities.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <glad/glad.h>
+
+namespace {
+
+// Matches DrawElementsIndirectCommand in the GL spec and cull_comp.glsl.
+struct DrawCommand {
+  uint32_t count;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  uint32_t baseInstance;
+};
+
+} // namespace
+
+GPUCuller::~GPUCuller() {
+  glDeleteBuffers(1, &m_commandBuffer);
+  glDeleteBuffers(1, &m_countBuffer);
+  glDeleteTextures(1, &m_depthTexture);
+  glDeleteTextures(1, &m_hiZTexture);
+}
+
+void GPUCuller::setShaders(std::shared_ptr<Shader> cullShader,
+                           std::shared_ptr<Shader> hiZShader) {
+  m_cullShader = std::move(cullShader);
+  m_hiZShader = std::move(hiZShader);
+}
+
+bool GPUCuller::isSupported() const {
+  return m_cullShader && m_cullShader->isValid() && m_hiZShader &&
+         m_hiZShader->isValid() && GLCapabilities::supportsIndirectCount();
+}
+
+void GPUCuller::resize(size_t firstObject, size_t objectCount,
+                       size_t batchCount) {
+  m_firstObject = firstObject;
+  m_objectCount = objectCount;
+  m_batchCount = batchCount;
+  if (m_objectCount == 0)
+    return;
+
+  if (m_objectCount > m_commandCapacity) {
+    m_commandCapacity = std::max<size_t>(256, m_objectCount * 2);
+    glDeleteBuffers(1, &m_commandBuffer);
+    glCreateBuffers(1, &m_commandBuffer);
+    glNamedBufferStorage(m_commandBuffer,
+                         m_commandCapacity * sizeof(DrawCommand), nullptr, 0);
+  }
+  if (m_batchCount > m_batchCapacity) {
+    m_batchCapacity = std::max<size_t>(16, m_batchCount * 2);
+    glDeleteBuffers(1, &m_countBuffer);
+    glCreateBuffers(1, &m_countBuffer);
+    glNamedBufferStorage(m_countBuffer, m_batchCapacity * sizeof(uint32_t),
+                         nullptr, GL_DYNAMIC_STORAGE_BIT);
+  }
+}
+
+void GPUCuller::cull(const glm::mat4 &viewProjection) {
+  if (m_objectCount == 0)
+    return;
+
+  glClearNamedBufferSubData(m_countBuffer, GL_R32UI, 0,
+                            m_batchCount * sizeof(uint32_t), GL_RED_INTEGER,
+                            GL_UNSIGNED_INT, nullptr);
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING,
+                   m_commandBuffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COUNT_BINDING, m_countBuffer);
+
+  Frustum frustum = Frustum::fromMatrix(viewProjection);
+  m_cullShader->useShader();
+  for (int i = 0; i < 6; i++)
+    m_cullShader->setUniformVec4("u_FrustumPlanes[" + std::to_string(i) + "]",
+                                 frustum.getPlane(i));
+  m_cullShader->setUniformInt("u_FirstObject",
+                              static_cast<int>(m_firstObject));
+  m_cullShader->setUniformInt("u_ObjectCount",
+                              static_cast<int>(m_objectCount));
+
+  const bool useHiZ = m_hiZEnabled && m_hiZValid;
+  m_cullShader->setUniformBool("u_UseHiZ", useHiZ);
+  if (useHiZ) {
+    m_cullShader->setUniformMat4("u_HiZViewProjection", m_hiZViewProjection);
+    glBindTextureUnit(0, m_hiZTexture);
+  }
+
+  m_cullShader->dispatch(
+      static_cast<unsigned int>((m_objectCount + 63) / 64), 1, 1);
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void GPUCuller::drawBatch(size_t batch, size_t firstCommand,
+                          size_t commandCount, IndexType indexType) const {
+  if (m_objectCount == 0)
+    return;
+
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+  glBindBuffer(GL_PARAMETER_BUFFER, m_countBuffer);
+  GLCapabilities::multiDrawElementsIndirectCount(
+      Mesh::toGLIndexType(indexType),
+      static_cast<intptr_t>(firstCommand * sizeof(DrawCommand)),
+      static_cast<intptr_t>(batch * sizeof(uint32_t)),
+      static_cast<int>(commandCount));
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  glBindBuffer(GL_PARAMETER_BUFFER, 0);
+}
+
+void GPUCuller::resizeHiZ(int width, int height) {
+  glDeleteTextures(1, &m_depthTexture);
+  glDeleteTextures(1, &m_hiZTexture);
+
+  m_hiZWidth = width;
+  m_hiZHeight = height;
+  m_hiZLevels =
+      1 + static_cast<int>(std::floor(std::log2(std::max(width, height))));
+
+  glCreateTextures(GL_TEXTURE_2D, 1, &m_depthTexture);
+  glTextureStorage2D(m_depthTexture, 1, GL_DEPTH_COMPONENT24, width, height);
+  glTextureParameteri(m_depthTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTextureParameteri(m_depthTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  glCreateTextures(GL_TEXTURE_2D, 1, &m_hiZTexture);
+  glTextureStorage2D(m_hiZTexture, m_hiZLevels, GL_R32F, width, height);
+  glTextureParameteri(m_hiZTexture, GL_TEXTURE_MIN_FILTER,
+                      GL_NEAREST_MIPMAP_NEAREST);
+  glTextureParameteri(m_hiZTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTextureParameteri(m_hiZTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTextureParameteri(m_hiZTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void GPUCuller::buildHiZ(const glm::mat4 &viewProjection, int width,
+                         int height) {
+  if (width <= 0 || height <= 0)
+    return;
+  if (width != m_hiZWidth || height != m_hiZHeight)
+    resizeHiZ(width, height);
+
+  // Depth can't be bound as an image, so it is copied out of the default
+  // framebuffer and read through a sampler for the first level.
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+  glCopyTextureSubImage2D(m_depthTexture, 0, 0, 0, 0, 0, width, height);
+
+  m_hiZShader->useShader();
+  glBindTextureUnit(0, m_depthTexture);
+  for (int level = 0; level < m_hiZLevels; level++) {
+    const int levelWidth = std::max(width >> level, 1);
+    const int levelHeight = std::max(height >> level, 1);
+
+    m_hiZShader->setUniformBool("u_FromDepth", level == 0);
+    if (level > 0)
+      glBindImageTexture(0, m_hiZTexture, level - 1, GL_FALSE, 0,
+                         GL_READ_ONLY, GL_R32F);
+    glBindImageTexture(1, m_hiZTexture, level, GL_FALSE, 0, GL_WRITE_ONLY,
+                       GL_R32F);
+    m_hiZShader->dispatch((levelWidth + 7) / 8, (levelHeight + 7) / 8, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+  }
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+  m_hiZViewProjection = viewProjection;
+  m_hiZValid = true;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Graphics/Frustum.hpp"
+#include "Graphics/Mesh.hpp"
+#include "Graphics/Shader.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// GPU-driven visibility for opaque geometry. Each object in a range of the
+// ObjectBuffer is tested in a compute shader against the frustum, the
+// clipping planes and a depth pyramid built from the previous frame;
+// survivors are appended to their batch's range of an indirect command
+// buffer, and each batch is then drawn with one
+// glMultiDrawElementsIndirectCount call. The CPU never learns which objects
+// were visible.
+class GPUCuller {
+public:
+  static constexpr unsigned int COMMAND_BINDING = 2;
+  static constexpr unsigned int COUNT_BINDING = 3;
+
+  GPUCuller() = default;
+  ~GPUCuller();
+
+  GPUCuller(const GPUCuller &) = delete;
+  GPUCuller &operator=(const GPUCuller &) = delete;
+
+  void setShaders(std::shared_ptr<Shader> cullShader,
+                  std::shared_ptr<Shader> hiZShader);
+  // Needs compute shaders, indirect draw counts and both programs.
+  bool isSupported() const;
+
+  // Objects [firstObject, firstObject + objectCount) must be sorted by
+  // batch, with commandOffset counted from the first of them. The object
+  // buffer must be bound when cull() and drawBatch() run.
+  void resize(size_t firstObject, size_t objectCount, size_t batchCount);
+  void cull(const glm::mat4 &viewProjection);
+  // Issues the surviving draws of one batch with whatever program is bound.
+  void drawBatch(size_t batch, size_t firstCommand, size_t commandCount,
+                 IndexType indexType) const;
+
+  // Copies the depth buffer of the frame just drawn with `viewProjection`
+  // and reduces it into the pyramid the next cull() tests against.
+  void buildHiZ(const glm::mat4 &viewProjection, int width, int height);
+  void invalidateHiZ() { m_hiZValid = false; }
+
+  void setHiZEnabled(bool enabled) { m_hiZEnabled = enabled; }
+  bool isHiZEnabled() const { return m_hiZEnabled; }
+  size_t getObjectCount() const { return m_objectCount; }
+
+private:
+  std::shared_ptr<Shader> m_cullShader;
+  std::shared_ptr<Shader> m_hiZShader;
+
+  unsigned int m_commandBuffer = 0;
+  unsigned int m_countBuffer = 0;
+  size_t m_commandCapacity = 0;
+  size_t m_batchCapacity = 0;
+  size_t m_firstObject = 0;
+  size_t m_objectCount = 0;
+  size_t m_batchCount = 0;
+
+  unsigned int m_depthTexture = 0;
+  unsigned int m_hiZTexture = 0;
+  int m_hiZWidth = 0;
+  int m_hiZHeight = 0;
+  int m_hiZLevels = 0;
+  glm::mat4 m_hiZViewProjection = glm::mat4(1.0f);
+  bool m_hiZValid = false;
+  bool m_hiZEnabled = true;
+
+  void resizeHiZ(int width, int height);
+};
\ No newline at end of file
@@ -1,12 +1,15 @@
 #include "Graphics/GeometryManager.hpp"
 #include "Core/Log.hpp"
 
+#include <algorithm>
+#include <cstdint>
+
 void GeometryManager::init() {
   glCreateBuffers(1, &m_globalBuffer);
 
   size_t totalSize = MAX_VERTEX_MEMORY + MAX_INDEX_MEMORY;
   glNamedBufferStorage(m_globalBuffer, totalSize, nullptr,
-                       GL_DYNAMIC_STORAGE_BIT);
+                       GL_DYNAMIC_STORAGE_BIT | GL_MAP_WRITE_BIT);
 
   glCreateVertexArrays(1, &m_globalVAO);
 
@@ -35,38 +38,201 @@ void GeometryManager::init() {
 
 MeshRange GeometryManager::upload(const std::vector<Vertex> &vertices,
                                   const std::vector<unsigned int> &indices) {
-  size_t vertSize = vertices.size() * sizeof(Vertex);
-  size_t idxSize = indices.size() * sizeof(unsigned int);
+  return upload(vertices.data(), vertices.size(), indices.data(),
+                indices.size());
+}
 
-  if (m_verticesHead + vertSize > MAX_VERTEX_MEMORY) {
-    LOG_CORE_ERROR("GeometryManager::upload - Vertex Buffer Overflow!");
+MeshRange GeometryManager::upload(const Vertex *vertices, size_t vertexCount,
+                                  const unsigned int *indices,
+                                  size_t indexCount) {
+  if (chooseIndexType(vertexCount) == IndexType::UInt32)
+    return uploadRaw(vertices, vertexCount, indices, indexCount,
+                     IndexType::UInt32);
+
+  std::vector<uint16_t> narrowed(indices, indices + indexCount);
+  return uploadRaw(vertices, vertexCount, narrowed.data(), indexCount,
+                   IndexType::UInt16);
+}
+
+MeshRange GeometryManager::upload(const Vertex *vertices, size_t vertexCount,
+                                  const uint16_t *indices, size_t indexCount) {
+  return uploadRaw(vertices, vertexCount, indices, indexCount,
+                   IndexType::UInt16);
+}
+
+MeshRange GeometryManager::uploadRaw(const Vertex *vertices,
+                                     size_t vertexCount, const void *indices,
+                                     size_t indexCount, IndexType indexType) {
+  MeshRange range;
+  bool recycled;
+  if (!reserve(vertexCount, indexCount, indexType, range, recycled))
     return {};
-  }
-  if (m_indicesHead + idxSize > MAX_INDEX_MEMORY) {
-    LOG_CORE_ERROR("GeometryManager::upload - Index Buffer Overflow!");
+
+  size_t vertSize = vertexCount * sizeof(Vertex);
+  size_t idxSize = indexCount * getIndexSize(indexType);
+
+  glNamedBufferSubData(m_globalBuffer, range.vertexOffset * sizeof(Vertex),
+                       vertSize, vertices);
+
+  glNamedBufferSubData(m_globalBuffer, range.indexOffset, idxSize, indices);
+
+  return range;
+}
+
+MeshRange GeometryManager::upload(size_t vertexCount,
+                                  const VertexWriter &writeVertices,
+                                  size_t indexCount,
+                                  const IndexWriter &writeIndices) {
+  const IndexType indexType = chooseIndexType(vertexCount);
+  MeshRange range;
+  bool recycled;
+  if (!reserve(vertexCount, indexCount, indexType, range, recycled))
     return {};
+
+  size_t vertSize = vertexCount * sizeof(Vertex);
+  size_t idxSize = indexCount * getIndexSize(indexType);
+
+  // Fresh ranges have never been drawn from, so nothing in flight can be
+  // reading them and the mappings need no synchronization; recycled ones
+  // may still be in use by the previous frames. A buffer can only be mapped
+  // once at a time, hence one range after the other.
+  GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+  if (!recycled)
+    access |= GL_MAP_UNSYNCHRONIZED_BIT;
+  if (vertSize > 0) {
+    void *dst = glMapNamedBufferRange(
+        m_globalBuffer, range.vertexOffset * sizeof(Vertex), vertSize, access);
+    writeVertices(static_cast<Vertex *>(dst));
+    glUnmapNamedBuffer(m_globalBuffer);
+  }
+  if (idxSize > 0) {
+    void *dst = glMapNamedBufferRange(m_globalBuffer, range.indexOffset,
+                                      idxSize, access);
+    writeIndices(dst, indexType);
+    glUnmapNamedBuffer(m_globalBuffer);
   }
 
-  MeshRange range;
+  return range;
+}
 
-  range.vertexOffset =
-      static_cast<unsigned int>(m_verticesHead / sizeof(Vertex));
+void GeometryManager::free(const MeshRange &range) {
+  release(m_freeVertices, m_verticesHead,
+          static_cast<size_t>(range.vertexOffset) * sizeof(Vertex),
+          static_cast<size_t>(range.vertexCount) * sizeof(Vertex));
+  release(m_freeIndices, m_indicesHead,
+          range.indexOffset - m_indicesStartOffset,
+          getIndexBytes(range.indexCount, range.indexType));
+  release(m_freeMeshlets, m_meshletsHead, range.meshletOffset,
+          range.meshletCount);
+}
+
+bool GeometryManager::addMeshlets(MeshRange &range,
+                                  const std::vector<Meshlet> &meshlets) {
+  size_t offset;
+  bool recycled = false;
+  if (!allocate(m_freeMeshlets, m_meshletsHead, SIZE_MAX, meshlets.size(),
+                offset, recycled))
+    return false;
+  if (m_meshlets.size() < m_meshletsHead)
+    m_meshlets.resize(m_meshletsHead);
+  std::copy(meshlets.begin(), meshlets.end(), m_meshlets.begin() + offset);
+
+  range.meshletOffset = static_cast<unsigned int>(offset);
+  range.meshletCount = static_cast<unsigned int>(meshlets.size());
+  return true;
+}
+
+size_t GeometryManager::getIndexBytes(size_t indexCount, IndexType indexType) {
+  return (indexCount * getIndexSize(indexType) + 3) & ~size_t(3);
+}
+
+bool GeometryManager::reserve(size_t vertexCount, size_t indexCount,
+                              IndexType indexType, MeshRange &range,
+                              bool &recycled) {
+  size_t vertSize = vertexCount * sizeof(Vertex);
+  size_t idxSize = getIndexBytes(indexCount, indexType);
+  size_t vertOffset, idxOffset;
+  recycled = false;
+
+  if (!allocate(m_freeVertices, m_verticesHead, MAX_VERTEX_MEMORY, vertSize,
+                vertOffset, recycled)) {
+    LOG_CORE_ERROR("GeometryManager::upload - Vertex Buffer Overflow!");
+    return false;
+  }
+  if (!allocate(m_freeIndices, m_indicesHead, MAX_INDEX_MEMORY, idxSize,
+                idxOffset, recycled)) {
+    release(m_freeVertices, m_verticesHead, vertOffset, vertSize);
+    LOG_CORE_ERROR("GeometryManager::upload - Index Buffer Overflow!");
+    return false;
+  }
+
+  range.vertexOffset = static_cast<unsigned int>(vertOffset / sizeof(Vertex));
+  range.vertexCount = static_cast<unsigned int>(vertexCount);
 
   range.indexOffset =
-      static_cast<unsigned int>(m_indicesStartOffset + m_indicesHead);
+      static_cast<unsigned int>(m_indicesStartOffset + idxOffset);
 
-  range.indexCount = static_cast<unsigned int>(indices.size());
+  range.indexCount = static_cast<unsigned int>(indexCount);
+  range.indexType = indexType;
+  range.meshletOffset = 0;
+  range.meshletCount = 0;
+  return true;
+}
+
+bool GeometryManager::allocate(std::vector<Block> &blocks, size_t &head,
+                               size_t limit, size_t size, size_t &offset,
+                               bool &recycled) {
+  if (size == 0) {
+    offset = head;
+    return true;
+  }
 
-  glNamedBufferSubData(m_globalBuffer, m_verticesHead, vertSize,
-                       vertices.data());
+  // First fit among freed blocks, then the untouched space past the head.
+  for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+    if (it->size < size)
+      continue;
+    offset = it->offset;
+    it->offset += size;
+    it->size -= size;
+    if (it->size == 0)
+      blocks.erase(it);
+    recycled = true;
+    return true;
+  }
 
-  glNamedBufferSubData(m_globalBuffer, m_indicesStartOffset + m_indicesHead,
-                       idxSize, indices.data());
+  if (head + size > limit)
+    return false;
+  offset = head;
+  head += size;
+  return true;
+}
 
-  m_verticesHead += vertSize;
-  m_indicesHead += idxSize;
+void GeometryManager::release(std::vector<Block> &blocks, size_t &head,
+                              size_t offset, size_t size) {
+  if (size == 0)
+    return;
 
-  return range;
+  auto it = std::lower_bound(
+      blocks.begin(), blocks.end(), offset,
+      [](const Block &block, size_t value) { return block.offset < value; });
+  it = blocks.insert(it, {offset, size});
+
+  if (std::next(it) != blocks.end() &&
+      it->offset + it->size == std::next(it)->offset) {
+    it->size += std::next(it)->size;
+    blocks.erase(std::next(it));
+  }
+  if (it != blocks.begin() &&
+      std::prev(it)->offset + std::prev(it)->size == it->offset) {
+    std::prev(it)->size += it->size;
+    it = blocks.erase(it) - 1;
+  }
+
+  // A block reaching the head is just unused space again.
+  if (it->offset + it->size == head) {
+    head = it->offset;
+    blocks.erase(it);
+  }
 }
 
 void GeometryManager::shutdown() {
@@ -1,15 +1,10 @@
 #pragma once
 
 #include "Graphics/Mesh.hpp"
+#include <functional>
 #include <glad/glad.h>
 #include <vector>
 
-struct MeshRange {
-  unsigned int vertexOffset;
-  unsigned int indexOffset;
-  unsigned int indexCount;
-};
-
 class GeometryManager {
 public:
   static GeometryManager &get() {
@@ -20,8 +15,40 @@ public:
   void init();
   void shutdown();
 
+  // Meshes with at most this many vertices are stored with 16-bit indices.
+  // 0xFFFF itself stays free as the primitive restart index.
+  static constexpr size_t MAX_16BIT_VERTICES = 65535;
+
+  static IndexType chooseIndexType(size_t vertexCount) {
+    return vertexCount <= MAX_16BIT_VERTICES ? IndexType::UInt16
+                                             : IndexType::UInt32;
+  }
+
+  using VertexWriter = std::function<void(Vertex *dst)>;
+  // `dst` holds uint16_t or uint32_t indices, as `type` says.
+  using IndexWriter = std::function<void(void *dst, IndexType type)>;
+
+  // 32-bit indices are narrowed when the mesh fits in 16 bits.
   MeshRange upload(const std::vector<Vertex> &vertices,
                    const std::vector<unsigned int> &indices);
+  MeshRange upload(const Vertex *vertices, size_t vertexCount,
+                   const unsigned int *indices, size_t indexCount);
+  MeshRange upload(const Vertex *vertices, size_t vertexCount,
+                   const uint16_t *indices, size_t indexCount);
+  // Lets the caller write straight into the global buffer through
+  // write-only mappings instead of staging the mesh in CPU memory first.
+  MeshRange upload(size_t vertexCount, const VertexWriter &writeVertices,
+                   size_t indexCount, const IndexWriter &writeIndices);
+  // Hands a range back for reuse by later uploads. Mesh calls this when it
+  // is destroyed.
+  void free(const MeshRange &range);
+
+  // Meshlet descriptors stay on the CPU, where they are culled, and are
+  // released with the range they describe.
+  bool addMeshlets(MeshRange &range, const std::vector<Meshlet> &meshlets);
+  const Meshlet *getMeshlets(const MeshRange &range) const {
+    return m_meshlets.data() + range.meshletOffset;
+  }
 
   unsigned int getGlobalVAO() const { return m_globalVAO; }
   unsigned int getGlobalBuffer() const { return m_globalBuffer; }
@@ -39,4 +66,32 @@ private:
   const size_t MAX_INDEX_MEMORY = 32 * 1024 * 1024;
 
   size_t m_indicesStartOffset = MAX_VERTEX_MEMORY;
+
+  // Freed byte ranges below each head, sorted by offset and coalesced.
+  struct Block {
+    size_t offset;
+    size_t size;
+  };
+  std::vector<Block> m_freeVertices;
+  std::vector<Block> m_freeIndices;
+
+  // Allocated in meshlets rather than bytes, with no fixed limit.
+  std::vector<Meshlet> m_meshlets;
+  std::vector<Block> m_freeMeshlets;
+  size_t m_meshletsHead = 0;
+
+  // `recycled` is set when either range was freed before, so the GPU may
+  // still be reading it.
+  bool reserve(size_t vertexCount, size_t indexCount, IndexType indexType,
+               MeshRange &range, bool &recycled);
+  MeshRange uploadRaw(const Vertex *vertices, size_t vertexCount,
+                      const void *indices, size_t indexCount,
+                      IndexType indexType);
+  // Index ranges are padded to 4 bytes so 32-bit meshes stay aligned after
+  // 16-bit ones.
+  static size_t getIndexBytes(size_t indexCount, IndexType indexType);
+  static bool allocate(std::vector<Block> &blocks, size_t &head, size_t limit,
+                       size_t size, size_t &offset, bool &recycled);
+  static void release(std::vector<Block> &blocks, size_t &head, size_t offset,
+                      size_t size);
 };
\ No newline at end of file
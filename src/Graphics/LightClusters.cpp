@@ -0,0 +1,261 @@
+#include "Graphics/LightClusters.hpp"
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <glad/glad.h>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIGHT_CLUSTERS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr float PADDING_DISTANCE = 1.0e30f;
+
+int depthSlice(float depth, float scale, float bias) {
+  int slice = static_cast<int>(std::floor(std::log(depth) * scale + bias));
+  return std::clamp(slice, 0, LightClusters::GRID_Z - 1);
+}
+
+} // namespace
+
+LightClusters::~LightClusters() {
+  glDeleteBuffers(1, &m_ubo);
+  glDeleteBuffers(1, &m_lightBuffer);
+  glDeleteBuffers(1, &m_clusterBuffer);
+  glDeleteBuffers(1, &m_indexBuffer);
+}
+
+void LightClusters::init() {
+  glCreateBuffers(1, &m_ubo);
+  glNamedBufferStorage(m_ubo, sizeof(LightingDataUBOLayout), nullptr,
+                       GL_DYNAMIC_STORAGE_BIT);
+
+  glCreateBuffers(1, &m_clusterBuffer);
+  glNamedBufferStorage(m_clusterBuffer,
+                       CLUSTER_COUNT * 2 * sizeof(uint32_t), nullptr,
+                       GL_DYNAMIC_STORAGE_BIT);
+
+  m_slices.resize(GRID_Z);
+  m_clusters.assign(CLUSTER_COUNT * 2, 0);
+}
+
+void LightClusters::update(const std::vector<PointLight> &lights,
+                           const Camera &camera) {
+  auto start = std::chrono::steady_clock::now();
+
+  const glm::mat4 view = camera.getViewMatrix();
+  const float nearPlane = camera.getNearPlane();
+  const float farPlane = camera.getFarPlane();
+  const float tanY = std::tan(glm::radians(camera.getFov()) * 0.5f);
+  const float tanX =
+      tanY * camera.getViewportWidth() / camera.getViewportHeight();
+  const float depthScale = GRID_Z / std::log(farPlane / nearPlane);
+  const float depthBias = -std::log(nearPlane) * depthScale;
+
+  m_lightCount = lights.size();
+  m_viewLights.resize(m_lightCount);
+  m_firstSlice.resize(m_lightCount);
+  m_lastSlice.resize(m_lightCount);
+  m_gpuLights.resize(m_lightCount * 2);
+
+  for (size_t i = 0; i < m_lightCount; i++) {
+    const PointLight &light = lights[i];
+    m_gpuLights[i * 2] = glm::vec4(light.position, light.radius);
+    m_gpuLights[i * 2 + 1] = glm::vec4(light.color, light.intensity);
+
+    const glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+    m_viewLights[i] = glm::vec4(center, light.radius);
+
+    const float depth = -center.z;
+    if (light.radius <= 0.0f || depth + light.radius < nearPlane ||
+        depth - light.radius > farPlane) {
+      m_firstSlice[i] = 1;
+      m_lastSlice[i] = 0;
+      continue;
+    }
+    m_firstSlice[i] = depthSlice(std::max(depth - light.radius, nearPlane),
+                                 depthScale, depthBias);
+    m_lastSlice[i] = depthSlice(std::min(depth + light.radius, farPlane),
+                                depthScale, depthBias);
+  }
+
+  // Slices own disjoint clusters, so they are binned independently.
+  const float depthRatio = farPlane / nearPlane;
+  JobSystem::get().parallelFor(GRID_Z, [&](size_t begin, size_t end) {
+    for (size_t z = begin; z < end; z++) {
+      float depth0 = nearPlane * std::pow(depthRatio, float(z) / GRID_Z);
+      float depth1 = nearPlane * std::pow(depthRatio, float(z + 1) / GRID_Z);
+      binSlice(static_cast<int>(z), depth0, depth1, tanX, tanY);
+    }
+  });
+
+  m_indices.clear();
+  m_maxPerCluster = 0;
+  for (int z = 0; z < GRID_Z; z++) {
+    const Slice &slice = m_slices[z];
+    uint32_t offset = static_cast<uint32_t>(m_indices.size());
+    for (int c = 0; c < GRID_X * GRID_Y; c++) {
+      const size_t cluster = z * GRID_X * GRID_Y + c;
+      m_clusters[cluster * 2] = offset;
+      m_clusters[cluster * 2 + 1] = slice.counts[c];
+      offset += slice.counts[c];
+      m_maxPerCluster = std::max(m_maxPerCluster, slice.counts[c]);
+    }
+    m_indices.insert(m_indices.end(), slice.indices.begin(),
+                     slice.indices.end());
+  }
+
+  LightingDataUBOLayout lighting{};
+  lighting.gridSize[0] = GRID_X;
+  lighting.gridSize[1] = GRID_Y;
+  lighting.gridSize[2] = GRID_Z;
+  lighting.lightCount = static_cast<uint32_t>(m_lightCount);
+  lighting.depthScale = depthScale;
+  lighting.depthBias = depthBias;
+  lighting.tileSize = glm::vec2(camera.getViewportWidth() / GRID_X,
+                                camera.getViewportHeight() / GRID_Y);
+  upload(lighting);
+
+  m_milliseconds = std::chrono::duration<float, std::milli>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+}
+
+void LightClusters::binSlice(int z, float depth0, float depth1, float tanX,
+                             float tanY) {
+  Slice &slice = m_slices[z];
+  slice.x.clear();
+  slice.y.clear();
+  slice.z.clear();
+  slice.radiusSq.clear();
+  slice.lights.clear();
+  slice.indices.clear();
+
+  for (size_t i = 0; i < m_lightCount; i++) {
+    if (z < m_firstSlice[i] || z > m_lastSlice[i])
+      continue;
+    const glm::vec4 &sphere = m_viewLights[i];
+    slice.x.push_back(sphere.x);
+    slice.y.push_back(sphere.y);
+    slice.z.push_back(sphere.z);
+    slice.radiusSq.push_back(sphere.w * sphere.w);
+    slice.lights.push_back(static_cast<uint32_t>(i));
+  }
+  // Padding lights sit infinitely far away and never match.
+  while (slice.x.size() % 4 != 0) {
+    slice.x.push_back(PADDING_DISTANCE);
+    slice.y.push_back(0.0f);
+    slice.z.push_back(0.0f);
+    slice.radiusSq.push_back(0.0f);
+    slice.lights.push_back(0);
+  }
+  const size_t candidates = slice.x.size();
+
+  // View space looks down -z.
+  const float minZ = -depth1, maxZ = -depth0;
+
+  for (int y = 0; y < GRID_Y; y++) {
+    const float ndcY0 = -1.0f + 2.0f * y / GRID_Y;
+    const float ndcY1 = -1.0f + 2.0f * (y + 1) / GRID_Y;
+    const float minY = std::min(ndcY0 * tanY * depth0, ndcY0 * tanY * depth1);
+    const float maxY = std::max(ndcY1 * tanY * depth0, ndcY1 * tanY * depth1);
+
+    for (int x = 0; x < GRID_X; x++) {
+      const float ndcX0 = -1.0f + 2.0f * x / GRID_X;
+      const float ndcX1 = -1.0f + 2.0f * (x + 1) / GRID_X;
+      const float minX =
+          std::min(ndcX0 * tanX * depth0, ndcX0 * tanX * depth1);
+      const float maxX =
+          std::max(ndcX1 * tanX * depth0, ndcX1 * tanX * depth1);
+
+      uint32_t count = 0;
+      for (size_t i = 0;
+           i < candidates && count < MAX_LIGHTS_PER_CLUSTER; i += 4) {
+        // Squared distance from each sphere centre to the cluster's box.
+        int mask = 0;
+#ifdef LIGHT_CLUSTERS_SSE2
+        const __m128 zero = _mm_setzero_ps();
+        __m128 cx = _mm_loadu_ps(&slice.x[i]);
+        __m128 cy = _mm_loadu_ps(&slice.y[i]);
+        __m128 cz = _mm_loadu_ps(&slice.z[i]);
+        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(minX), cx),
+                                          _mm_sub_ps(cx, _mm_set1_ps(maxX))),
+                               zero);
+        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(minY), cy),
+                                          _mm_sub_ps(cy, _mm_set1_ps(maxY))),
+                               zero);
+        __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(minZ), cz),
+                                          _mm_sub_ps(cz, _mm_set1_ps(maxZ))),
+                               zero);
+        __m128 distSq = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+            _mm_mul_ps(dz, dz));
+        mask = _mm_movemask_ps(
+            _mm_cmple_ps(distSq, _mm_loadu_ps(&slice.radiusSq[i])));
+#else
+        for (int k = 0; k < 4; k++) {
+          float dx = std::max({minX - slice.x[i + k], slice.x[i + k] - maxX,
+                               0.0f});
+          float dy = std::max({minY - slice.y[i + k], slice.y[i + k] - maxY,
+                               0.0f});
+          float dz = std::max({minZ - slice.z[i + k], slice.z[i + k] - maxZ,
+                               0.0f});
+          if (dx * dx + dy * dy + dz * dz <= slice.radiusSq[i + k])
+            mask |= 1 << k;
+        }
+#endif
+        for (int k = 0; k < 4 && count < MAX_LIGHTS_PER_CLUSTER; k++) {
+          if (mask & (1 << k)) {
+            slice.indices.push_back(slice.lights[i + k]);
+            count++;
+          }
+        }
+      }
+      slice.counts[y * GRID_X + x] = count;
+    }
+  }
+}
+
+void LightClusters::upload(const LightingDataUBOLayout &lighting) {
+  glNamedBufferSubData(m_ubo, 0, sizeof(lighting), &lighting);
+  glNamedBufferSubData(m_clusterBuffer, 0,
+                       m_clusters.size() * sizeof(uint32_t),
+                       m_clusters.data());
+
+  if (m_lightCount > m_lightCapacity || m_lightBuffer == 0) {
+    m_lightCapacity = std::max<size_t>(64, m_lightCount * 2);
+    glDeleteBuffers(1, &m_lightBuffer);
+    glCreateBuffers(1, &m_lightBuffer);
+    glNamedBufferStorage(m_lightBuffer,
+                         m_lightCapacity * 2 * sizeof(glm::vec4), nullptr,
+                         GL_DYNAMIC_STORAGE_BIT);
+  }
+  if (m_lightCount > 0)
+    glNamedBufferSubData(m_lightBuffer, 0,
+                         m_gpuLights.size() * sizeof(glm::vec4),
+                         m_gpuLights.data());
+
+  if (m_indices.size() > m_indexCapacity || m_indexBuffer == 0) {
+    m_indexCapacity = std::max<size_t>(1024, m_indices.size() * 2);
+    glDeleteBuffers(1, &m_indexBuffer);
+    glCreateBuffers(1, &m_indexBuffer);
+    glNamedBufferStorage(m_indexBuffer, m_indexCapacity * sizeof(uint32_t),
+                         nullptr, GL_DYNAMIC_STORAGE_BIT);
+  }
+  if (!m_indices.empty())
+    glNamedBufferSubData(m_indexBuffer, 0, m_indices.size() * sizeof(uint32_t),
+                         m_indices.data());
+}
+
+void LightClusters::bind() const {
+  glBindBufferBase(GL_UNIFORM_BUFFER, UBO_BINDING, m_ubo);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BINDING, m_lightBuffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_BINDING,
+                   m_clusterBuffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INDEX_BINDING, m_indexBuffer);
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Graphics/Camera.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PointLight {
+  glm::vec3 position = glm::vec3(0.0f);
+  // Distance at which the light's contribution reaches zero.
+  float radius = 5.0f;
+  glm::vec3 color = glm::vec3(1.0f);
+  float intensity = 1.0f;
+};
+
+// std140 layout of the LightingData block (lights.glsl).
+struct LightingDataUBOLayout {
+  uint32_t gridSize[3];
+  uint32_t lightCount;
+  float depthScale;
+  float depthBias;
+  glm::vec2 tileSize;
+};
+
+// Clustered forward lighting. The view frustum is split into a grid of
+// froxels (screen tiles x exponential depth slices); each frame every point
+// light is tested against the froxels it could reach, one depth slice per
+// job and four lights per SIMD test, and the resulting per-cluster light
+// lists are uploaded for frag.glsl, which only loops over its own cluster.
+class LightClusters {
+public:
+  static constexpr int GRID_X = 16;
+  static constexpr int GRID_Y = 9;
+  static constexpr int GRID_Z = 24;
+  static constexpr int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+  // Lights beyond this in one cluster are dropped, bounding the cost of the
+  // densest pixels.
+  static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+
+  static constexpr unsigned int UBO_BINDING = 2;
+  static constexpr unsigned int LIGHT_BINDING = 4;
+  static constexpr unsigned int CLUSTER_BINDING = 5;
+  static constexpr unsigned int INDEX_BINDING = 6;
+
+  LightClusters() = default;
+  ~LightClusters();
+
+  LightClusters(const LightClusters &) = delete;
+  LightClusters &operator=(const LightClusters &) = delete;
+
+  void init();
+  // Bins `lights` for the camera's current view and uploads the result.
+  void update(const std::vector<PointLight> &lights, const Camera &camera);
+  void bind() const;
+
+  size_t getLightCount() const { return m_lightCount; }
+  size_t getIndexCount() const { return m_indices.size(); }
+  uint32_t getMaxLightsPerCluster() const { return m_maxPerCluster; }
+  float getMilliseconds() const { return m_milliseconds; }
+
+private:
+  // Per-slice binning state, merged once every slice is done. The lights
+  // reaching the slice are kept as structure-of-arrays, padded to a
+  // multiple of four for the SIMD test.
+  struct Slice {
+    std::vector<float> x, y, z, radiusSq;
+    std::vector<uint32_t> lights;
+    std::vector<uint32_t> indices;
+    uint32_t counts[GRID_X * GRID_Y];
+  };
+
+  unsigned int m_ubo = 0;
+  unsigned int m_lightBuffer = 0;
+  unsigned int m_clusterBuffer = 0;
+  unsigned int m_indexBuffer = 0;
+  size_t m_lightCapacity = 0;
+  size_t m_indexCapacity = 0;
+
+  // View-space spheres (xyz = centre, w = radius) and the depth slices
+  // each one reaches.
+  std::vector<glm::vec4> m_viewLights;
+  std::vector<int> m_firstSlice, m_lastSlice;
+  std::vector<glm::vec4> m_gpuLights;
+  std::vector<Slice> m_slices;
+  std::vector<uint32_t> m_clusters;
+  std::vector<uint32_t> m_indices;
+
+  size_t m_lightCount = 0;
+  uint32_t m_maxPerCluster = 0;
+  float m_milliseconds = 0.0f;
+
+  void binSlice(int z, float depth0, float depth1, float tanX, float tanY);
+  void upload(const LightingDataUBOLayout &lighting);
+};
\ No newline at end of file
@@ -1,8 +1,13 @@
 #include "Graphics/Material.hpp"
 #include "Core/Log.hpp"
+#include "Graphics/MaterialTable.hpp"
 
 Material::Material(std::shared_ptr<Shader> shader)
-    : m_shader(std::move(shader)) {}
+    : m_shader(std::move(shader)) {
+  m_tableIndex = MaterialTable::get().allocate(this);
+}
+
+Material::~Material() { MaterialTable::get().release(m_tableIndex); }
 
 void Material::bind() {
   if (!m_shader)
@@ -23,6 +28,11 @@ void Material::bind() {
   for (const auto &[name, value] : m_uniformsMat4)
     m_shader->setUniformMat4(name, value);
 
+  // Table-driven materials are reached through the object's material index
+  // and the material buffer bound once per frame.
+  if (m_tableIndex >= 0)
+    return;
+
   unsigned int slot = 0;
   for (const auto &[name, texture] : m_textures) {
     if (texture) {
@@ -60,4 +70,16 @@ void Material::setMat4(const std::string &name, const glm::mat4 &value) {
 void Material::setTexture(const std::string &name,
                           std::shared_ptr<Texture> texture) {
   m_textures[name] = texture;
+}
+
+std::shared_ptr<Texture> Material::getTexture(const std::string &name) const {
+  auto it = m_textures.find(name);
+  return it != m_textures.end() ? it->second : nullptr;
+}
+
+void Material::requestTextureDetail(float screenPixels) {
+  for (const auto &[name, texture] : m_textures) {
+    if (texture)
+      texture->requestScreenSize(screenPixels);
+  }
 }
\ No newline at end of file
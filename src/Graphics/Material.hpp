@@ -11,7 +11,10 @@
 class Material {
 public:
   Material(std::shared_ptr<Shader> shader);
-  ~Material() = default;
+  ~Material();
+
+  Material(const Material &other) = delete;
+  Material &operator=(const Material &other) = delete;
 
   void bind();
   void unbind();
@@ -24,8 +27,15 @@ public:
   void setMat4(const std::string &name, const glm::mat4 &value);
 
   void setTexture(const std::string &name, std::shared_ptr<Texture> texture);
+  std::shared_ptr<Texture> getTexture(const std::string &name) const;
+
+  // Forwards the on-screen size of a surface using this material to its
+  // textures, so the streamer knows which mips are needed.
+  void requestTextureDetail(float screenPixels);
 
   std::shared_ptr<Shader> getShader() const { return m_shader; }
+  // Slot in the MaterialTable, or -1 when textures are bound per draw.
+  int getTableIndex() const { return m_tableIndex; }
 
   void setTransparent(bool isTransparent) { m_isTransparent = isTransparent; }
   bool isTransparent() const { return m_isTransparent; }
@@ -34,6 +44,7 @@ private:
   std::shared_ptr<Shader> m_shader;
 
   bool m_isTransparent = false;
+  int m_tableIndex = -1;
 
   std::unordered_map<std::string, float> m_uniformsFloat;
   std::unordered_map<std::string, int> m_uniformsInt;
@@ -0,0 +1,148 @@
+#include "Graphics/MaterialTable.hpp"
+#include "Core/Log.hpp"
+#include "Graphics/GLCapabilities.hpp"
+#include "Graphics/Material.hpp"
+#include "Graphics/TextureArrayPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <glad/glad.h>
+
+namespace {
+
+const char *modeName(TextureBindingMode mode) {
+  switch (mode) {
+  case TextureBindingMode::Arrays:
+    return "Texture Arrays";
+  case TextureBindingMode::Bindless:
+    return "Bindless";
+  default:
+    return "Classic";
+  }
+}
+
+glm::uvec4 resolveTexture(TextureBindingMode mode,
+                          const std::shared_ptr<Texture> &texture) {
+  if (!texture)
+    return glm::uvec4(0);
+
+  if (mode == TextureBindingMode::Bindless) {
+    uint64_t handle = texture->getBindlessHandle();
+    if (handle == 0)
+      return glm::uvec4(0);
+    return glm::uvec4(static_cast<uint32_t>(handle),
+                      static_cast<uint32_t>(handle >> 32), 1, 0);
+  }
+
+  if (!TextureArrayPool::get().add(*texture))
+    return glm::uvec4(0);
+  return glm::uvec4(texture->getArrayIndex(), texture->getArrayLayer(), 1, 0);
+}
+
+} // namespace
+
+void MaterialTable::init(TextureBindingMode mode) {
+  if (mode == TextureBindingMode::Auto)
+    mode = GLCapabilities::supportsBindlessTextures()
+               ? TextureBindingMode::Bindless
+               : TextureBindingMode::Arrays;
+
+  if (mode == TextureBindingMode::Bindless &&
+      !GLCapabilities::supportsBindlessTextures()) {
+    LOG_CORE_WARN("MaterialTable: bindless textures unsupported, using "
+                  "texture arrays");
+    mode = TextureBindingMode::Arrays;
+  }
+
+  m_mode = mode;
+  LOG_CORE_INFO("Texture binding: {0}", modeName(m_mode));
+}
+
+void MaterialTable::shutdown() {
+  glDeleteBuffers(1, &m_buffer);
+  m_buffer = 0;
+  m_bufferCapacity = 0;
+  m_materials.clear();
+  m_freeSlots.clear();
+  m_entries.clear();
+  TextureArrayPool::get().shutdown();
+}
+
+std::vector<std::string> MaterialTable::getShaderDefines() const {
+  switch (m_mode) {
+  case TextureBindingMode::Arrays:
+    return {"ARRAY_TEXTURES"};
+  case TextureBindingMode::Bindless:
+    return {"BINDLESS_TEXTURES"};
+  default:
+    return {};
+  }
+}
+
+int MaterialTable::allocate(Material *material) {
+  if (!isEnabled())
+    return -1;
+
+  if (!m_freeSlots.empty()) {
+    int index = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    m_materials[index] = material;
+    return index;
+  }
+
+  m_materials.push_back(material);
+  return static_cast<int>(m_materials.size() - 1);
+}
+
+void MaterialTable::release(int index) {
+  if (index < 0 || index >= static_cast<int>(m_materials.size()))
+    return;
+  m_materials[index] = nullptr;
+  m_freeSlots.push_back(index);
+}
+
+void MaterialTable::update() {
+  if (!isEnabled() || m_materials.empty())
+    return;
+
+  bool dirty = m_entries.size() != m_materials.size();
+  m_entries.resize(m_materials.size());
+
+  for (size_t i = 0; i < m_materials.size(); i++) {
+    MaterialGPUData entry{glm::uvec4(0), glm::uvec4(0)};
+    if (Material *material = m_materials[i]) {
+      entry.diffuse =
+          resolveTexture(m_mode, material->getTexture("texture_diffuse"));
+      entry.specular =
+          resolveTexture(m_mode, material->getTexture("texture_specular"));
+    }
+
+    if (std::memcmp(&entry, &m_entries[i], sizeof(MaterialGPUData)) != 0) {
+      m_entries[i] = entry;
+      dirty = true;
+    }
+  }
+
+  if (!dirty)
+    return;
+
+  if (m_entries.size() > m_bufferCapacity) {
+    m_bufferCapacity = std::max<size_t>(64, m_entries.size() * 2);
+    glDeleteBuffers(1, &m_buffer);
+    glCreateBuffers(1, &m_buffer);
+    glNamedBufferStorage(m_buffer, m_bufferCapacity * sizeof(MaterialGPUData),
+                         nullptr, GL_DYNAMIC_STORAGE_BIT);
+  }
+
+  glNamedBufferSubData(m_buffer, 0, m_entries.size() * sizeof(MaterialGPUData),
+                       m_entries.data());
+}
+
+void MaterialTable::bind() const {
+  if (!isEnabled() || m_buffer == 0)
+    return;
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, m_buffer);
+  if (m_mode == TextureBindingMode::Arrays)
+    TextureArrayPool::get().bind(0);
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+class Material;
+
+// std430 layout of one entry in the material SSBO. Each texture reference
+// is .xy = bindless handle (lo, hi) or array index + layer, .z = present.
+struct MaterialGPUData {
+  glm::uvec4 diffuse;
+  glm::uvec4 specular;
+};
+
+// Shared storage buffer that lets the fragment shader look up a material's
+// textures by index, so draws only change a single uniform instead of
+// rebinding texture units.
+class MaterialTable {
+public:
+  static MaterialTable &get() {
+    static MaterialTable instance;
+    return instance;
+  }
+
+  static constexpr unsigned int BINDING = 0;
+
+  // Resolves Auto against the driver's capabilities.
+  void init(TextureBindingMode mode);
+  void shutdown();
+
+  TextureBindingMode getMode() const { return m_mode; }
+  bool isEnabled() const { return m_mode != TextureBindingMode::Classic; }
+  std::vector<std::string> getShaderDefines() const;
+
+  // Returns -1 in Classic mode.
+  int allocate(Material *material);
+  void release(int index);
+
+  // Re-resolves every material's textures and uploads the buffer if anything
+  // changed (new materials, streamed textures with new handles, ...).
+  void update();
+  void bind() const;
+
+private:
+  MaterialTable() = default;
+
+  TextureBindingMode m_mode = TextureBindingMode::Classic;
+
+  std::vector<Material *> m_materials;
+  std::vector<int> m_freeSlots;
+  std::vector<MaterialGPUData> m_entries;
+
+  unsigned int m_buffer = 0;
+  size_t m_bufferCapacity = 0;
+};
\ No newline at end of file
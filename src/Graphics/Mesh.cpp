@@ -3,15 +3,43 @@
 #include <glad/glad.h>
 
 Mesh::Mesh(const std::vector<Vertex> &vertices,
-           const std::vector<unsigned int> &indices) {
+           const std::vector<unsigned int> &indices,
+           const std::vector<Meshlet> &meshlets) {
   MeshRange range = GeometryManager::get().upload(vertices, indices);
+  if (!meshlets.empty() && range.indexCount > 0)
+    GeometryManager::get().addMeshlets(range, meshlets);
 
   m_baseVertex = range.vertexOffset;
   m_indexOffset = range.indexOffset;
   m_indexCount = range.indexCount;
+  m_vertexCount = range.vertexCount;
+  m_indexType = range.indexType;
+  m_meshletOffset = range.meshletOffset;
+  m_meshletCount = range.meshletCount;
+
+  if (!vertices.empty()) {
+    m_bounds.min = m_bounds.max = vertices[0].Position;
+    for (const auto &v : vertices) {
+      m_bounds.min = glm::min(m_bounds.min, v.Position);
+      m_bounds.max = glm::max(m_bounds.max, v.Position);
+    }
+  }
+}
+
+Mesh::Mesh(const MeshRange &range, const BoundingBox &bounds)
+    : m_baseVertex(range.vertexOffset), m_indexOffset(range.indexOffset),
+      m_indexCount(range.indexCount), m_vertexCount(range.vertexCount),
+      m_indexType(range.indexType), m_meshletOffset(range.meshletOffset),
+      m_meshletCount(range.meshletCount), m_bounds(bounds) {}
+
+Mesh::~Mesh() { GeometryManager::get().free(getRange()); }
+
+void Mesh::drawGeometry(uint32_t object) const {
+  glDrawElementsInstancedBaseVertexBaseInstance(
+      GL_TRIANGLES, m_indexCount, toGLIndexType(m_indexType),
+      (void *)(uintptr_t)m_indexOffset, 1, m_baseVertex, object);
 }
 
-void Mesh::drawGeometry() const {
-  glDrawElementsBaseVertex(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT,
-                           (void *)(uintptr_t)m_indexOffset, m_baseVertex);
+unsigned int Mesh::toGLIndexType(IndexType type) {
+  return type == IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 }
\ No newline at end of file
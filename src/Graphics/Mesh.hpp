@@ -1,8 +1,35 @@
 #pragma once
 
+#include "Graphics/BoundingBox.hpp"
+#include "Graphics/Meshlet.hpp"
+
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <memory>
 #include <vector>
 
+struct OccluderMesh;
+
+// Meshes addressing few enough vertices store 16-bit indices, halving their
+// index memory and bandwidth.
+enum class IndexType { UInt32 = 0, UInt16 };
+
+inline size_t getIndexSize(IndexType type) {
+  return type == IndexType::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+struct MeshRange {
+  unsigned int vertexOffset;
+  // Byte offset into the global buffer.
+  unsigned int indexOffset;
+  unsigned int indexCount;
+  unsigned int vertexCount;
+  IndexType indexType;
+  // Into the GeometryManager's meshlet pool; no meshlets when zero.
+  unsigned int meshletOffset;
+  unsigned int meshletCount;
+};
+
 struct Vertex {
   glm::vec3 Position;
   glm::vec3 Normal;
@@ -11,14 +38,47 @@ struct Vertex {
 
 class Mesh {
 public:
+  // `meshlets` come from Meshlet::build() over these indices.
   Mesh(const std::vector<Vertex> &vertices,
-       const std::vector<unsigned int> &indices);
-  ~Mesh() = default;
+       const std::vector<unsigned int> &indices,
+       const std::vector<Meshlet> &meshlets = {});
+  // Wraps geometry a loader already placed in the GeometryManager.
+  Mesh(const MeshRange &range, const BoundingBox &bounds);
+  // Returns the geometry to the GeometryManager.
+  ~Mesh();
+
+  Mesh(const Mesh &) = delete;
+  Mesh &operator=(const Mesh &) = delete;
+
+  // `object` is the draw's ObjectBuffer index, seen as gl_BaseInstance.
+  void drawGeometry(uint32_t object) const;
 
-  void drawGeometry() const;
+  const BoundingBox &getBounds() const { return m_bounds; }
+  MeshRange getRange() const {
+    return {m_baseVertex, m_indexOffset, m_indexCount, m_vertexCount,
+            m_indexType, m_meshletOffset, m_meshletCount};
+  }
+  IndexType getIndexType() const { return m_indexType; }
+  unsigned int getMeshletCount() const { return m_meshletCount; }
+  // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+  static unsigned int toGLIndexType(IndexType type);
+
+  void setOccluder(std::shared_ptr<const OccluderMesh> occluder) {
+    m_occluder = std::move(occluder);
+  }
+  const std::shared_ptr<const OccluderMesh> &getOccluder() const {
+    return m_occluder;
+  }
 
 private:
   unsigned int m_baseVertex;
   unsigned int m_indexOffset;
   unsigned int m_indexCount;
+  unsigned int m_vertexCount;
+  IndexType m_indexType;
+  unsigned int m_meshletOffset;
+  unsigned int m_meshletCount;
+
+  BoundingBox m_bounds;
+  std::shared_ptr<const OccluderMesh> m_occluder;
 };
\ No newline at end of file
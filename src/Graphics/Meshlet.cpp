@@ -0,0 +1,186 @@
+#include "Graphics/Meshlet.hpp"
+#include "Graphics/Mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t NONE = ~0u;
+
+Meshlet computeBounds(const std::vector<Vertex> &vertices,
+                      const std::vector<unsigned int> &indices,
+                      const std::vector<uint32_t> &clusterVertices,
+                      size_t firstIndex, size_t indexCount) {
+  Meshlet meshlet;
+  meshlet.firstIndex = static_cast<uint32_t>(firstIndex);
+  meshlet.indexCount = static_cast<uint32_t>(indexCount);
+
+  glm::vec3 min = vertices[clusterVertices[0]].Position;
+  glm::vec3 max = min;
+  for (uint32_t v : clusterVertices) {
+    min = glm::min(min, vertices[v].Position);
+    max = glm::max(max, vertices[v].Position);
+  }
+  meshlet.center = (min + max) * 0.5f;
+  float radiusSq = 0.0f;
+  for (uint32_t v : clusterVertices) {
+    const glm::vec3 d = vertices[v].Position - meshlet.center;
+    radiusSq = std::max(radiusSq, glm::dot(d, d));
+  }
+  meshlet.radius = std::sqrt(radiusSq);
+
+  // Winding decides which side is the front, so the cone is built from the
+  // geometric normals rather than the shading ones.
+  std::vector<glm::vec3> normals;
+  normals.reserve(indexCount / 3);
+  glm::vec3 sum(0.0f);
+  for (size_t i = firstIndex; i + 2 < firstIndex + indexCount; i += 3) {
+    const glm::vec3 &a = vertices[indices[i]].Position;
+    const glm::vec3 normal = glm::cross(vertices[indices[i + 1]].Position - a,
+                                        vertices[indices[i + 2]].Position - a);
+    const float length = glm::length(normal);
+    if (length <= 0.0f)
+      continue;
+    normals.push_back(normal / length);
+    sum += normals.back();
+  }
+
+  meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+  meshlet.coneCutoff = 1.0f;
+  const float sumLength = glm::length(sum);
+  if (normals.empty() || sumLength <= 0.0f)
+    return meshlet;
+
+  const glm::vec3 axis = sum / sumLength;
+  float minDot = 1.0f;
+  for (const glm::vec3 &normal : normals)
+    minDot = std::min(minDot, glm::dot(axis, normal));
+  // A cone of 90 degrees or more always has some triangle facing the viewer.
+  if (minDot <= 0.0f)
+    return meshlet;
+  meshlet.coneAxis = axis;
+  meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+  return meshlet;
+}
+
+} // namespace
+
+bool Meshlet::isBackfacing(const glm::vec3 &viewPos) const {
+  if (coneCutoff >= 1.0f)
+    return false;
+  // Every direction from the viewer into the sphere must be within 90
+  // degrees minus the cone's half-angle of the axis.
+  const glm::vec3 d = center - viewPos;
+  return glm::dot(d, coneAxis) >=
+         coneCutoff * (glm::length(d) + radius) + radius;
+}
+
+std::vector<Meshlet> Meshlet::build(const std::vector<Vertex> &vertices,
+                                    std::vector<unsigned int> &indices) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount < MIN_MESH_TRIANGLES)
+    return {};
+
+  // Vertex -> triangle adjacency.
+  std::vector<uint32_t> offsets(vertices.size() + 1, 0);
+  for (size_t i = 0; i < triangleCount * 3; i++)
+    offsets[indices[i] + 1]++;
+  for (size_t v = 0; v < vertices.size(); v++)
+    offsets[v + 1] += offsets[v];
+  std::vector<uint32_t> adjacency(triangleCount * 3);
+  {
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+      adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+  }
+
+  std::vector<char> emitted(triangleCount, 0);
+  // Which cluster last used each vertex.
+  std::vector<uint32_t> owner(vertices.size(), NONE);
+  std::vector<uint32_t> clusterVertices;
+  std::vector<uint32_t> clusterTriangles;
+  uint32_t cluster = 0;
+
+  std::vector<unsigned int> reordered;
+  reordered.reserve(triangleCount * 3);
+  std::vector<Meshlet> meshlets;
+  meshlets.reserve(triangleCount / (MAX_TRIANGLES / 2) + 1);
+
+  auto newVertices = [&](uint32_t t) {
+    const unsigned int a = indices[t * 3], b = indices[t * 3 + 1],
+                       c = indices[t * 3 + 2];
+    return (owner[a] != cluster) + (owner[b] != cluster && b != a) +
+           (owner[c] != cluster && c != a && c != b);
+  };
+
+  // Best unemitted neighbour of vertex `v`: fewest new vertices.
+  auto consider = [&](unsigned int v, uint32_t &best, int &bestNew) {
+    for (uint32_t a = offsets[v]; a < offsets[v + 1] && bestNew > 0; a++) {
+      const uint32_t t = adjacency[a];
+      if (emitted[t])
+        continue;
+      const int added = newVertices(t);
+      if (added < bestNew) {
+        best = t;
+        bestNew = added;
+      }
+    }
+  };
+
+  auto finish = [&]() {
+    const size_t firstIndex = reordered.size();
+    for (uint32_t t : clusterTriangles)
+      reordered.insert(reordered.end(), indices.begin() + t * 3,
+                       indices.begin() + t * 3 + 3);
+    meshlets.push_back(computeBounds(vertices, reordered, clusterVertices,
+                                     firstIndex, clusterTriangles.size() * 3));
+    clusterVertices.clear();
+    clusterTriangles.clear();
+    cluster++;
+  };
+
+  size_t seed = 0;
+  uint32_t last = NONE;
+  while (true) {
+    uint32_t best = NONE;
+    int bestNew = 4;
+    // Neighbours of the last triangle keep the cluster compact; when they
+    // run out, any neighbour of the cluster will do.
+    if (last != NONE) {
+      for (int k = 0; k < 3; k++)
+        consider(indices[last * 3 + k], best, bestNew);
+      for (size_t i = 0; best == NONE && i < clusterVertices.size(); i++)
+        consider(clusterVertices[i], best, bestNew);
+    }
+    if (best == NONE) {
+      if (!clusterTriangles.empty())
+        finish();
+      while (seed < triangleCount && emitted[seed])
+        seed++;
+      if (seed == triangleCount)
+        break;
+      best = static_cast<uint32_t>(seed);
+    } else if (clusterVertices.size() + bestNew > MAX_VERTICES ||
+               clusterTriangles.size() == MAX_TRIANGLES) {
+      finish();
+    }
+
+    emitted[best] = 1;
+    clusterTriangles.push_back(best);
+    for (int k = 0; k < 3; k++) {
+      const unsigned int v = indices[best * 3 + k];
+      if (owner[v] != cluster) {
+        owner[v] = cluster;
+        clusterVertices.push_back(v);
+      }
+    }
+    last = best;
+  }
+
+  // A trailing partial triangle is not drawn, but is kept in place.
+  reordered.insert(reordered.end(), indices.begin() + triangleCount * 3,
+                   indices.end());
+  indices.swap(reordered);
+  return meshlets;
+}
\ No newline at end of file
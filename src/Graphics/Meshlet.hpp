@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Vertex;
+
+// A cluster of neighbouring triangles whose indices are contiguous in the
+// mesh's index range. Its bounding sphere and normal cone let the renderer
+// skip clusters of a large mesh that are outside the view, clipped away or
+// facing away from the camera, instead of drawing the whole mesh.
+struct Meshlet {
+  static constexpr size_t MAX_VERTICES = 64;
+  static constexpr size_t MAX_TRIANGLES = 124;
+  // Smaller meshes are only culled as a whole.
+  static constexpr size_t MIN_MESH_TRIANGLES = 8192;
+
+  glm::vec3 center;
+  float radius;
+  // Every triangle normal is within the cone around `coneAxis`; the cutoff
+  // is the sine of its half-angle, 1 for clusters that never face away as
+  // a whole.
+  glm::vec3 coneAxis;
+  float coneCutoff;
+  // In indices, from the start of the mesh's index range.
+  uint32_t firstIndex;
+  uint32_t indexCount;
+
+  // True when no triangle of the cluster can face `viewPos`, given in the
+  // mesh's space.
+  bool isBackfacing(const glm::vec3 &viewPos) const;
+
+  // Grows clusters triangle by triangle across shared vertices, reordering
+  // `indices` so each one is contiguous. Returns nothing for meshes below
+  // MIN_MESH_TRIANGLES, leaving `indices` untouched.
+  static std::vector<Meshlet> build(const std::vector<Vertex> &vertices,
+                                    std::vector<unsigned int> &indices);
+};
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "Graphics/MeshletCuller.hpp"
+#include "Core/JobSystem.hpp"
+#include "Graphics/GeometryManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <glad/glad.h>
+
+MeshletCuller::~MeshletCuller() { glDeleteBuffers(1, &m_commandBuffer); }
+
+void MeshletCuller::begin() { m_instances.clear(); }
+
+size_t MeshletCuller::add(const Mesh &mesh, uint32_t object,
+                          const glm::mat4 &model) {
+  Instance instance{};
+  instance.range = mesh.getRange();
+  instance.model = model;
+  instance.object = object;
+  m_instances.push_back(instance);
+  return m_instances.size() - 1;
+}
+
+void MeshletCuller::cull(const glm::mat4 &viewProjection,
+                         const glm::vec3 &viewPos, const glm::vec4 *planes,
+                         int planeCount, bool cullBackfaces) {
+  auto start = std::chrono::steady_clock::now();
+
+  planeCount = std::min(planeCount, MAX_PLANES);
+  m_meshletCount = 0;
+  size_t rangeCount = 0;
+  for (Instance &instance : m_instances) {
+    // The planes move into the mesh's space, where the meshlet spheres are.
+    // Renormalized there, the sphere tests stay exact under any scale.
+    instance.frustum = Frustum::fromMatrix(viewProjection * instance.model);
+    const glm::mat4 toMesh = glm::transpose(instance.model);
+    for (int p = 0; p < planeCount; p++) {
+      const glm::vec4 plane = toMesh * planes[p];
+      const float length = glm::length(glm::vec3(plane));
+      instance.planes[p] = length > 0.0f ? plane / length : plane;
+    }
+    instance.planeCount = planeCount;
+    instance.viewPos = glm::vec3(glm::inverse(instance.model) *
+                                 glm::vec4(viewPos, 1.0f));
+    // Which side of a triangle faces the viewer survives any transform
+    // that does not mirror.
+    instance.cullBackfaces =
+        cullBackfaces && glm::determinant(glm::mat3(instance.model)) > 0.0f;
+
+    m_meshletCount += instance.range.meshletCount;
+    rangeCount += (instance.range.meshletCount + RANGE_SIZE - 1) / RANGE_SIZE;
+  }
+
+  m_ranges.resize(rangeCount);
+  size_t r = 0;
+  for (size_t i = 0; i < m_instances.size(); i++) {
+    const uint32_t count = m_instances[i].range.meshletCount;
+    for (uint32_t begin = 0; begin < count; begin += RANGE_SIZE) {
+      Range &range = m_ranges[r++];
+      range.instance = i;
+      range.begin = begin;
+      range.end = std::min(begin + RANGE_SIZE, count);
+    }
+  }
+
+  const GeometryManager &geometry = GeometryManager::get();
+  JobSystem::get().parallelFor(m_ranges.size(), [&](size_t begin,
+                                                    size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      Range &range = m_ranges[i];
+      cullRange(range,
+                geometry.getMeshlets(m_instances[range.instance].range));
+    }
+  });
+
+  // Ranges of one instance are adjacent, and so are their commands.
+  m_commands.clear();
+  m_visibleCount = 0;
+  for (Instance &instance : m_instances) {
+    instance.firstCommand = 0;
+    instance.commandCount = 0;
+  }
+  for (const Range &range : m_ranges) {
+    Instance &instance = m_instances[range.instance];
+    if (instance.commandCount == 0)
+      instance.firstCommand = m_commands.size();
+    m_commands.insert(m_commands.end(), range.commands.begin(),
+                      range.commands.end());
+    instance.commandCount += range.commands.size();
+    m_visibleCount += range.visible;
+  }
+  upload();
+
+  m_milliseconds = std::chrono::duration<float, std::milli>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+}
+
+void MeshletCuller::cullRange(Range &range, const Meshlet *meshlets) const {
+  const Instance &instance = m_instances[range.instance];
+  const MeshRange &mesh = instance.range;
+  const uint32_t firstIndex = static_cast<uint32_t>(
+      mesh.indexOffset / getIndexSize(mesh.indexType));
+
+  range.commands.clear();
+  range.visible = 0;
+  for (uint32_t m = range.begin; m < range.end; m++) {
+    const Meshlet &meshlet = meshlets[m];
+    if (!instance.frustum.intersectsSphere(meshlet.center, meshlet.radius))
+      continue;
+    bool clipped = false;
+    for (int p = 0; p < instance.planeCount && !clipped; p++) {
+      const glm::vec4 &plane = instance.planes[p];
+      clipped = glm::dot(glm::vec3(plane), meshlet.center) + plane.w <
+                -meshlet.radius;
+    }
+    if (clipped ||
+        (instance.cullBackfaces && meshlet.isBackfacing(instance.viewPos)))
+      continue;
+    range.visible++;
+
+    // Meshlets follow each other in the index buffer, so a run of visible
+    // ones is a single draw.
+    const uint32_t first = firstIndex + meshlet.firstIndex;
+    if (!range.commands.empty()) {
+      DrawCommand &previous = range.commands.back();
+      if (previous.firstIndex + previous.count == first) {
+        previous.count += meshlet.indexCount;
+        continue;
+      }
+    }
+    range.commands.push_back({meshlet.indexCount, 1, first,
+                              static_cast<int32_t>(mesh.vertexOffset),
+                              instance.object});
+  }
+}
+
+void MeshletCuller::upload() {
+  if (m_commands.size() > m_commandCapacity || m_commandBuffer == 0) {
+    m_commandCapacity = std::max<size_t>(256, m_commands.size() * 2);
+    glDeleteBuffers(1, &m_commandBuffer);
+    glCreateBuffers(1, &m_commandBuffer);
+    glNamedBufferStorage(m_commandBuffer,
+                         m_commandCapacity * sizeof(DrawCommand), nullptr,
+                         GL_DYNAMIC_STORAGE_BIT);
+  }
+  if (!m_commands.empty())
+    glNamedBufferSubData(m_commandBuffer, 0,
+                         m_commands.size() * sizeof(DrawCommand),
+                         m_commands.data());
+}
+
+void MeshletCuller::draw(size_t instance) const {
+  const Instance &drawn = m_instances[instance];
+  if (drawn.commandCount == 0)
+    return;
+
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+  glMultiDrawElementsIndirect(
+      GL_TRIANGLES, Mesh::toGLIndexType(drawn.range.indexType),
+      reinterpret_cast<const void *>(drawn.firstCommand * sizeof(DrawCommand)),
+      static_cast<GLsizei>(drawn.commandCount), 0);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Graphics/Frustum.hpp"
+#include "Graphics/Mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Cluster-level visibility for meshes that carry meshlets. Every frame each
+// queued instance's meshlets are tested on the job system against the
+// frustum, the clipping planes and, optionally, their normal cones; the
+// survivors (runs of adjacent ones merged) become indirect draw commands,
+// so drawing a huge mesh costs what its visible clusters cost.
+class MeshletCuller {
+public:
+  MeshletCuller() = default;
+  ~MeshletCuller();
+
+  MeshletCuller(const MeshletCuller &) = delete;
+  MeshletCuller &operator=(const MeshletCuller &) = delete;
+
+  void begin();
+  // `object` is the instance's ObjectBuffer index. Returns the instance
+  // handle for draw().
+  size_t add(const Mesh &mesh, uint32_t object, const glm::mat4 &model);
+  // Planes are in world space. Backfacing clusters are only dropped with
+  // `cullBackfaces`, as the renderer draws two-sided otherwise.
+  void cull(const glm::mat4 &viewProjection, const glm::vec3 &viewPos,
+            const glm::vec4 *planes, int planeCount, bool cullBackfaces);
+  // Issues one instance's surviving clusters with whatever program is
+  // bound.
+  void draw(size_t instance) const;
+
+  size_t getMeshletCount() const { return m_meshletCount; }
+  size_t getVisibleCount() const { return m_visibleCount; }
+  size_t getCommandCount() const { return m_commands.size(); }
+  float getMilliseconds() const { return m_milliseconds; }
+
+private:
+  static constexpr int MAX_PLANES = 8;
+  static constexpr uint32_t RANGE_SIZE = 2048;
+
+  // Matches DrawElementsIndirectCommand in the GL spec.
+  struct DrawCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+  };
+
+  struct Instance {
+    MeshRange range;
+    glm::mat4 model;
+    uint32_t object;
+
+    // Culling state, in the mesh's space.
+    Frustum frustum;
+    glm::vec4 planes[MAX_PLANES];
+    int planeCount;
+    glm::vec3 viewPos;
+    bool cullBackfaces;
+
+    size_t firstCommand;
+    size_t commandCount;
+  };
+
+  // A slice of one instance's meshlets, culled by one job.
+  struct Range {
+    size_t instance;
+    uint32_t begin;
+    uint32_t end;
+    std::vector<DrawCommand> commands;
+    size_t visible;
+  };
+
+  std::vector<Instance> m_instances;
+  std::vector<Range> m_ranges;
+  std::vector<DrawCommand> m_commands;
+
+  unsigned int m_commandBuffer = 0;
+  size_t m_commandCapacity = 0;
+
+  size_t m_meshletCount = 0;
+  size_t m_visibleCount = 0;
+  float m_milliseconds = 0.0f;
+
+  void cullRange(Range &range, const Meshlet *meshlets) const;
+  void upload();
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "Graphics/ObjectBuffer.hpp"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+static_assert(sizeof(ObjectData) == 176,
+              "ObjectData must match the std430 layout");
+
+ObjectBuffer::~ObjectBuffer() { glDeleteBuffers(1, &m_buffer); }
+
+void ObjectBuffer::upload(const std::vector<ObjectData> &objects) {
+  if (objects.empty())
+    return;
+
+  if (objects.size() > m_capacity) {
+    m_capacity = std::max<size_t>(256, objects.size() * 2);
+    glDeleteBuffers(1, &m_buffer);
+    glCreateBuffers(1, &m_buffer);
+    glNamedBufferStorage(m_buffer, m_capacity * sizeof(ObjectData), nullptr,
+                         GL_DYNAMIC_STORAGE_BIT);
+  }
+  glNamedBufferSubData(m_buffer, 0, objects.size() * sizeof(ObjectData),
+                       objects.data());
+}
+
+void ObjectBuffer::bind() const {
+  if (m_buffer != 0)
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, m_buffer);
+}
\ No newline at end of file
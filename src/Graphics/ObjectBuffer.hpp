@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// std430 layout of one entry in the object buffer (objects.glsl). Every draw
+// reaches its transform and material through gl_BaseInstance, so nothing
+// per-object is set as a uniform.
+struct ObjectData {
+  glm::mat4 model;
+  // Inverse-transpose of the model's upper 3x3, one padded column per vec4.
+  glm::vec4 normalMatrix[3];
+  glm::vec4 boundsMin;
+  glm::vec4 boundsMax;
+  uint32_t indexCount;
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  int32_t materialIndex;
+  // GPU-driven objects only: first command slot of their batch, and the
+  // batch itself.
+  uint32_t commandOffset;
+  uint32_t batch;
+  uint32_t padding[2];
+};
+
+// Storage buffer holding one frame's ObjectData, bound once for all passes.
+class ObjectBuffer {
+public:
+  static constexpr unsigned int BINDING = 1;
+
+  ObjectBuffer() = default;
+  ~ObjectBuffer();
+
+  ObjectBuffer(const ObjectBuffer &) = delete;
+  ObjectBuffer &operator=(const ObjectBuffer &) = delete;
+
+  void upload(const std::vector<ObjectData> &objects);
+  void bind() const;
+
+private:
+  unsigned int m_buffer = 0;
+  size_t m_capacity = 0;
+};
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "Graphics/OccluderMesh.hpp"
+#include "Graphics/Mesh.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+namespace {
+
+glm::vec3 readPosition(const unsigned char *base, size_t stride, size_t i) {
+  glm::vec3 p;
+  std::memcpy(&p, base + i * stride, sizeof(p));
+  return p;
+}
+
+uint32_t readIndex(const unsigned char *base, size_t size, size_t i) {
+  switch (size) {
+  case 0:
+    return static_cast<uint32_t>(i);
+  case 1:
+    return base[i];
+  case 2: {
+    uint16_t value;
+    std::memcpy(&value, base + i * 2, sizeof(value));
+    return value;
+  }
+  default: {
+    uint32_t value;
+    std::memcpy(&value, base + i * 4, sizeof(value));
+    return value;
+  }
+  }
+}
+
+float triangleArea(const glm::vec3 &a, const glm::vec3 &b,
+                   const glm::vec3 &c) {
+  return glm::length(glm::cross(b - a, c - a));
+}
+
+} // namespace
+
+std::shared_ptr<const OccluderMesh>
+OccluderMesh::build(const void *positions, size_t positionStride,
+                    size_t vertexCount, const void *indices, size_t indexSize,
+                    size_t indexCount) {
+  const auto *positionBytes = static_cast<const unsigned char *>(positions);
+  const auto *indexBytes = static_cast<const unsigned char *>(indices);
+  if (indexSize == 0)
+    indexCount = vertexCount;
+  if (!positionBytes || vertexCount == 0 || indexCount < 3)
+    return nullptr;
+
+  auto mesh = std::make_shared<OccluderMesh>();
+  if (indexCount / 3 <= MAX_TRIANGLES) {
+    mesh->positions.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++)
+      mesh->positions[i] = readPosition(positionBytes, positionStride, i);
+    mesh->indices.resize(indexCount - indexCount % 3);
+    for (size_t i = 0; i < mesh->indices.size(); i++)
+      mesh->indices[i] = readIndex(indexBytes, indexSize, i);
+  } else {
+    // Merging or moving vertices could push the surface past the real
+    // silhouette, so the largest triangles are kept as they are instead.
+    std::vector<std::pair<float, size_t>> triangles;
+    triangles.reserve(indexCount / 3);
+    for (size_t t = 0; t + 2 < indexCount; t += 3) {
+      uint32_t a = readIndex(indexBytes, indexSize, t);
+      uint32_t b = readIndex(indexBytes, indexSize, t + 1);
+      uint32_t c = readIndex(indexBytes, indexSize, t + 2);
+      if (a >= vertexCount || b >= vertexCount || c >= vertexCount)
+        continue;
+      float area =
+          triangleArea(readPosition(positionBytes, positionStride, a),
+                       readPosition(positionBytes, positionStride, b),
+                       readPosition(positionBytes, positionStride, c));
+      if (area > 0.0f)
+        triangles.push_back({area, t});
+    }
+    const size_t kept = std::min(triangles.size(), MAX_TRIANGLES);
+    std::nth_element(triangles.begin(), triangles.begin() + kept,
+                     triangles.end(), std::greater<>());
+    triangles.resize(kept);
+    // Back in index order, which keeps neighbouring vertices together.
+    std::sort(triangles.begin(), triangles.end(),
+              [](const auto &x, const auto &y) { return x.second < y.second; });
+
+    std::unordered_map<uint32_t, uint32_t> remap;
+    mesh->indices.reserve(kept * 3);
+    for (const auto &triangle : triangles) {
+      for (size_t k = 0; k < 3; k++) {
+        uint32_t index = readIndex(indexBytes, indexSize, triangle.second + k);
+        auto [it, inserted] = remap.emplace(
+            index, static_cast<uint32_t>(mesh->positions.size()));
+        if (inserted)
+          mesh->positions.push_back(
+              readPosition(positionBytes, positionStride, index));
+        mesh->indices.push_back(it->second);
+      }
+    }
+  }
+
+  if (mesh->indices.empty())
+    return nullptr;
+  return mesh;
+}
+
+std::shared_ptr<const OccluderMesh>
+OccluderMesh::build(const std::vector<Vertex> &vertices,
+                    const std::vector<unsigned int> &indices) {
+  if (vertices.empty())
+    return nullptr;
+  return build(&vertices[0].Position, sizeof(Vertex), vertices.size(),
+               indices.data(), sizeof(unsigned int), indices.size());
+}
\ No newline at end of file
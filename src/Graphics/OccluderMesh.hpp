@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct Vertex;
+
+// Low-poly CPU copy of a mesh for the software occlusion culler, built on
+// the import thread. Meshes over the budget keep only their largest
+// triangles, unmoved: a subset of the surface can hide less than the mesh
+// but never more, so nothing visible is culled.
+struct OccluderMesh {
+  static constexpr size_t MAX_TRIANGLES = 2048;
+
+  std::vector<glm::vec3> positions;
+  std::vector<uint32_t> indices;
+
+  size_t getTriangleCount() const { return indices.size() / 3; }
+
+  // `positionStride` is in bytes; `indexSize` is 1, 2 or 4, or 0 for
+  // non-indexed triangle lists. Returns nullptr for meshes with no
+  // triangles.
+  static std::shared_ptr<const OccluderMesh>
+  build(const void *positions, size_t positionStride, size_t vertexCount,
+        const void *indices, size_t indexSize, size_t indexCount);
+  static std::shared_ptr<const OccluderMesh>
+  build(const std::vector<Vertex> &vertices,
+        const std::vector<unsigned int> &indices);
+};
\ No newline at end of file
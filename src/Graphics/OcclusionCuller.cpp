@@ -0,0 +1,213 @@
+#include "Graphics/OcclusionCuller.hpp"
+#include "Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(OCCLUSION_CULLER_AVX2) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+
+bool cpuSupportsAVX2() {
+#if defined(OCCLUSION_CULLER_AVX2) && defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  const bool osxsave = info[2] & (1 << 27);
+  const bool avx = info[2] & (1 << 28);
+  __cpuidex(info, 7, 0);
+  const bool avx2 = info[1] & (1 << 5);
+  // The OS has to save the YMM registers too.
+  return osxsave && avx && avx2 && (_xgetbv(0) & 6) == 6;
+#elif defined(OCCLUSION_CULLER_AVX2)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+} // namespace
+
+void rasterizeOcclusionTileScalar(float *depth, int stride, int x0, int y0,
+                                  int x1, int y1,
+                                  const OcclusionTriangle *triangles,
+                                  const uint32_t *bin, size_t binSize) {
+  for (size_t i = 0; i < binSize; i++) {
+    const OcclusionTriangle &t = triangles[bin[i]];
+    const int xs = std::max(t.minX, x0), xe = std::min(t.maxX, x1 - 1);
+    const int ys = std::max(t.minY, y0), ye = std::min(t.maxY, y1 - 1);
+
+    for (int y = ys; y <= ye; y++) {
+      const float fy = y + 0.5f;
+      float *row = depth + y * stride;
+      for (int x = xs; x <= xe; x++) {
+        const float fx = x + 0.5f;
+        if (t.edgeA[0] * fx + t.edgeB[0] * fy + t.edgeC[0] < 0.0f ||
+            t.edgeA[1] * fx + t.edgeB[1] * fy + t.edgeC[1] < 0.0f ||
+            t.edgeA[2] * fx + t.edgeB[2] * fy + t.edgeC[2] < 0.0f)
+          continue;
+        float z = t.depth0 + t.depthDx * fx + t.depthDy * fy;
+        row[x] = std::min(row[x], z);
+      }
+    }
+  }
+}
+
+OcclusionCuller::OcclusionCuller()
+    : m_depth(WIDTH * HEIGHT, 1.0f), m_blockMaxDepth(BLOCKS_X * BLOCKS_Y, 1.0f),
+      m_raster(rasterizeOcclusionTileScalar) {
+#ifdef OCCLUSION_CULLER_AVX2
+  if (cpuSupportsAVX2())
+    m_raster = rasterizeOcclusionTileAVX2;
+#endif
+}
+
+void OcclusionCuller::begin(const glm::mat4 &viewProjection) {
+  m_viewProjection = viewProjection;
+  m_triangles.clear();
+  for (auto &bin : m_bins)
+    bin.clear();
+}
+
+void OcclusionCuller::addOccluder(const OccluderMesh &mesh,
+                                  const glm::mat4 &model) {
+  const glm::mat4 transform = m_viewProjection * model;
+  m_clipScratch.resize(mesh.positions.size());
+  for (size_t i = 0; i < mesh.positions.size(); i++)
+    m_clipScratch[i] = transform * glm::vec4(mesh.positions[i], 1.0f);
+
+  for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    setupTriangle(m_clipScratch[mesh.indices[i]],
+                  m_clipScratch[mesh.indices[i + 1]],
+                  m_clipScratch[mesh.indices[i + 2]]);
+}
+
+void OcclusionCuller::setupTriangle(const glm::vec4 &a, const glm::vec4 &b,
+                                    const glm::vec4 &c) {
+  // Triangles crossing the near plane are dropped instead of clipped:
+  // occluding less than possible is always safe.
+  if (a.z < -a.w || b.z < -b.w || c.z < -c.w || a.w <= 0.0f ||
+      b.w <= 0.0f || c.w <= 0.0f)
+    return;
+
+  auto toScreen = [](const glm::vec4 &p) {
+    glm::vec3 ndc = glm::vec3(p) / p.w;
+    return glm::vec3((ndc.x * 0.5f + 0.5f) * WIDTH,
+                     (ndc.y * 0.5f + 0.5f) * HEIGHT, ndc.z * 0.5f + 0.5f);
+  };
+  glm::vec3 v[3] = {toScreen(a), toScreen(b), toScreen(c)};
+
+  float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) -
+               (v[2].x - v[0].x) * (v[1].y - v[0].y);
+  if (std::abs(area) < 1e-6f)
+    return;
+  // Both windings are rasterized; occluders need not be closed meshes.
+  if (area < 0.0f) {
+    std::swap(v[1], v[2]);
+    area = -area;
+  }
+
+  OcclusionTriangle t;
+  t.minX = std::max(int(std::floor(std::min({v[0].x, v[1].x, v[2].x}))), 0);
+  t.minY = std::max(int(std::floor(std::min({v[0].y, v[1].y, v[2].y}))), 0);
+  t.maxX = std::min(int(std::ceil(std::max({v[0].x, v[1].x, v[2].x}))),
+                    WIDTH - 1);
+  t.maxY = std::min(int(std::ceil(std::max({v[0].y, v[1].y, v[2].y}))),
+                    HEIGHT - 1);
+  if (t.minX > t.maxX || t.minY > t.maxY)
+    return;
+
+  for (int e = 0; e < 3; e++) {
+    const glm::vec3 &p0 = v[e];
+    const glm::vec3 &p1 = v[(e + 1) % 3];
+    t.edgeA[e] = p0.y - p1.y;
+    t.edgeB[e] = p1.x - p0.x;
+    t.edgeC[e] = -t.edgeA[e] * p0.x - t.edgeB[e] * p0.y;
+  }
+
+  const glm::vec3 ab = v[1] - v[0];
+  const glm::vec3 ac = v[2] - v[0];
+  t.depthDx = (ab.z * ac.y - ac.z * ab.y) / area;
+  t.depthDy = (ac.z * ab.x - ab.z * ac.x) / area;
+  t.depth0 = v[0].z - t.depthDx * v[0].x - t.depthDy * v[0].y;
+
+  const uint32_t index = static_cast<uint32_t>(m_triangles.size());
+  m_triangles.push_back(t);
+  for (int ty = t.minY / TILE_SIZE; ty <= t.maxY / TILE_SIZE; ty++)
+    for (int tx = t.minX / TILE_SIZE; tx <= t.maxX / TILE_SIZE; tx++)
+      m_bins[ty * TILES_X + tx].push_back(index);
+}
+
+void OcclusionCuller::rasterize() {
+  JobSystem::get().parallelFor(TILES_X * TILES_Y, [this](size_t begin,
+                                                         size_t end) {
+    for (size_t tile = begin; tile < end; tile++) {
+      const int x0 = int(tile % TILES_X) * TILE_SIZE;
+      const int y0 = int(tile / TILES_X) * TILE_SIZE;
+
+      for (int y = y0; y < y0 + TILE_SIZE; y++)
+        std::fill_n(m_depth.begin() + y * WIDTH + x0, TILE_SIZE, 1.0f);
+
+      const auto &bin = m_bins[tile];
+      if (!bin.empty())
+        m_raster(m_depth.data(), WIDTH, x0, y0, x0 + TILE_SIZE,
+                 y0 + TILE_SIZE, m_triangles.data(), bin.data(), bin.size());
+
+      for (int by = y0 / BLOCK_SIZE; by < (y0 + TILE_SIZE) / BLOCK_SIZE;
+           by++) {
+        for (int bx = x0 / BLOCK_SIZE; bx < (x0 + TILE_SIZE) / BLOCK_SIZE;
+             bx++) {
+          float farthest = 0.0f;
+          for (int y = by * BLOCK_SIZE; y < (by + 1) * BLOCK_SIZE; y++) {
+            const float *row = &m_depth[y * WIDTH + bx * BLOCK_SIZE];
+            farthest = std::max(farthest, *std::max_element(
+                                              row, row + BLOCK_SIZE));
+          }
+          m_blockMaxDepth[by * BLOCKS_X + bx] = farthest;
+        }
+      }
+    }
+  });
+}
+
+bool OcclusionCuller::isVisible(const BoundingBox &worldBounds) const {
+  glm::vec3 ndcMin(1e30f), ndcMax(-1e30f);
+  for (int i = 0; i < 8; i++) {
+    glm::vec3 corner((i & 1) ? worldBounds.max.x : worldBounds.min.x,
+                     (i & 2) ? worldBounds.max.y : worldBounds.min.y,
+                     (i & 4) ? worldBounds.max.z : worldBounds.min.z);
+    glm::vec4 clip = m_viewProjection * glm::vec4(corner, 1.0f);
+    // Bounds reaching the near plane cover the eye; nothing hides them.
+    if (clip.w <= 0.0f || clip.z < -clip.w)
+      return true;
+    glm::vec3 ndc = glm::vec3(clip) / clip.w;
+    ndcMin = glm::min(ndcMin, ndc);
+    ndcMax = glm::max(ndcMax, ndc);
+  }
+
+  if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f ||
+      ndcMin.y > 1.0f)
+    return true; // Off screen: frustum culling's call, not ours.
+
+  auto toBlock = [](float ndc, int pixels, int blocks) {
+    int pixel = int(std::floor((ndc * 0.5f + 0.5f) * pixels));
+    return std::clamp(pixel / BLOCK_SIZE, 0, blocks - 1);
+  };
+  const int bx0 = toBlock(ndcMin.x, WIDTH, BLOCKS_X);
+  const int bx1 = toBlock(ndcMax.x, WIDTH, BLOCKS_X);
+  const int by0 = toBlock(ndcMin.y, HEIGHT, BLOCKS_Y);
+  const int by1 = toBlock(ndcMax.y, HEIGHT, BLOCKS_Y);
+  const float nearest = ndcMin.z * 0.5f + 0.5f;
+
+  for (int by = by0; by <= by1; by++)
+    for (int bx = bx0; bx <= bx1; bx++)
+      if (m_blockMaxDepth[by * BLOCKS_X + bx] >= nearest)
+        return true;
+  return false;
+}
\ No newline at end of file
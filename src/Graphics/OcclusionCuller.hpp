@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Graphics/BoundingBox.hpp"
+#include "Graphics/OccluderMesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Screen-space triangle ready for rasterization: three edge functions
+// E(x, y) = a*x + b*y + c (all >= 0 inside) and a depth plane, evaluated at
+// pixel centres. Shared with the AVX2 kernel.
+struct OcclusionTriangle {
+  float edgeA[3], edgeB[3], edgeC[3];
+  float depth0, depthDx, depthDy;
+  int minX, minY, maxX, maxY;
+};
+
+// Rasterizes the triangles listed in `bin` into the depth rectangle
+// [x0, x1) x [y0, y1) of `depth`, keeping the nearest value per pixel.
+using OcclusionRasterFn = void (*)(float *depth, int stride, int x0, int y0,
+                                   int x1, int y1,
+                                   const OcclusionTriangle *triangles,
+                                   const uint32_t *bin, size_t binSize);
+
+void rasterizeOcclusionTileScalar(float *depth, int stride, int x0, int y0,
+                                  int x1, int y1,
+                                  const OcclusionTriangle *triangles,
+                                  const uint32_t *bin, size_t binSize);
+#ifdef OCCLUSION_CULLER_AVX2
+void rasterizeOcclusionTileAVX2(float *depth, int stride, int x0, int y0,
+                                int x1, int y1,
+                                const OcclusionTriangle *triangles,
+                                const uint32_t *bin, size_t binSize);
+#endif
+
+// Software occlusion culling, entirely on the CPU. A handful of large
+// occluders are rasterized into a small depth buffer (one job per screen
+// tile, 8 pixels at a time with AVX2 where available), which is then
+// reduced to the farthest depth per 8x8 block. An entity is hidden when
+// the nearest point of its bounds lies behind every block its screen
+// rectangle touches.
+class OcclusionCuller {
+public:
+  static constexpr int WIDTH = 256;
+  static constexpr int HEIGHT = 128;
+  static constexpr int TILE_SIZE = 32;
+  static constexpr int BLOCK_SIZE = 8;
+  static constexpr int TILES_X = WIDTH / TILE_SIZE;
+  static constexpr int TILES_Y = HEIGHT / TILE_SIZE;
+  static constexpr int BLOCKS_X = WIDTH / BLOCK_SIZE;
+  static constexpr int BLOCKS_Y = HEIGHT / BLOCK_SIZE;
+
+  OcclusionCuller();
+
+  void begin(const glm::mat4 &viewProjection);
+  // Occluders must be opaque and solid where they are drawn; anything
+  // partially cut away by a clipping plane should not be added.
+  void addOccluder(const OccluderMesh &mesh, const glm::mat4 &model);
+  void rasterize();
+
+  bool isVisible(const BoundingBox &worldBounds) const;
+
+  // Depth in [0, 1] (1 = nothing rasterized), row 0 at the bottom.
+  const std::vector<float> &getDepth() const { return m_depth; }
+  size_t getTriangleCount() const { return m_triangles.size(); }
+  bool isUsingAVX2() const { return m_raster != rasterizeOcclusionTileScalar; }
+
+private:
+  glm::mat4 m_viewProjection = glm::mat4(1.0f);
+  std::vector<OcclusionTriangle> m_triangles;
+  std::vector<uint32_t> m_bins[TILES_X * TILES_Y];
+  std::vector<float> m_depth;
+  std::vector<float> m_blockMaxDepth;
+  std::vector<glm::vec4> m_clipScratch;
+  OcclusionRasterFn m_raster;
+
+  void setupTriangle(const glm::vec4 &a, const glm::vec4 &b,
+                     const glm::vec4 &c);
+};
\ No newline at end of file
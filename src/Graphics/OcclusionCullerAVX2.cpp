@@ -0,0 +1,60 @@
+#include "Graphics/OcclusionCuller.hpp"
+
+// Built with AVX2 code generation enabled (see CMakeLists.txt) and only
+// called after a runtime CPU check.
+#ifdef OCCLUSION_CULLER_AVX2
+
+#include <algorithm>
+#include <immintrin.h>
+
+void rasterizeOcclusionTileAVX2(float *depth, int stride, int x0, int y0,
+                                int x1, int y1,
+                                const OcclusionTriangle *triangles,
+                                const uint32_t *bin, size_t binSize) {
+  const __m256 laneOffsets =
+      _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+  const __m256 zero = _mm256_setzero_ps();
+
+  for (size_t i = 0; i < binSize; i++) {
+    const OcclusionTriangle &t = triangles[bin[i]];
+    // Tiles are 8-pixel aligned, so whole groups never leave the tile;
+    // the edge functions reject the extra pixels left of the triangle.
+    const int xs = std::max(t.minX, x0) & ~7, xe = std::min(t.maxX, x1 - 1);
+    const int ys = std::max(t.minY, y0), ye = std::min(t.maxY, y1 - 1);
+
+    const __m256 a0 = _mm256_set1_ps(t.edgeA[0]);
+    const __m256 a1 = _mm256_set1_ps(t.edgeA[1]);
+    const __m256 a2 = _mm256_set1_ps(t.edgeA[2]);
+    const __m256 dzdx = _mm256_set1_ps(t.depthDx);
+
+    for (int y = ys; y <= ye; y++) {
+      const float fy = y + 0.5f;
+      const __m256 r0 = _mm256_set1_ps(t.edgeB[0] * fy + t.edgeC[0]);
+      const __m256 r1 = _mm256_set1_ps(t.edgeB[1] * fy + t.edgeC[1]);
+      const __m256 r2 = _mm256_set1_ps(t.edgeB[2] * fy + t.edgeC[2]);
+      const __m256 rz = _mm256_set1_ps(t.depth0 + t.depthDy * fy);
+      float *row = depth + y * stride;
+
+      for (int x = xs; x <= xe; x += 8) {
+        const __m256 fx =
+            _mm256_add_ps(_mm256_set1_ps(float(x)), laneOffsets);
+        const __m256 e0 = _mm256_add_ps(_mm256_mul_ps(a0, fx), r0);
+        const __m256 e1 = _mm256_add_ps(_mm256_mul_ps(a1, fx), r1);
+        const __m256 e2 = _mm256_add_ps(_mm256_mul_ps(a2, fx), r2);
+        const __m256 inside = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ),
+                          _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)),
+            _mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+        if (_mm256_movemask_ps(inside) == 0)
+          continue;
+
+        const __m256 z = _mm256_add_ps(_mm256_mul_ps(dzdx, fx), rz);
+        const __m256 old = _mm256_loadu_ps(row + x);
+        _mm256_storeu_ps(row + x,
+                         _mm256_blendv_ps(old, _mm256_min_ps(old, z), inside));
+      }
+    }
+  }
+}
+
+#endif
\ No newline at end of file
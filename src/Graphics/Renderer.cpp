@@ -1,11 +1,71 @@
 #include "Graphics/Renderer.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/Log.hpp"
+#include "Graphics/Frustum.hpp"
 #include "Graphics/GeometryManager.hpp"
+#include "Graphics/MaterialTable.hpp"
+#include "Graphics/TextureStreamer.hpp"
 #include "Scene/Scene.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <glad/glad.h>
 
+namespace {
+
+// True when the box lies entirely on the clipped (negative) side of one of
+// the planes, so none of it would survive gl_ClipDistance.
+bool isClippedAway(const BoundingBox &box, const glm::vec4 *planes,
+                   int count) {
+  glm::vec3 center = box.center();
+  glm::vec3 extents = box.extents();
+  for (int i = 0; i < count; i++) {
+    glm::vec3 normal(planes[i]);
+    float farthest = glm::dot(normal, center) +
+                     glm::dot(glm::abs(normal), extents) + planes[i].w;
+    if (farthest < 0.0f)
+      return true;
+  }
+  return false;
+}
+
+// True when the whole box is on the kept side of every plane, so an
+// occluder drawn from it has not been cut open.
+bool isUnclipped(const BoundingBox &box, const glm::vec4 *planes, int count) {
+  glm::vec3 center = box.center();
+  glm::vec3 extents = box.extents();
+  for (int i = 0; i < count; i++) {
+    glm::vec3 normal(planes[i]);
+    float nearest = glm::dot(normal, center) -
+                    glm::dot(glm::abs(normal), extents) + planes[i].w;
+    if (nearest < 0.0f)
+      return false;
+  }
+  return true;
+}
+
+ObjectData makeObject(const Mesh &mesh, const Material &material,
+                      const glm::mat4 &model, const glm::mat3 &normalMatrix,
+                      const BoundingBox &worldBounds) {
+  const MeshRange range = mesh.getRange();
+
+  ObjectData object{};
+  object.model = model;
+  for (int c = 0; c < 3; c++)
+    object.normalMatrix[c] = glm::vec4(normalMatrix[c], 0.0f);
+  object.boundsMin = glm::vec4(worldBounds.min, 0.0f);
+  object.boundsMax = glm::vec4(worldBounds.max, 0.0f);
+  object.indexCount = range.indexCount;
+  object.firstIndex = static_cast<uint32_t>(range.indexOffset /
+                                           getIndexSize(range.indexType));
+  object.baseVertex = static_cast<int32_t>(range.vertexOffset);
+  object.materialIndex = material.getTableIndex();
+  return object;
+}
+
+} // namespace
+
 void Renderer::init() {
   glEnable(GL_DEPTH_TEST);
   glEnable(GL_BLEND);
@@ -20,9 +80,18 @@ void Renderer::init() {
                     GL_DYNAMIC_DRAW);
 
   glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_CameraUBO);
+
+  glCreateBuffers(1, &m_ClippingUBO);
+  glNamedBufferData(m_ClippingUBO, sizeof(ClippingDataUBOLayout), nullptr,
+                    GL_DYNAMIC_DRAW);
+  glBindBufferBase(GL_UNIFORM_BUFFER, 1, m_ClippingUBO);
+
+  m_lightClusters.init();
+  m_shadowMap.init();
 }
 
 void Renderer::setClearColor(const glm::vec4 &color) {
+  m_clearColor = color;
   glClearColor(color.r, color.g, color.b, color.a);
 }
 
@@ -31,15 +100,299 @@ void Renderer::waitCompute() {
                   GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
 }
 
-void Renderer::clear() { glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); }
+void Renderer::clear() {
+  // The overdraw view accumulates from black.
+  if (m_showOverdraw)
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  if (m_showOverdraw)
+    glClearColor(m_clearColor.r, m_clearColor.g, m_clearColor.b,
+                 m_clearColor.a);
+}
+
+void Renderer::setDepthShaders(std::shared_ptr<Shader> depthShader,
+                               std::shared_ptr<Shader> overdrawShader) {
+  m_depthShader = std::move(depthShader);
+  m_overdrawShader = std::move(overdrawShader);
+}
+
+void Renderer::setDepthPrePass(DepthPrePassMode mode,
+                               float overdrawThreshold) {
+  m_depthPrePassMode = mode;
+  m_depthPrePassOverdraw = overdrawThreshold;
+}
+
+void Renderer::setGPUCullingShaders(std::shared_ptr<Shader> cullShader,
+                                    std::shared_ptr<Shader> hiZShader) {
+  m_gpuCuller.setShaders(std::move(cullShader), std::move(hiZShader));
+}
+
+void Renderer::setShadowShader(std::shared_ptr<Shader> shader) {
+  m_shadowMap.setShader(std::move(shader));
+}
+
+void Renderer::setShadows(bool enabled, int size, float farPlane) {
+  m_shadowMap.setSettings(enabled, size, farPlane);
+}
 
 void Renderer::beginScene(Scene &scene) {
   m_activeScene = &scene;
 
   m_renderQueue.clear();
+  m_objects.clear();
+  m_meshletDraws.clear();
+  m_meshletCuller.begin();
 
   Camera &camera = scene.getCamera();
 
+  updateCamera(camera);
+  updateClipping(scene.getClippingPlanes());
+  const glm::vec4 *planes = scene.getClippingPlanes().data();
+  const int planeCount = m_activeClippingPlanes;
+
+  const glm::vec3 viewPos = camera.getPosition();
+  const glm::mat4 frustumMatrix =
+      camera.getProjectionMatrix() * camera.getViewMatrix();
+  Frustum frustum = Frustum::fromMatrix(frustumMatrix);
+  const float pixelsPerUnit =
+      camera.getViewportHeight() /
+      (2.0f * std::tan(glm::radians(camera.getFov()) * 0.5f));
+
+  const auto &entities = scene.getEntities();
+
+  const bool wasGPUCulling = m_gpuCullingActive;
+  m_gpuCullingActive = m_gpuCulling && m_gpuCuller.isSupported() &&
+                       MaterialTable::get().isEnabled();
+  if (m_gpuCullingActive != wasGPUCulling)
+    m_gpuCuller.invalidateHiZ();
+
+  // Bounds and screen size are independent per entity, so they are computed
+  // in parallel; materials are shared, so requests are applied serially.
+  m_screenSizes.assign(entities.size(), 0.0f);
+  m_clipped.assign(entities.size(), 0);
+  m_worldBounds.resize(entities.size());
+  JobSystem::get().parallelFor(
+      entities.size(),
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          const Entity &entity = entities[i];
+          if (!entity.mesh || !entity.material)
+            continue;
+
+          // Also brings the cached normal matrix up to date.
+          entity.transform.getNormalMatrix();
+          BoundingBox bounds = entity.mesh->getBounds().transformed(
+              entity.transform.getModelMatrix());
+          m_worldBounds[i] = bounds;
+          if (isClippedAway(bounds, planes, planeCount)) {
+            m_clipped[i] = 1;
+            continue;
+          }
+
+          glm::vec3 center = bounds.center();
+          float radius = bounds.radius();
+          if (!frustum.intersectsSphere(center, radius))
+            continue;
+
+          // Projected diameter of the bounding sphere, assuming the mesh's
+          // UVs span its textures roughly once.
+          float distance =
+              std::max(glm::length(center - viewPos) - radius,
+                       camera.getNearPlane());
+          m_screenSizes[i] = 2.0f * radius / distance * pixelsPerUnit;
+        }
+      },
+      256);
+
+  // The depth pyramid makes the CPU occluder pass redundant. The pass is
+  // also off under late latch: a late turn could bring entities it hid from
+  // this camera into view.
+  m_occluded.assign(entities.size(), 0);
+  if (m_occlusionCulling && !m_gpuCullingActive && !m_lateLatch)
+    cullOccluded(entities, frustumMatrix, camera.getViewportHeight(), planes,
+                 planeCount);
+  else
+    m_occlusionStats = OcclusionStats();
+
+  const float viewportArea =
+      camera.getViewportWidth() * camera.getViewportHeight();
+  float coveredArea = 0.0f;
+
+  m_gpuBatches.clear();
+  m_gpuBatchOf.assign(entities.size(), -1);
+
+  for (size_t i = 0; i < entities.size(); i++) {
+    const Entity &entity = entities[i];
+    if (!entity.mesh || !entity.material)
+      continue;
+
+    const bool meshlets = m_meshletCulling &&
+                          entity.mesh->getMeshletCount() > 0 &&
+                          !entity.material->isTransparent();
+
+    // GPU-driven entities are culled by the compute pass, so they are
+    // queued whether or not the CPU would have dropped them.
+    if (!meshlets && m_gpuCullingActive &&
+        !entity.material->isTransparent() &&
+        entity.material->getTableIndex() >= 0) {
+      int batch = findGPUBatch(entity.material->getShader(),
+                               entity.mesh->getIndexType());
+      m_gpuBatches[batch].count++;
+      m_gpuBatchOf[i] = batch;
+    }
+
+    if (!m_clipped[i] && !m_occluded[i]) {
+      if (meshlets) {
+        // Clusters are culled in endScene(), once the camera is final.
+        const glm::mat4 &model = entity.transform.getModelMatrix();
+        uint32_t object =
+            addObject(entity.mesh, entity.material, model,
+                      entity.transform.getNormalMatrix(), m_worldBounds[i]);
+        m_meshletDraws.push_back(
+            {entity.mesh, entity.material,
+             m_meshletCuller.add(*entity.mesh, object, model)});
+      } else if (m_gpuBatchOf[i] < 0) {
+        submitObject(entity.mesh, entity.material,
+                     addObject(entity.mesh, entity.material,
+                               entity.transform.getModelMatrix(),
+                               entity.transform.getNormalMatrix(),
+                               m_worldBounds[i]));
+      }
+      if (m_screenSizes[i] > 0.0f) {
+        entity.material->requestTextureDetail(m_screenSizes[i]);
+        if (!entity.material->isTransparent()) {
+          float diameter = m_screenSizes[i];
+          coveredArea +=
+              std::min(0.785f * diameter * diameter, viewportArea);
+        }
+      }
+    }
+  }
+
+  if (m_gpuCullingActive)
+    buildGPUObjects(entities);
+
+  m_estimatedOverdraw = viewportArea > 0.0f ? coveredArea / viewportArea : 0.0f;
+  switch (m_depthPrePassMode) {
+  case DepthPrePassMode::Off:
+    m_depthPrePassActive = false;
+    break;
+  case DepthPrePassMode::On:
+    m_depthPrePassActive = true;
+    break;
+  case DepthPrePassMode::Auto:
+    // Some hysteresis so a camera hovering around the threshold does not
+    // flip the pass on and off every frame.
+    if (m_estimatedOverdraw > m_depthPrePassOverdraw)
+      m_depthPrePassActive = true;
+    else if (m_estimatedOverdraw < m_depthPrePassOverdraw * 0.8f)
+      m_depthPrePassActive = false;
+    break;
+  }
+}
+
+void Renderer::cullOccluded(const std::vector<Entity> &entities,
+                            const glm::mat4 &viewProjection,
+                            float viewportHeight, const glm::vec4 *planes,
+                            int planeCount) {
+  auto start = std::chrono::steady_clock::now();
+
+  m_occluderCandidates.clear();
+  for (size_t i = 0; i < entities.size(); i++) {
+    const Entity &entity = entities[i];
+    if (m_screenSizes[i] <= 0.0f ||
+        m_screenSizes[i] < MIN_OCCLUDER_SIZE * viewportHeight ||
+        !entity.mesh->getOccluder() || entity.material->isTransparent() ||
+        !isUnclipped(m_worldBounds[i], planes, planeCount))
+      continue;
+    m_occluderCandidates.push_back(i);
+  }
+
+  const size_t occluderCount =
+      std::min(m_occluderCandidates.size(), MAX_OCCLUDERS);
+  std::partial_sort(m_occluderCandidates.begin(),
+                    m_occluderCandidates.begin() + occluderCount,
+                    m_occluderCandidates.end(), [this](size_t a, size_t b) {
+                      return m_screenSizes[a] > m_screenSizes[b];
+                    });
+
+  m_occlusionCuller.begin(viewProjection);
+  for (size_t c = 0; c < occluderCount; c++) {
+    const Entity &entity = entities[m_occluderCandidates[c]];
+    m_occlusionCuller.addOccluder(*entity.mesh->getOccluder(),
+                                  entity.transform.getModelMatrix());
+  }
+  m_occlusionCuller.rasterize();
+
+  // Entities outside the frustum have no screen size and are left alone.
+  if (occluderCount > 0) {
+    JobSystem::get().parallelFor(
+        entities.size(),
+        [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            if (m_screenSizes[i] > 0.0f &&
+                !m_occlusionCuller.isVisible(m_worldBounds[i]))
+              m_occluded[i] = 1;
+          }
+        },
+        256);
+  }
+
+  m_occlusionStats.occluders = occluderCount;
+  m_occlusionStats.triangles = m_occlusionCuller.getTriangleCount();
+  m_occlusionStats.culled =
+      static_cast<size_t>(std::count(m_occluded.begin(), m_occluded.end(), 1));
+  m_occlusionStats.milliseconds =
+      std::chrono::duration<float, std::milli>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+}
+
+int Renderer::findGPUBatch(const std::shared_ptr<Shader> &shader,
+                           IndexType indexType) {
+  for (size_t b = 0; b < m_gpuBatches.size(); b++) {
+    if (m_gpuBatches[b].shader == shader &&
+        m_gpuBatches[b].indexType == indexType)
+      return static_cast<int>(b);
+  }
+  m_gpuBatches.push_back({shader, indexType, 0, 0});
+  return static_cast<int>(m_gpuBatches.size() - 1);
+}
+
+void Renderer::buildGPUObjects(const std::vector<Entity> &entities) {
+  size_t total = 0;
+  for (GPUBatch &batch : m_gpuBatches) {
+    batch.first = total;
+    total += batch.count;
+    batch.count = 0;
+  }
+  const size_t firstObject = m_objects.size();
+  m_objects.resize(firstObject + total);
+
+  for (size_t i = 0; i < entities.size(); i++) {
+    const int b = m_gpuBatchOf[i];
+    if (b < 0)
+      continue;
+
+    const Entity &entity = entities[i];
+    GPUBatch &batch = m_gpuBatches[b];
+
+    ObjectData &object =
+        m_objects[firstObject + batch.first + batch.count++];
+    object = makeObject(*entity.mesh, *entity.material,
+                        entity.transform.getModelMatrix(),
+                        entity.transform.getNormalMatrix(), m_worldBounds[i]);
+    object.commandOffset = static_cast<uint32_t>(batch.first);
+    object.batch = static_cast<uint32_t>(b);
+  }
+
+  m_gpuCuller.resize(firstObject, total, m_gpuBatches.size());
+}
+
+void Renderer::updateCamera(const Camera &camera) {
+  m_viewProjection = camera.getProjectionMatrix() * camera.getViewMatrix();
+  m_viewPos = camera.getPosition();
+
   CameraDataUBOLayout cameraData;
   cameraData.view = camera.getViewMatrix();
   cameraData.projection = camera.getProjectionMatrix();
@@ -47,25 +400,82 @@ void Renderer::beginScene(Scene &scene) {
 
   glNamedBufferSubData(m_CameraUBO, 0, sizeof(CameraDataUBOLayout),
                        &cameraData);
+}
 
-  for (const auto &entity : scene.getEntities()) {
-    if (entity.mesh && entity.material) {
-      submit(entity.mesh, entity.material, entity.transform.getModelMatrix());
-    }
-  }
+void Renderer::updateClipping(const std::vector<glm::vec4> &planes) {
+  ClippingDataUBOLayout clippingData{};
+  m_activeClippingPlanes =
+      static_cast<int>(std::min<size_t>(planes.size(), MAX_CLIPPING_PLANES));
+  std::copy_n(planes.begin(), m_activeClippingPlanes, clippingData.planes);
+  clippingData.activePlanes = m_activeClippingPlanes;
+
+  glNamedBufferSubData(m_ClippingUBO, 0, sizeof(ClippingDataUBOLayout),
+                       &clippingData);
 }
 
-void Renderer::submit(const std::shared_ptr<Mesh> &mesh,
-                      const std::shared_ptr<Material> &material,
-                      const glm::mat4 &transform) {
+uint32_t Renderer::addObject(const std::shared_ptr<Mesh> &mesh,
+                             const std::shared_ptr<Material> &material,
+                             const glm::mat4 &model,
+                             const glm::mat3 &normalMatrix,
+                             const BoundingBox &worldBounds) {
+  m_objects.push_back(
+      makeObject(*mesh, *material, model, normalMatrix, worldBounds));
+  return static_cast<uint32_t>(m_objects.size() - 1);
+}
+
+void Renderer::submitObject(const std::shared_ptr<Mesh> &mesh,
+                            const std::shared_ptr<Material> &material,
+                            uint32_t objectIndex) {
   RenderCommand cmd;
   cmd.mesh = mesh;
   cmd.material = material;
-  cmd.transform = transform;
+  cmd.objectIndex = objectIndex;
   m_renderQueue.push_back(cmd);
 }
 
+void Renderer::submit(const std::shared_ptr<Mesh> &mesh,
+                      const std::shared_ptr<Material> &material,
+                      const glm::mat4 &transform) {
+  if (!mesh || !material)
+    return;
+  submitObject(mesh, material,
+               addObject(mesh, material, transform,
+                         glm::transpose(glm::inverse(glm::mat3(transform))),
+                         mesh->getBounds().transformed(transform)));
+}
+
 void Renderer::endScene() {
+  TextureStreamer::get().update();
+
+  // Uses its own object buffer, so it runs before the frame's is bound.
+  if (m_activeScene)
+    m_shadowMap.update(m_activeScene->getEntities(),
+                       m_activeScene->getLightPos(),
+                       m_activeScene->getClippingPlanes().data(),
+                       m_activeClippingPlanes);
+  m_shadowMap.bind();
+
+  m_objectBuffer.upload(m_objects);
+  m_objectBuffer.bind();
+
+  // Binned with the camera as last uploaded, like the GPU cull below.
+  if (m_activeScene)
+    m_lightClusters.update(m_activeScene->getPointLights(),
+                           m_activeScene->getCamera());
+  m_lightClusters.bind();
+
+  // Culled with the camera as last uploaded, so a late-latched look is
+  // respected (unlike the CPU occlusion and texture detail in beginScene()).
+  if (m_gpuCullingActive)
+    m_gpuCuller.cull(m_viewProjection);
+  if (!m_meshletDraws.empty())
+    m_meshletCuller.cull(m_viewProjection, m_viewPos,
+                         m_activeScene->getClippingPlanes().data(),
+                         m_activeClippingPlanes, m_backfaceCulling);
+
+  MaterialTable::get().update();
+  MaterialTable::get().bind();
+
   std::sort(m_renderQueue.begin(), m_renderQueue.end(),
             [](const RenderCommand &a, const RenderCommand &b) {
               return a.material->getShader() < b.material->getShader();
@@ -102,31 +512,106 @@ void Renderer::endScene() {
         if (m_activeScene) {
           currentShader->setUniformVec3("lightPos",
                                         m_activeScene->getLightPos());
-          const auto &planes = m_activeScene->getClippingPlanes();
-          currentShader->setUniformInt("u_ActiveClippingPlanes",
-                                       static_cast<int>(planes.size()));
-
-          for (size_t i = 0; i < planes.size(); i++) {
-            std::string name = "u_ClippingPlanes[" + std::to_string(i) + "]";
-            currentShader->setUniformVec4(name, planes[i]);
-          }
         }
       } else {
         cmd.material->bind();
       }
 
-      currentShader->setUniformMat4("model", cmd.transform);
-      cmd.mesh->drawGeometry();
+      cmd.mesh->drawGeometry(cmd.objectIndex);
     }
   };
 
-  glDepthMask(GL_TRUE);
-  drawCommands(opaqueQueue);
+  auto drawPositions = [&](const std::vector<RenderCommand> &queue,
+                           const Shader &shader) {
+    shader.useShader();
+    for (const auto &cmd : queue) {
+      if (!cmd.mesh)
+        continue;
+      cmd.mesh->drawGeometry(cmd.objectIndex);
+    }
+  };
+
+  auto drawGPUBatches = [&](const Shader *positionShader) {
+    if (!m_gpuCullingActive)
+      return;
+    for (size_t b = 0; b < m_gpuBatches.size(); b++) {
+      const GPUBatch &batch = m_gpuBatches[b];
+      const Shader &shader = positionShader ? *positionShader : *batch.shader;
+      shader.useShader();
+      if (!positionShader && m_activeScene)
+        shader.setUniformVec3("lightPos", m_activeScene->getLightPos());
+      m_gpuCuller.drawBatch(b, batch.first, batch.count, batch.indexType);
+    }
+  };
+
+  auto drawMeshlets = [&](const Shader *positionShader) {
+    if (positionShader)
+      positionShader->useShader();
+    for (const MeshletDraw &draw : m_meshletDraws) {
+      if (!positionShader) {
+        draw.material->bind();
+        if (m_activeScene)
+          draw.material->getShader()->setUniformVec3(
+              "lightPos", m_activeScene->getLightPos());
+      }
+      m_meshletCuller.draw(draw.instance);
+    }
+  };
 
+  for (int i = 0; i < m_activeClippingPlanes; i++)
+    glEnable(GL_CLIP_DISTANCE0 + i);
+  if (m_backfaceCulling)
+    glEnable(GL_CULL_FACE);
+
+  // With the pre-pass, the shading pass only runs for the front-most
+  // fragment of each pixel; vert.glsl and depth_vert.glsl both declare
+  // gl_Position invariant so their depths match exactly.
+  const bool prePass = m_depthPrePassActive && m_depthShader;
+  if (prePass) {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_TRUE);
+    drawPositions(opaqueQueue, *m_depthShader);
+    drawGPUBatches(m_depthShader.get());
+    drawMeshlets(m_depthShader.get());
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+  } else {
+    glDepthMask(GL_TRUE);
+  }
+
+  if (m_showOverdraw && m_overdrawShader) {
+    glBlendFunc(GL_ONE, GL_ONE);
+    drawPositions(opaqueQueue, *m_overdrawShader);
+    drawGPUBatches(m_overdrawShader.get());
+    drawMeshlets(m_overdrawShader.get());
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  } else {
+    drawCommands(opaqueQueue);
+    drawGPUBatches(nullptr);
+    drawMeshlets(nullptr);
+  }
+
+  if (prePass)
+    glDepthFunc(GL_LESS);
+
+  // Next frame's occlusion test runs against this frame's opaque depth.
+  if (m_gpuCullingActive) {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    m_gpuCuller.buildHiZ(m_viewProjection, viewport[2], viewport[3]);
+    MaterialTable::get().bind();
+  }
+
+  glDisable(GL_CULL_FACE);
   glDepthMask(GL_FALSE);
   drawCommands(transparentQueue);
 
   glDepthMask(GL_TRUE);
 
+  for (int i = 0; i < m_activeClippingPlanes; i++)
+    glDisable(GL_CLIP_DISTANCE0 + i);
+
   glBindVertexArray(0);
 }
\ No newline at end of file
@@ -4,14 +4,20 @@
 #include <memory>
 #include <vector>
 
+#include "Graphics/GPUCuller.hpp"
+#include "Graphics/LightClusters.hpp"
 #include "Graphics/Material.hpp"
 #include "Graphics/Mesh.hpp"
+#include "Graphics/MeshletCuller.hpp"
+#include "Graphics/ObjectBuffer.hpp"
+#include "Graphics/OcclusionCuller.hpp"
+#include "Graphics/ShadowMap.hpp"
 #include "Scene/Scene.hpp"
 
 struct RenderCommand {
   std::shared_ptr<Mesh> mesh;
   std::shared_ptr<Material> material;
-  glm::mat4 transform;
+  uint32_t objectIndex;
 
   float distanceToCamera;
 };
@@ -23,6 +29,21 @@ struct CameraDataUBOLayout {
   float padding;
 };
 
+constexpr int MAX_CLIPPING_PLANES = 8;
+
+struct ClippingDataUBOLayout {
+  glm::vec4 planes[MAX_CLIPPING_PLANES];
+  int activePlanes;
+  int padding[3];
+};
+
+struct OcclusionStats {
+  size_t occluders = 0;
+  size_t triangles = 0;
+  size_t culled = 0;
+  float milliseconds = 0.0f;
+};
+
 class Renderer {
 public:
   void init();
@@ -33,15 +54,153 @@ public:
   void clear();
 
   void beginScene(Scene &scene);
+  // Re-uploads the camera block, e.g. after a late look update. GPU and
+  // meshlet culling and the light clusters run in endScene() and follow it;
+  // CPU occlusion culling and texture detail requests were made with the
+  // camera from beginScene().
+  void updateCamera(const Camera &camera);
   void endScene();
 
   void submit(const std::shared_ptr<Mesh> &mesh,
               const std::shared_ptr<Material> &material,
               const glm::mat4 &transform);
 
+  // Position-only programs for the depth pre-pass and the overdraw view.
+  void setDepthShaders(std::shared_ptr<Shader> depthShader,
+                       std::shared_ptr<Shader> overdrawShader);
+  void setDepthPrePass(DepthPrePassMode mode, float overdrawThreshold);
+  DepthPrePassMode getDepthPrePassMode() const { return m_depthPrePassMode; }
+  bool isDepthPrePassActive() const { return m_depthPrePassActive; }
+  // Opaque screen coverage over viewport area, from the bounding spheres.
+  float getEstimatedOverdraw() const { return m_estimatedOverdraw; }
+
+  // Replaces opaque shading with an additive count of shaded fragments.
+  void setShowOverdraw(bool show) { m_showOverdraw = show; }
+  bool isShowingOverdraw() const { return m_showOverdraw; }
+
+  // Skips entities hidden behind the largest opaque meshes in view, tested
+  // on the CPU before anything is submitted.
+  void setOcclusionCulling(bool enabled) { m_occlusionCulling = enabled; }
+  bool isOcclusionCullingEnabled() const { return m_occlusionCulling; }
+  // The camera may still turn after beginScene() (updateCamera()). The CPU
+  // occlusion test cannot account for that, so it is skipped while set.
+  void setLateLatch(bool enabled) { m_lateLatch = enabled; }
+  bool isLateLatchEnabled() const { return m_lateLatch; }
+  const OcclusionStats &getOcclusionStats() const { return m_occlusionStats; }
+  const OcclusionCuller &getOcclusionCuller() const {
+    return m_occlusionCuller;
+  }
+
+  // Opaque entities with table-driven materials are culled in a compute
+  // shader (frustum, clipping planes, previous-frame depth pyramid) and
+  // drawn with one indirect call per shader. Needs MaterialTable and
+  // indirect draw counts; everything else keeps the CPU path.
+  void setGPUCullingShaders(std::shared_ptr<Shader> cullShader,
+                            std::shared_ptr<Shader> hiZShader);
+  void setGPUCulling(bool enabled) { m_gpuCulling = enabled; }
+  bool isGPUCullingEnabled() const { return m_gpuCulling; }
+  bool isGPUCullingActive() const { return m_gpuCullingActive; }
+  GPUCuller &getGPUCuller() { return m_gpuCuller; }
+  size_t getGPUBatchCount() const { return m_gpuBatches.size(); }
+
+  // Opaque meshes imported with meshlets are drawn cluster by cluster, with
+  // the clusters culled on the CPU every frame (see MeshletCuller). They
+  // skip the GPU-driven path.
+  void setMeshletCulling(bool enabled) { m_meshletCulling = enabled; }
+  bool isMeshletCullingEnabled() const { return m_meshletCulling; }
+  const MeshletCuller &getMeshletCuller() const { return m_meshletCuller; }
+
+  // Culls back faces of opaque geometry, which also lets meshlets facing
+  // away from the camera be skipped. Off draws everything two-sided.
+  void setBackfaceCulling(bool enabled) { m_backfaceCulling = enabled; }
+  bool isBackfaceCullingEnabled() const { return m_backfaceCulling; }
+
+  // Omnidirectional shadows from the scene's main light (see ShadowMap).
+  void setShadowShader(std::shared_ptr<Shader> shader);
+  void setShadows(bool enabled, int size, float farPlane);
+  bool areShadowsEnabled() const { return m_shadowMap.isEnabled(); }
+  const ShadowMap &getShadowMap() const { return m_shadowMap; }
+
+  // Point lights are binned into view-space clusters every frame.
+  const LightClusters &getLightClusters() const { return m_lightClusters; }
+
 private:
   Scene *m_activeScene = nullptr;
   unsigned int m_CameraUBO = 0;
+  unsigned int m_ClippingUBO = 0;
+  int m_activeClippingPlanes = 0;
 
   std::vector<RenderCommand> m_renderQueue;
+  // Everything drawn this frame, CPU-submitted and GPU-driven alike.
+  std::vector<ObjectData> m_objects;
+  ObjectBuffer m_objectBuffer;
+  LightClusters m_lightClusters;
+  ShadowMap m_shadowMap;
+  std::vector<float> m_screenSizes;
+  std::vector<char> m_clipped;
+  std::vector<char> m_occluded;
+  std::vector<BoundingBox> m_worldBounds;
+
+  glm::vec4 m_clearColor = glm::vec4(0.0f);
+
+  std::shared_ptr<Shader> m_depthShader;
+  std::shared_ptr<Shader> m_overdrawShader;
+  DepthPrePassMode m_depthPrePassMode = DepthPrePassMode::Off;
+  float m_depthPrePassOverdraw = 2.5f;
+  bool m_depthPrePassActive = false;
+  float m_estimatedOverdraw = 0.0f;
+  bool m_showOverdraw = false;
+
+  static constexpr size_t MAX_OCCLUDERS = 16;
+  // Smallest on-screen size, as a fraction of the viewport height, for an
+  // entity to be rasterized as an occluder.
+  static constexpr float MIN_OCCLUDER_SIZE = 0.1f;
+
+  OcclusionCuller m_occlusionCuller;
+  bool m_occlusionCulling = true;
+  bool m_lateLatch = false;
+  OcclusionStats m_occlusionStats;
+  std::vector<size_t> m_occluderCandidates;
+
+  // One indirect draw covers a single index type, so batches are split by
+  // shader and index type.
+  struct GPUBatch {
+    std::shared_ptr<Shader> shader;
+    IndexType indexType = IndexType::UInt32;
+    size_t first = 0;
+    size_t count = 0;
+  };
+
+  GPUCuller m_gpuCuller;
+  bool m_gpuCulling = true;
+  bool m_gpuCullingActive = false;
+  std::vector<GPUBatch> m_gpuBatches;
+  std::vector<int> m_gpuBatchOf;
+  glm::mat4 m_viewProjection = glm::mat4(1.0f);
+  glm::vec3 m_viewPos = glm::vec3(0.0f);
+
+  struct MeshletDraw {
+    std::shared_ptr<Mesh> mesh;
+    std::shared_ptr<Material> material;
+    size_t instance;
+  };
+
+  MeshletCuller m_meshletCuller;
+  bool m_meshletCulling = true;
+  bool m_backfaceCulling = false;
+  std::vector<MeshletDraw> m_meshletDraws;
+
+  uint32_t addObject(const std::shared_ptr<Mesh> &mesh,
+                     const std::shared_ptr<Material> &material,
+                     const glm::mat4 &model, const glm::mat3 &normalMatrix,
+                     const BoundingBox &worldBounds);
+  void submitObject(const std::shared_ptr<Mesh> &mesh,
+                    const std::shared_ptr<Material> &material,
+                    uint32_t objectIndex);
+  void updateClipping(const std::vector<glm::vec4> &planes);
+  void cullOccluded(const std::vector<Entity> &entities,
+                    const glm::mat4 &viewProjection, float viewportHeight,
+                    const glm::vec4 *planes, int planeCount);
+  int findGPUBatch(const std::shared_ptr<Shader> &shader, IndexType indexType);
+  void buildGPUObjects(const std::vector<Entity> &entities);
 };
\ No newline at end of file
@@ -1,17 +1,23 @@
 #include "Graphics/ResourceManager.hpp"
 #include "Core/Log.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <unordered_set>
+
+ResourceManager::ResourceManager(const TextureConfig &textureConfig)
+    : m_textureConfig(textureConfig) {}
+
 std::shared_ptr<Texture> ResourceManager::loadTexture(const std::string &path,
                                                       TextureType typeName) {
   if (m_textures.find(path) != m_textures.end()) {
     return m_textures[path];
   }
 
-  auto texture = std::make_shared<Texture>(path);
-  texture->setType(typeName);
-
-  m_textures[path] = texture;
-  return texture;
+  LOG_CORE_TRACE("Loading texture: {0}", path);
+  return addTexture(path, typeName,
+                    Texture::loadData(path, typeName, m_textureConfig));
 }
 
 std::shared_ptr<Texture> ResourceManager::getTexture(const std::string &path) {
@@ -20,16 +26,84 @@ std::shared_ptr<Texture> ResourceManager::getTexture(const std::string &path) {
   return nullptr;
 }
 
+std::shared_ptr<Texture> ResourceManager::addTexture(const std::string &path,
+                                                     TextureType type,
+                                                     TextureData data,
+                                                     DedupSavings *savings) {
+  if (m_textures.find(path) != m_textures.end())
+    return m_textures[path];
+
+  // Failed decodes have no levels (and no hash); each gets its fallback.
+  const bool decoded = !data.levels.empty();
+  const Hash128 hash = data.contentHash;
+  if (decoded) {
+    auto it = m_texturesByContent.find(hash);
+    if (it != m_texturesByContent.end()) {
+      DedupSavings saved;
+      saved.textures = 1;
+      saved.bytes = it->second->getMemorySize();
+      m_dedupSavings += saved;
+      if (savings)
+        *savings += saved;
+      LOG_CORE_TRACE("Texture {0} has the same texels as {1}", path,
+                     it->second->getPath());
+      m_textures[path] = it->second;
+      return it->second;
+    }
+  }
+
+  auto texture =
+      std::make_shared<Texture>(path, type, std::move(data), m_textureConfig);
+  m_textures[path] = texture;
+  if (decoded)
+    m_texturesByContent[hash] = texture;
+  return texture;
+}
+
+std::shared_ptr<Mesh> ResourceManager::findMesh(const Hash128 &hash,
+                                                DedupSavings *savings) {
+  auto it = m_meshesByContent.find(hash);
+  if (it == m_meshesByContent.end())
+    return nullptr;
+  std::shared_ptr<Mesh> mesh = it->second.lock();
+  if (!mesh) {
+    m_meshesByContent.erase(it);
+    return nullptr;
+  }
+
+  const MeshRange range = mesh->getRange();
+  DedupSavings saved;
+  saved.meshes = 1;
+  saved.bytes = range.vertexCount * sizeof(Vertex) +
+                range.indexCount * getIndexSize(range.indexType);
+  m_dedupSavings += saved;
+  if (savings)
+    *savings += saved;
+  return mesh;
+}
+
+void ResourceManager::addMesh(const Hash128 &hash,
+                              const std::shared_ptr<Mesh> &mesh) {
+  if (m_meshesByContent.size() >= m_meshPruneSize) {
+    for (auto it = m_meshesByContent.begin(); it != m_meshesByContent.end();)
+      it = it->second.expired() ? m_meshesByContent.erase(it) : std::next(it);
+    m_meshPruneSize = std::max<size_t>(64, m_meshesByContent.size() * 2);
+  }
+  m_meshesByContent[hash] = mesh;
+}
+
 std::shared_ptr<Shader>
 ResourceManager::loadShader(const std::string &name,
                             const std::string &vShaderFile,
-                            const std::string &fShaderFile) {
+                            const std::string &fShaderFile,
+                            const std::vector<std::string> &defines) {
   if (m_shaders.find(name) != m_shaders.end()) {
     return m_shaders[name];
   }
 
-  auto shader = std::make_shared<Shader>(vShaderFile, fShaderFile);
+  auto shader = std::make_shared<Shader>(vShaderFile, fShaderFile, defines);
   m_shaders[name] = shader;
+  watchShader(*shader);
   return shader;
 }
 
@@ -39,9 +113,69 @@ std::shared_ptr<Shader> ResourceManager::getShader(const std::string &name) {
   return nullptr;
 }
 
+std::string ResourceManager::modelKey(const std::string &path,
+                                      uint64_t importFlags) {
+  std::error_code error;
+  std::filesystem::path canonical =
+      std::filesystem::weakly_canonical(path, error);
+  char flags[24];
+  std::snprintf(flags, sizeof(flags), "|%016llx",
+                static_cast<unsigned long long>(importFlags));
+  return (error ? path : canonical.string()) + flags;
+}
+
+bool ResourceManager::getModel(const std::string &key,
+                               std::vector<SharedModelPart> &parts) {
+  auto it = m_models.find(key);
+  if (it == m_models.end())
+    return false;
+
+  const ModelEntry &entry = it->second;
+  parts.clear();
+  parts.reserve(entry.meshes.size());
+  for (size_t i = 0; i < entry.meshes.size(); i++) {
+    SharedModelPart part{entry.meshes[i].lock(), entry.materials[i].lock()};
+    // Part of the model was released; the next load imports it afresh.
+    if (!part.mesh || !part.material) {
+      parts.clear();
+      m_models.erase(it);
+      return false;
+    }
+    parts.push_back(std::move(part));
+  }
+  return true;
+}
+
+void ResourceManager::addModel(const std::string &key,
+                               const std::vector<SharedModelPart> &parts) {
+  // Drop entries whose models are gone so the map does not grow with every
+  // file ever opened.
+  for (auto it = m_models.begin(); it != m_models.end();) {
+    const auto &meshes = it->second.meshes;
+    bool expired = std::any_of(
+        meshes.begin(), meshes.end(),
+        [](const std::weak_ptr<Mesh> &mesh) { return mesh.expired(); });
+    it = expired ? m_models.erase(it) : std::next(it);
+  }
+  // Nothing would ever expire an empty entry.
+  if (parts.empty())
+    return;
+
+  ModelEntry &entry = m_models[key];
+  entry.meshes.assign(parts.size(), {});
+  entry.materials.assign(parts.size(), {});
+  for (size_t i = 0; i < parts.size(); i++) {
+    entry.meshes[i] = parts[i].mesh;
+    entry.materials[i] = parts[i].material;
+  }
+}
+
 void ResourceManager::clear() {
   m_shaders.clear();
   m_textures.clear();
+  m_texturesByContent.clear();
+  m_meshesByContent.clear();
+  m_models.clear();
 }
 
 void ResourceManager::reloadAllShaders() {
@@ -51,5 +185,37 @@ void ResourceManager::reloadAllShaders() {
       shader->reload();
     }
   }
-  LOG_CORE_INFO("--- RELOAD COMPLETE ---");
+}
+
+void ResourceManager::update() {
+  if (m_shaderHotReload) {
+    std::vector<std::string> changed = m_shaderWatcher.poll();
+    if (!changed.empty()) {
+      std::unordered_set<std::string> changedFiles(changed.begin(),
+                                                   changed.end());
+      for (auto &[name, shader] : m_shaders) {
+        if (!shader)
+          continue;
+        for (const auto &dependency : shader->getDependencies()) {
+          if (changedFiles.count(FileWatcher::normalize(dependency))) {
+            shader->reload();
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  for (auto &[name, shader] : m_shaders) {
+    // A rebuild may have picked up new #includes.
+    if (shader && shader->pollReload())
+      watchShader(*shader);
+  }
+}
+
+void ResourceManager::watchShader(const Shader &shader) {
+  if (!m_shaderHotReload)
+    return;
+  for (const auto &dependency : shader.getDependencies())
+    m_shaderWatcher.watch(dependency);
 }
\ No newline at end of file
@@ -3,27 +3,116 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Graphics/Shader.hpp"
+#include "Config.hpp"
+#include "Core/FileWatcher.hpp"
+#include "Core/Hash.hpp"
+#include "Graphics/Material.hpp"
+#include "Graphics/Mesh.hpp"
 #include "Graphics/Texture.hpp"
 
+// One part of a loaded model, shared by every instance of that model.
+struct SharedModelPart {
+  std::shared_ptr<Mesh> mesh;
+  std::shared_ptr<Material> material;
+};
+
+// GPU memory that content deduplication avoided allocating.
+struct DedupSavings {
+  size_t meshes = 0;
+  size_t textures = 0;
+  size_t bytes = 0;
+
+  DedupSavings &operator+=(const DedupSavings &other) {
+    meshes += other.meshes;
+    textures += other.textures;
+    bytes += other.bytes;
+    return *this;
+  }
+};
+
 class ResourceManager {
 public:
+  explicit ResourceManager(const TextureConfig &textureConfig = TextureConfig());
+
   std::shared_ptr<Texture>
   loadTexture(const std::string &path,
               TextureType typeName = TextureType::Diffuse);
   std::shared_ptr<Texture> getTexture(const std::string &path);
+  // Registers a texture decoded elsewhere (e.g. on a loader thread). If the
+  // path, or a texture with the same texels under another path, is already
+  // loaded the existing texture wins and `data` is dropped.
+  std::shared_ptr<Texture> addTexture(const std::string &path,
+                                      TextureType type, TextureData data,
+                                      DedupSavings *savings = nullptr);
 
-  std::shared_ptr<Shader> loadShader(const std::string &name,
-                                     const std::string &vShaderFile,
-                                     const std::string &fShaderFile);
+  // Meshes by content hash (Model::hashGeometry, plus the meshlets if any):
+  // identical geometry found under different names shares one GPU
+  // allocation while it is in use.
+  std::shared_ptr<Mesh> findMesh(const Hash128 &hash,
+                                 DedupSavings *savings = nullptr);
+  void addMesh(const Hash128 &hash, const std::shared_ptr<Mesh> &mesh);
+  const DedupSavings &getDedupSavings() const { return m_dedupSavings; }
+
+  std::shared_ptr<Shader>
+  loadShader(const std::string &name, const std::string &vShaderFile,
+             const std::string &fShaderFile,
+             const std::vector<std::string> &defines = {});
   std::shared_ptr<Shader> getShader(const std::string &name);
 
+  // Models are keyed by canonical path and import flags, so the same file
+  // reached through different relative paths is only imported once. The
+  // registry holds weak references: the scene entities using a model's
+  // meshes and materials own them, and its geometry is freed when the last
+  // of them goes away.
+  static std::string modelKey(const std::string &path, uint64_t importFlags);
+  // Fills `parts` and returns true if every part of the model is still
+  // alive.
+  bool getModel(const std::string &key, std::vector<SharedModelPart> &parts);
+  void addModel(const std::string &key,
+                const std::vector<SharedModelPart> &parts);
+
+  void setTextureConfig(const TextureConfig &config) {
+    m_textureConfig = config;
+  }
+  const TextureConfig &getTextureConfig() const { return m_textureConfig; }
+
+  void setImportConfig(const ImportConfig &config) { m_importConfig = config; }
+  const ImportConfig &getImportConfig() const { return m_importConfig; }
+
   void clear();
 
+  // Rebuilds every shader in the background; see update().
   void reloadAllShaders();
 
+  // Rebuilds shaders whose sources or includes changed on disk (when hot
+  // reload is on) and swaps in finished builds. Call once per frame.
+  void update();
+  void setShaderHotReload(bool enabled) { m_shaderHotReload = enabled; }
+
 private:
+  TextureConfig m_textureConfig;
+  ImportConfig m_importConfig;
+
+  FileWatcher m_shaderWatcher;
+  bool m_shaderHotReload = false;
+
+  void watchShader(const Shader &shader);
+
   std::unordered_map<std::string, std::shared_ptr<Shader>> m_shaders;
   std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
+  std::unordered_map<Hash128, std::shared_ptr<Texture>, Hash128::Hasher>
+      m_texturesByContent;
+  std::unordered_map<Hash128, std::weak_ptr<Mesh>, Hash128::Hasher>
+      m_meshesByContent;
+  size_t m_meshPruneSize = 64;
+  DedupSavings m_dedupSavings;
+
+  struct ModelEntry {
+    std::vector<std::weak_ptr<Mesh>> meshes;
+    std::vector<std::weak_ptr<Material>> materials;
+  };
+  std::unordered_map<std::string, ModelEntry> m_models;
 };
\ No newline at end of file
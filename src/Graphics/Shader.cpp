@@ -1,15 +1,118 @@
 #include "Graphics/Shader.hpp"
 #include "Core/Log.hpp"
+#include "Graphics/GLCapabilities.hpp"
+#include "Graphics/ShaderCache.hpp"
 
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <sstream>
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace {
+
+// Defines go right after the #version line, which must stay first.
+std::string injectDefines(const std::string &source,
+                          const std::vector<std::string> &defines) {
+  if (defines.empty())
+    return source;
+
+  std::string block;
+  for (const auto &define : defines)
+    block += "#define " + define + "\n";
+
+  size_t version = source.find("#version");
+  if (version == std::string::npos)
+    return block + source;
+
+  size_t lineEnd = source.find('\n', version);
+  if (lineEnd == std::string::npos)
+    return source + "\n" + block;
+
+  return source.substr(0, lineEnd + 1) + block + source.substr(lineEnd + 1);
+}
+
+bool readFile(const std::string &path, std::string &out) {
+  std::ifstream file(path);
+  if (!file.is_open())
+    return false;
+
+  std::stringstream stream;
+  stream << file.rdbuf();
+  out = stream.str();
+  return true;
+}
+
+// Expands `#include "file"` relative to the including file. Every file read
+// is recorded so edits to shared snippets can trigger a rebuild. Repeated
+// includes are skipped, which doubles as an include guard.
+bool preprocess(const std::string &path, std::string &out,
+                std::vector<std::string> &files) {
+  if (std::find(files.begin(), files.end(), path) != files.end())
+    return true;
+  files.push_back(path);
+
+  std::string source;
+  if (!readFile(path, source)) {
+    LOG_CORE_ERROR("SHADER FILE ERROR: Not successfully read. Path: {0}",
+                   path);
+    return false;
+  }
+
+  std::istringstream lines(source);
+  std::string line;
+  while (std::getline(lines, line)) {
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos ||
+        line.compare(start, 8, "#include") != 0) {
+      out += line + "\n";
+      continue;
+    }
+
+    size_t open = line.find('"', start);
+    size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+    if (close == std::string::npos) {
+      LOG_CORE_ERROR("SHADER INCLUDE ERROR: Malformed directive in {0}: {1}",
+                     path, line);
+      return false;
+    }
+
+    std::string include =
+        (std::filesystem::path(path).parent_path() /
+         line.substr(open + 1, close - open - 1))
+            .lexically_normal()
+            .string();
+    if (!preprocess(include, out, files))
+      return false;
+  }
+  return true;
+}
+
+const char *stageName(unsigned int type) {
+  switch (type) {
+  case GL_VERTEX_SHADER:
+    return "VERTEX";
+  case GL_FRAGMENT_SHADER:
+    return "FRAGMENT";
+  case GL_COMPUTE_SHADER:
+    return "COMPUTE SHADER";
+  default:
+    return "SHADER";
+  }
+}
+
+} // namespace
+
 Shader::Shader(const std::string &vertexShaderPath,
-               const std::string &fragmentShaderPath)
+               const std::string &fragmentShaderPath,
+               const std::vector<std::string> &defines)
     : m_vertexPath(vertexShaderPath), m_fragmentPath(fragmentShaderPath),
-      m_isCompute(false) {
+      m_isCompute(false), m_defines(defines) {
 
   compile();
 }
@@ -20,6 +123,7 @@ Shader::Shader(const std::string &computeShaderPath)
 }
 
 Shader::~Shader() {
+  discardBuild(m_pending);
   if (m_programID != 0)
     glDeleteProgram(m_programID);
 }
@@ -30,11 +134,30 @@ void Shader::reload() {
   else
     LOG_CORE_WARN("Reloading Shader: {0}", m_vertexPath);
 
-  if (m_programID != 0)
-    glDeleteProgram(m_programID);
-  m_uniformLocationCache.clear();
+  // A newer edit supersedes a build that is still in flight.
+  discardBuild(m_pending);
+  if (!beginBuild(m_pending))
+    discardBuild(m_pending);
+}
 
-  compile();
+bool Shader::pollReload() {
+  if (m_pending.program == 0 || !isBuildComplete(m_pending))
+    return false;
+
+  if (finishBuild(m_pending)) {
+    if (m_programID != 0)
+      glDeleteProgram(m_programID);
+    adopt(m_pending);
+    LOG_CORE_INFO("Shader reloaded: {0}",
+                  m_isCompute ? m_computePath : m_vertexPath);
+  } else {
+    LOG_CORE_ERROR("Shader reload failed, keeping previous program: {0}",
+                   m_isCompute ? m_computePath : m_vertexPath);
+    discardBuild(m_pending);
+  }
+
+  m_pending = PendingBuild();
+  return true;
 }
 
 void Shader::dispatch(unsigned int x, unsigned int y, unsigned int z) const {
@@ -43,124 +166,142 @@ void Shader::dispatch(unsigned int x, unsigned int y, unsigned int z) const {
 }
 
 void Shader::compile() {
-  if (m_isCompute) {
-    std::string cShaderSourceStr;
-    std::ifstream cShaderFile;
-
-    cShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try {
-      cShaderFile.open(m_computePath);
-      std::stringstream cShaderStream;
-      cShaderStream << cShaderFile.rdbuf();
-      cShaderSourceStr = cShaderStream.str();
-      cShaderFile.close();
-    } catch (std::ifstream::failure &e) {
-      LOG_CORE_ERROR("SHADER FILE ERROR: Not successfully read. Path: {0}",
-                     m_computePath);
-      return;
-    }
-
-    const char *cShaderSource = cShaderSourceStr.c_str();
-    unsigned int cShader;
-    int success;
-    char infoLog[512];
-
-    cShader = glCreateShader(GL_COMPUTE_SHADER);
-    glShaderSource(cShader, 1, &cShaderSource, nullptr);
-    glCompileShader(cShader);
-    glGetShaderiv(cShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-      glGetShaderInfoLog(cShader, 512, nullptr, infoLog);
-      LOG_CORE_ERROR("COMPUTE SHADER COMPILATION FAILED ({0}):\n{1}",
-                     m_computePath, infoLog);
-    }
+  PendingBuild build;
+  if (!beginBuild(build)) {
+    m_dependencies = build.dependencies;
+    discardBuild(build);
+    return;
+  }
 
-    m_programID = glCreateProgram();
-    glAttachShader(m_programID, cShader);
-    glLinkProgram(m_programID);
+  // The first build has nothing to fall back to, so it is adopted even when
+  // it fails; the errors are already in the log.
+  finishBuild(build);
+  adopt(build);
+}
 
-    glGetProgramiv(m_programID, GL_LINK_STATUS, &success);
-    if (!success) {
-      glGetProgramInfoLog(m_programID, 512, nullptr, infoLog);
-      LOG_CORE_ERROR("COMPUTE SHADER LINKING FAILED:\n{0}", infoLog);
+bool Shader::beginBuild(PendingBuild &build) {
+  if (m_isCompute)
+    build.stages = {{GL_COMPUTE_SHADER, m_computePath}};
+  else
+    build.stages = {{GL_VERTEX_SHADER, m_vertexPath},
+                    {GL_FRAGMENT_SHADER, m_fragmentPath}};
+
+  std::vector<std::string> sources;
+  for (const auto &[type, path] : build.stages) {
+    std::string source;
+    std::vector<std::string> files;
+    if (!preprocess(path, source, files))
+      return false;
+    sources.push_back(injectDefines(source, m_defines));
+
+    for (const auto &file : files) {
+      if (std::find(build.dependencies.begin(), build.dependencies.end(),
+                    file) == build.dependencies.end())
+        build.dependencies.push_back(file);
     }
-
-    glDeleteShader(cShader);
-    return;
   }
 
-  std::string vShaderSourceStr, fShaderSourceStr;
-  std::ifstream vShaderFile, fShaderFile;
+  build.cacheKey = ShaderCache::makeKey(sources, m_defines);
+  build.program = glCreateProgram();
 
-  vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-  fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+  if (ShaderCache::load(build.cacheKey, build.program)) {
+    LOG_CORE_TRACE("Shader binary cache hit: {0}", build.stages.front().second);
+    build.fromCache = true;
+    return true;
+  }
 
-  try {
-    vShaderFile.open(m_vertexPath);
-    fShaderFile.open(m_fragmentPath);
+  // With parallel shader compile these calls only queue work; nothing below
+  // reads a status back, so the caller decides when to wait.
+  for (size_t i = 0; i < build.stages.size(); i++) {
+    const char *source = sources[i].c_str();
 
-    std::stringstream vShaderStream, fShaderStream;
-    vShaderStream << vShaderFile.rdbuf();
-    fShaderStream << fShaderFile.rdbuf();
+    unsigned int shader = glCreateShader(build.stages[i].first);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    glAttachShader(build.program, shader);
+    build.shaders.push_back(shader);
+  }
 
-    vShaderSourceStr = vShaderStream.str();
-    fShaderSourceStr = fShaderStream.str();
+  // Must be set before linking for glGetProgramBinary to return anything.
+  glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                      GL_TRUE);
+  glLinkProgram(build.program);
+  return true;
+}
 
-    vShaderFile.close();
-    fShaderFile.close();
-  } catch (std::ifstream::failure &e) {
-    LOG_CORE_ERROR("SHADER FILE ERROR: Not successfully read. Path: {0}",
-                   m_vertexPath);
-    return;
-  }
+bool Shader::isBuildComplete(const PendingBuild &build) const {
+  if (build.fromCache || !GLCapabilities::supportsParallelShaderCompile())
+    return true;
 
-  const char *vShaderSource = vShaderSourceStr.c_str();
-  const char *fShaderSource = fShaderSourceStr.c_str();
+  int complete = 0;
+  glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &complete);
+  return complete;
+}
 
-  unsigned int vShader, fShader;
+bool Shader::finishBuild(PendingBuild &build) {
   int success;
   char infoLog[512];
 
-  vShader = glCreateShader(GL_VERTEX_SHADER);
-  glShaderSource(vShader, 1, &vShaderSource, nullptr);
-  glCompileShader(vShader);
-  glGetShaderiv(vShader, GL_COMPILE_STATUS, &success);
-  if (!success) {
-    glGetShaderInfoLog(vShader, 512, nullptr, infoLog);
-    LOG_CORE_ERROR("VERTEX COMPILATION FAILED ({0}):\n{1}", m_vertexPath,
-                   infoLog);
+  for (size_t i = 0; i < build.shaders.size(); i++) {
+    glGetShaderiv(build.shaders[i], GL_COMPILE_STATUS, &success);
+    if (!success) {
+      glGetShaderInfoLog(build.shaders[i], 512, nullptr, infoLog);
+      LOG_CORE_ERROR("{0} COMPILATION FAILED ({1}):\n{2}",
+                     stageName(build.stages[i].first),
+                     build.stages[i].second, infoLog);
+    }
+    glDetachShader(build.program, build.shaders[i]);
+    glDeleteShader(build.shaders[i]);
   }
+  build.shaders.clear();
 
-  fShader = glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(fShader, 1, &fShaderSource, nullptr);
-  glCompileShader(fShader);
-  glGetShaderiv(fShader, GL_COMPILE_STATUS, &success);
+  glGetProgramiv(build.program, GL_LINK_STATUS, &success);
   if (!success) {
-    glGetShaderInfoLog(fShader, 512, nullptr, infoLog);
-    LOG_CORE_ERROR("FRAGMENT COMPILATION FAILED ({0}):\n{1}", m_fragmentPath,
-                   infoLog);
+    glGetProgramInfoLog(build.program, 512, nullptr, infoLog);
+    LOG_CORE_ERROR("{0}LINKING FAILED:\n{1}",
+                   m_isCompute ? "COMPUTE SHADER " : "SHADER ", infoLog);
+    return false;
   }
 
-  m_programID = glCreateProgram();
-  glAttachShader(m_programID, vShader);
-  glAttachShader(m_programID, fShader);
-  glLinkProgram(m_programID);
-
-  glGetProgramiv(m_programID, GL_LINK_STATUS, &success);
-  if (!success) {
-    glGetProgramInfoLog(m_programID, 512, nullptr, infoLog);
-    LOG_CORE_ERROR("SHADER LINKING FAILED:\n{0}", infoLog);
-  }
+  if (!build.fromCache)
+    ShaderCache::store(build.cacheKey, build.program);
+  return true;
+}
 
-  glDeleteShader(vShader);
-  glDeleteShader(fShader);
+void Shader::adopt(PendingBuild &build) {
+  m_programID = build.program;
+  m_dependencies = std::move(build.dependencies);
+  m_uniformLocationCache.clear();
+  build.program = 0;
 
   unsigned int uniformBlockIndex =
       glGetUniformBlockIndex(m_programID, "CameraData");
   if (uniformBlockIndex != GL_INVALID_INDEX) {
     glUniformBlockBinding(m_programID, uniformBlockIndex, 0);
   }
+
+  uniformBlockIndex = glGetUniformBlockIndex(m_programID, "ClippingData");
+  if (uniformBlockIndex != GL_INVALID_INDEX) {
+    glUniformBlockBinding(m_programID, uniformBlockIndex, 1);
+  }
+
+  uniformBlockIndex = glGetUniformBlockIndex(m_programID, "LightingData");
+  if (uniformBlockIndex != GL_INVALID_INDEX) {
+    glUniformBlockBinding(m_programID, uniformBlockIndex, 2);
+  }
+
+  uniformBlockIndex = glGetUniformBlockIndex(m_programID, "ShadowData");
+  if (uniformBlockIndex != GL_INVALID_INDEX) {
+    glUniformBlockBinding(m_programID, uniformBlockIndex, 3);
+  }
+}
+
+void Shader::discardBuild(PendingBuild &build) {
+  for (unsigned int shader : build.shaders)
+    glDeleteShader(shader);
+  if (build.program != 0)
+    glDeleteProgram(build.program);
+  build = PendingBuild();
 }
 
 void Shader::useShader() const { glUseProgram(m_programID); }
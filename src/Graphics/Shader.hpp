@@ -1,19 +1,37 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 class Shader {
 public:
   Shader(const std::string &vertexShaderPath,
-         const std::string &fragmentShaderPath);
+         const std::string &fragmentShaderPath,
+         const std::vector<std::string> &defines = {});
 
   Shader(const std::string &computeShaderPath);
 
   ~Shader();
 
+  // Starts rebuilding from the files on disk without blocking. The current
+  // program stays live until the new one has linked successfully.
   void reload();
+  // Swaps in a finished rebuild; returns true once a pending build resolved,
+  // whether or not it succeeded.
+  bool pollReload();
+  bool isReloading() const { return m_pending.program != 0; }
+
+  // Every file the last successful build read, including #includes.
+  const std::vector<std::string> &getDependencies() const {
+    return m_dependencies;
+  }
+
+  // False until a build has linked successfully.
+  bool isValid() const { return m_programID != 0; }
 
   void useShader() const;
 
@@ -33,9 +51,26 @@ private:
   std::string m_vertexPath;
   std::string m_fragmentPath;
   std::string m_computePath;
+  std::vector<std::string> m_defines;
+  std::vector<std::string> m_dependencies;
+
+  struct PendingBuild {
+    unsigned int program = 0;
+    std::vector<std::pair<unsigned int, std::string>> stages;
+    std::vector<unsigned int> shaders;
+    std::vector<std::string> dependencies;
+    uint64_t cacheKey = 0;
+    bool fromCache = false;
+  };
+  PendingBuild m_pending;
 
   mutable std::unordered_map<std::string, int> m_uniformLocationCache;
   int getUniformLocation(const std::string &name) const;
 
   void compile();
+  bool beginBuild(PendingBuild &build);
+  bool isBuildComplete(const PendingBuild &build) const;
+  bool finishBuild(PendingBuild &build);
+  void adopt(PendingBuild &build);
+  void discardBuild(PendingBuild &build);
 };
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "Graphics/ShaderCache.hpp"
+#include "Core/Hash.hpp"
+#include "Core/Log.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <glad/glad.h>
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x48535644; // "DVSH"
+constexpr uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint32_t binaryFormat;
+  uint32_t size;
+};
+
+std::filesystem::path cachePath(const std::string &directory, uint64_t key) {
+  return std::filesystem::path(directory) / (Hash::toHex(key) + ".dvs");
+}
+
+std::string glString(GLenum name) {
+  const char *str = reinterpret_cast<const char *>(glGetString(name));
+  return str ? str : "";
+}
+
+} // namespace
+
+bool ShaderCache::s_enabled = false;
+std::string ShaderCache::s_directory;
+uint64_t ShaderCache::s_driverHash = 0;
+
+void ShaderCache::init(bool enabled, const std::string &directory) {
+  int formatCount = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+  s_enabled = enabled && formatCount > 0;
+  s_directory = directory;
+
+  // A driver update invalidates every binary, so its identity is part of
+  // each key rather than something checked after the fact.
+  s_driverHash = Hash::fnv1a(glString(GL_VENDOR));
+  s_driverHash = Hash::fnv1a(glString(GL_RENDERER), s_driverHash);
+  s_driverHash = Hash::fnv1a(glString(GL_VERSION), s_driverHash);
+
+  if (enabled && formatCount == 0)
+    LOG_CORE_WARN("ShaderCache: driver exposes no program binary formats, "
+                  "cache disabled");
+}
+
+uint64_t ShaderCache::makeKey(const std::vector<std::string> &sources,
+                              const std::vector<std::string> &defines) {
+  uint64_t key = Hash::fnv1a(&CACHE_VERSION, sizeof(CACHE_VERSION),
+                             s_driverHash);
+  for (const auto &source : sources) {
+    uint64_t size = source.size();
+    key = Hash::fnv1a(&size, sizeof(size), key);
+    key = Hash::fnv1a(source, key);
+  }
+  for (const auto &define : defines)
+    key = Hash::fnv1a(define + "\n", key);
+  return key;
+}
+
+bool ShaderCache::load(uint64_t key, unsigned int program) {
+  if (!s_enabled)
+    return false;
+
+  std::ifstream file(cachePath(s_directory, key), std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  CacheHeader header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+      header.key != key)
+    return false;
+
+  std::vector<char> binary(header.size);
+  if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size())))
+    return false;
+
+  glProgramBinary(program, header.binaryFormat, binary.data(),
+                  static_cast<GLsizei>(binary.size()));
+
+  int success = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  return success;
+}
+
+bool ShaderCache::store(uint64_t key, unsigned int program) {
+  if (!s_enabled)
+    return false;
+
+  int length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return false;
+
+  std::vector<char> binary(length);
+  GLenum binaryFormat = 0;
+  glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+
+  std::error_code ec;
+  std::filesystem::create_directories(s_directory, ec);
+
+  auto path = cachePath(s_directory, key);
+  auto tmpPath = path;
+  tmpPath += ".tmp";
+
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      LOG_CORE_WARN("ShaderCache: Cannot write {0}", tmpPath.string());
+      return false;
+    }
+
+    CacheHeader header{CACHE_MAGIC, CACHE_VERSION, key, binaryFormat,
+                       static_cast<uint32_t>(length)};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(binary.data(), length);
+
+    if (!file)
+      return false;
+  }
+
+  std::filesystem::rename(tmpPath, path, ec);
+  return !ec;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// On-disk store for linked program binaries. Entries are keyed on the
+// preprocessed sources, the defines and the driver identity, and any binary
+// the driver refuses is simply recompiled from source.
+class ShaderCache {
+public:
+  // Must be called once a context is current.
+  static void init(bool enabled, const std::string &directory);
+
+  static uint64_t makeKey(const std::vector<std::string> &sources,
+                          const std::vector<std::string> &defines);
+
+  static bool load(uint64_t key, unsigned int program);
+  static bool store(uint64_t key, unsigned int program);
+
+private:
+  static bool s_enabled;
+  static std::string s_directory;
+  static uint64_t s_driverHash;
+};
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "Graphics/ShadowMap.hpp"
+#include "Graphics/GeometryManager.hpp"
+
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+// GL cube map face order: +X, -X, +Y, -Y, +Z, -Z.
+const glm::vec3 FACE_DIRECTIONS[6] = {
+    {1.0f, 0.0f, 0.0f},  {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+    {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},  {0.0f, 0.0f, -1.0f}};
+const glm::vec3 FACE_UPS[6] = {
+    {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+    {0.0f, 0.0f, -1.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}};
+
+unsigned int createCubeDepthTexture(int size, bool compare) {
+  unsigned int texture;
+  glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &texture);
+  glTextureStorage2D(texture, 1, GL_DEPTH_COMPONENT32F, size, size);
+  glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTextureParameteri(texture, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+  if (compare) {
+    glTextureParameteri(texture, GL_TEXTURE_COMPARE_MODE,
+                        GL_COMPARE_REF_TO_TEXTURE);
+    glTextureParameteri(texture, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+  }
+  return texture;
+}
+
+} // namespace
+
+ShadowMap::~ShadowMap() {
+  glDeleteFramebuffers(1, &m_framebuffer);
+  glDeleteBuffers(1, &m_ubo);
+  glDeleteTextures(1, &m_staticTexture);
+  glDeleteTextures(1, &m_texture);
+}
+
+void ShadowMap::init() {
+  glCreateFramebuffers(1, &m_framebuffer);
+  glNamedFramebufferDrawBuffer(m_framebuffer, GL_NONE);
+  glNamedFramebufferReadBuffer(m_framebuffer, GL_NONE);
+
+  glCreateBuffers(1, &m_ubo);
+  glNamedBufferStorage(m_ubo, sizeof(ShadowDataUBOLayout), nullptr,
+                       GL_DYNAMIC_STORAGE_BIT);
+}
+
+void ShadowMap::setSettings(bool enabled, int size, float farPlane) {
+  if (farPlane != m_farPlane)
+    m_facesValid = false;
+  m_enabled = enabled;
+  m_size = std::max(size, 16);
+  m_farPlane = std::max(farPlane, NEAR_PLANE * 2.0f);
+  m_uboDirty = true;
+}
+
+void ShadowMap::invalidate() {
+  std::fill(std::begin(m_staticDirty), std::end(m_staticDirty), true);
+  m_casters.clear();
+}
+
+void ShadowMap::resize(int size) {
+  glDeleteTextures(1, &m_staticTexture);
+  glDeleteTextures(1, &m_texture);
+  m_staticTexture = createCubeDepthTexture(size, false);
+  m_texture = createCubeDepthTexture(size, true);
+  m_textureSize = size;
+  m_uboDirty = true;
+  invalidate();
+}
+
+void ShadowMap::updateFaces(const glm::vec3 &lightPos) {
+  const glm::mat4 projection =
+      glm::perspective(glm::radians(90.0f), 1.0f, NEAR_PLANE, m_farPlane);
+  for (int f = 0; f < FACES; f++) {
+    m_faceViewProjection[f] =
+        projection *
+        glm::lookAt(lightPos, lightPos + FACE_DIRECTIONS[f], FACE_UPS[f]);
+    m_faceFrustum[f] = Frustum::fromMatrix(m_faceViewProjection[f]);
+  }
+  m_lightPos = lightPos;
+  m_facesValid = true;
+  m_uboDirty = true;
+}
+
+void ShadowMap::markFaces(const BoundingBox &bounds) {
+  for (int f = 0; f < FACES; f++) {
+    if (!m_staticDirty[f] && m_faceFrustum[f].intersectsBox(bounds))
+      m_staticDirty[f] = true;
+  }
+}
+
+void ShadowMap::update(const std::vector<Entity> &entities,
+                       const glm::vec3 &lightPos, const glm::vec4 *planes,
+                       int planeCount) {
+  m_staticFacesDrawn = 0;
+  m_dynamicFacesDrawn = 0;
+
+  const bool active = m_enabled && m_shader && m_shader->isValid();
+  if (active != m_active) {
+    m_active = active;
+    m_uboDirty = true;
+  }
+
+  if (active) {
+    if (m_textureSize != m_size)
+      resize(m_size);
+    if (!m_facesValid || lightPos != m_lightPos) {
+      updateFaces(lightPos);
+      invalidate();
+    }
+    if (m_planes.size() != static_cast<size_t>(planeCount) ||
+        !std::equal(m_planes.begin(), m_planes.end(), planes)) {
+      m_planes.assign(planes, planes + planeCount);
+      invalidate();
+    }
+  }
+
+  if (m_uboDirty) {
+    ShadowDataUBOLayout shadowData;
+    shadowData.light = glm::vec4(m_lightPos, active ? m_farPlane : 0.0f);
+    // Roughly 1.5 texels at any distance, as a fraction of that distance.
+    shadowData.params = glm::vec4(3.0f / m_size, 0.0f, 0.0f, 0.0f);
+    glNamedBufferSubData(m_ubo, 0, sizeof(shadowData), &shadowData);
+    m_uboDirty = false;
+  }
+  if (!active)
+    return;
+
+  // Static casters that appeared, moved, changed or went away dirty the
+  // faces covering both where they were and where they are.
+  if (entities.size() < m_casters.size())
+    invalidate();
+  m_casters.resize(entities.size());
+  m_dynamicCasters.clear();
+  for (size_t i = 0; i < entities.size(); i++) {
+    const Entity &entity = entities[i];
+    Caster &caster = m_casters[i];
+    const bool casts = entity.mesh && entity.material &&
+                       !entity.material->isTransparent();
+    const glm::mat4 &model = entity.transform.getModelMatrix();
+
+    if (casts && entity.dynamic) {
+      if (caster.mesh && !caster.dynamic)
+        markFaces(caster.bounds);
+      caster.mesh = entity.mesh;
+      caster.model = model;
+      caster.bounds = entity.mesh->getBounds().transformed(model);
+      caster.dynamic = true;
+      m_dynamicCasters.push_back(i);
+      continue;
+    }
+
+    const std::shared_ptr<Mesh> mesh = casts ? entity.mesh : nullptr;
+    if (caster.mesh == mesh && !caster.dynamic &&
+        (!mesh || caster.model == model))
+      continue;
+
+    if (caster.mesh && !caster.dynamic)
+      markFaces(caster.bounds);
+    caster.mesh = mesh;
+    caster.dynamic = false;
+    if (mesh) {
+      caster.model = model;
+      caster.bounds = mesh->getBounds().transformed(model);
+      markFaces(caster.bounds);
+    }
+  }
+
+  bool dynamicFace[FACES] = {};
+  bool anyWork = false;
+  for (int f = 0; f < FACES; f++) {
+    for (size_t i : m_dynamicCasters) {
+      if (m_faceFrustum[f].intersectsBox(m_casters[i].bounds)) {
+        dynamicFace[f] = true;
+        break;
+      }
+    }
+    anyWork = anyWork || m_staticDirty[f] || dynamicFace[f] || m_hadDynamic[f];
+  }
+  if (!anyWork)
+    return;
+
+  m_objects.clear();
+  m_objectOf.assign(m_casters.size(), 0);
+  for (size_t i = 0; i < m_casters.size(); i++) {
+    if (!m_casters[i].mesh)
+      continue;
+    ObjectData object{};
+    object.model = m_casters[i].model;
+    m_objectOf[i] = static_cast<uint32_t>(m_objects.size());
+    m_objects.push_back(object);
+  }
+  m_objectBuffer.upload(m_objects);
+  m_objectBuffer.bind();
+
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glViewport(0, 0, m_textureSize, m_textureSize);
+  glDepthMask(GL_TRUE);
+  glBindVertexArray(GeometryManager::get().getGlobalVAO());
+  for (int i = 0; i < planeCount; i++)
+    glEnable(GL_CLIP_DISTANCE0 + i);
+
+  m_shader->useShader();
+  m_shader->setUniformVec3("u_LightPos", lightPos);
+  m_shader->setUniformFloat("u_FarPlane", m_farPlane);
+
+  const float farthest = 1.0f;
+  for (int f = 0; f < FACES; f++) {
+    const bool staticDirty = m_staticDirty[f];
+    if (staticDirty) {
+      glNamedFramebufferTextureLayer(m_framebuffer, GL_DEPTH_ATTACHMENT,
+                                     m_staticTexture, 0, f);
+      glClearNamedFramebufferfv(m_framebuffer, GL_DEPTH, 0, &farthest);
+      drawCasters(f, false);
+      m_staticDirty[f] = false;
+      m_staticFacesDrawn++;
+    }
+
+    // The sampled cube starts from the cached face and gains the dynamic
+    // casters; a face they just left is reset to the cache.
+    if (!staticDirty && !dynamicFace[f] && !m_hadDynamic[f])
+      continue;
+    glCopyImageSubData(m_staticTexture, GL_TEXTURE_CUBE_MAP, 0, 0, 0, f,
+                       m_texture, GL_TEXTURE_CUBE_MAP, 0, 0, 0, f,
+                       m_textureSize, m_textureSize, 1);
+    if (dynamicFace[f]) {
+      glNamedFramebufferTextureLayer(m_framebuffer, GL_DEPTH_ATTACHMENT,
+                                     m_texture, 0, f);
+      drawCasters(f, true);
+      m_dynamicFacesDrawn++;
+    }
+    m_hadDynamic[f] = dynamicFace[f];
+  }
+
+  for (int i = 0; i < planeCount; i++)
+    glDisable(GL_CLIP_DISTANCE0 + i);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void ShadowMap::drawCasters(int face, bool dynamic) const {
+  m_shader->setUniformMat4("u_LightViewProjection",
+                           m_faceViewProjection[face]);
+  for (size_t i = 0; i < m_casters.size(); i++) {
+    const Caster &caster = m_casters[i];
+    if (!caster.mesh || caster.dynamic != dynamic ||
+        !m_faceFrustum[face].intersectsBox(caster.bounds))
+      continue;
+    caster.mesh->drawGeometry(m_objectOf[i]);
+  }
+}
+
+void ShadowMap::bind() const {
+  glBindBufferBase(GL_UNIFORM_BUFFER, UBO_BINDING, m_ubo);
+  if (m_texture != 0)
+    glBindTextureUnit(TEXTURE_UNIT, m_texture);
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Graphics/BoundingBox.hpp"
+#include "Graphics/Frustum.hpp"
+#include "Graphics/ObjectBuffer.hpp"
+#include "Graphics/Shader.hpp"
+#include "Scene/Scene.hpp"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+// std140 layout of the ShadowData block (shadows.glsl).
+struct ShadowDataUBOLayout {
+  glm::vec4 light;
+  glm::vec4 params;
+};
+
+// Cube shadow map for the scene's main light. Static casters are rendered
+// into a cached cube that is only redrawn face by face, when the light, the
+// clipping planes or a caster touching that face change. Entities flagged
+// dynamic are drawn every frame on top of a copy of the cached faces they
+// reach, so a scene that does not move costs nothing after the first frame.
+class ShadowMap {
+public:
+  static constexpr unsigned int UBO_BINDING = 3;
+  static constexpr unsigned int TEXTURE_UNIT = 15;
+
+  ShadowMap() = default;
+  ~ShadowMap();
+
+  ShadowMap(const ShadowMap &) = delete;
+  ShadowMap &operator=(const ShadowMap &) = delete;
+
+  void init();
+  void setShader(std::shared_ptr<Shader> shader) {
+    m_shader = std::move(shader);
+  }
+  void setSettings(bool enabled, int size, float farPlane);
+  bool isEnabled() const { return m_enabled; }
+
+  // Redraws whatever changed since the last frame. Rebinds the object
+  // buffer binding and the framebuffer, restoring the viewport.
+  void update(const std::vector<Entity> &entities, const glm::vec3 &lightPos,
+              const glm::vec4 *planes, int planeCount);
+  void bind() const;
+  void invalidate();
+
+  int getStaticFacesDrawn() const { return m_staticFacesDrawn; }
+  int getDynamicFacesDrawn() const { return m_dynamicFacesDrawn; }
+
+private:
+  static constexpr int FACES = 6;
+  static constexpr float NEAR_PLANE = 0.05f;
+
+  struct Caster {
+    std::shared_ptr<Mesh> mesh;
+    glm::mat4 model = glm::mat4(1.0f);
+    BoundingBox bounds;
+    bool dynamic = false;
+  };
+
+  std::shared_ptr<Shader> m_shader;
+  bool m_enabled = true;
+  bool m_active = false;
+  int m_size = 1024;
+  float m_farPlane = 50.0f;
+
+  unsigned int m_framebuffer = 0;
+  unsigned int m_ubo = 0;
+  // Static casters only, and the map that is sampled: static plus dynamic.
+  unsigned int m_staticTexture = 0;
+  unsigned int m_texture = 0;
+  int m_textureSize = 0;
+
+  glm::vec3 m_lightPos = glm::vec3(0.0f);
+  std::vector<glm::vec4> m_planes;
+  glm::mat4 m_faceViewProjection[FACES];
+  Frustum m_faceFrustum[FACES];
+  bool m_facesValid = false;
+
+  std::vector<Caster> m_casters;
+  std::vector<size_t> m_dynamicCasters;
+  bool m_staticDirty[FACES] = {};
+  bool m_hadDynamic[FACES] = {};
+  bool m_uboDirty = true;
+
+  ObjectBuffer m_objectBuffer;
+  std::vector<ObjectData> m_objects;
+  std::vector<uint32_t> m_objectOf;
+
+  int m_staticFacesDrawn = 0;
+  int m_dynamicFacesDrawn = 0;
+
+  void resize(int size);
+  void updateFaces(const glm::vec3 &lightPos);
+  void markFaces(const BoundingBox &bounds);
+  void drawCasters(int face, bool dynamic) const;
+};
\ No newline at end of file
@@ -1,121 +1,519 @@
 #include "Graphics/Texture.hpp"
 #include "Core/Log.hpp"
+#include "Graphics/GLCapabilities.hpp"
+#include "Graphics/TextureArrayPool.hpp"
+#include "Graphics/TextureCache.hpp"
+#include "Graphics/TextureCompressor.hpp"
+#include "Graphics/TextureStreamer.hpp"
 
 #include "stb_image.h"
 #include <algorithm>
 #include <cmath>
 #include <glad/glad.h>
 
-Texture::Texture(const std::string &textureFilePath) {
-  LOG_CORE_TRACE("Loading texture: {0}", textureFilePath);
-
-  glCreateTextures(GL_TEXTURE_2D, 1, &m_textureID);
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
 
-  stbi_set_flip_vertically_on_load(true);
-  unsigned char *texData =
-      stbi_load(textureFilePath.c_str(), &m_width, &m_height, &m_BPP, 0);
-  m_path = textureFilePath;
+unsigned int Texture::toGLInternalFormat(TextureFormat format) {
+  switch (format) {
+  case TextureFormat::RGBA8:
+  case TextureFormat::RGB8:
+    return GL_RGBA8;
+  case TextureFormat::R8:
+    return GL_R8;
+  case TextureFormat::BC1:
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+  case TextureFormat::BC3:
+    return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  case TextureFormat::BC4:
+    return GL_COMPRESSED_RED_RGTC1;
+  case TextureFormat::BC5:
+    return GL_COMPRESSED_RG_RGTC2;
+  case TextureFormat::BC7:
+    return GL_COMPRESSED_RGBA_BPTC_UNORM;
+  }
+  return GL_RGBA8;
+}
 
-  bool loadedSuccessfully = false;
+namespace {
 
-  if (texData) {
-    GLenum internalFormat = 0;
-    GLenum dataFormat = 0;
+std::vector<unsigned char> downsample(const std::vector<unsigned char> &src,
+                                      int width, int height, bool normalMap) {
+  int outWidth = std::max(1, width / 2);
+  int outHeight = std::max(1, height / 2);
+  std::vector<unsigned char> out(static_cast<size_t>(outWidth) * outHeight *
+                                 4);
 
-    if (m_BPP == 4) {
-      internalFormat = GL_RGBA8;
-      dataFormat = GL_RGBA;
-    } else if (m_BPP == 3) {
-      internalFormat = GL_RGBA8;
-      dataFormat = GL_RGB;
+  for (int y = 0; y < outHeight; y++) {
+    int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+    for (int x = 0; x < outWidth; x++) {
+      int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+      unsigned char *dst = &out[(static_cast<size_t>(y) * outWidth + x) * 4];
+      for (int ch = 0; ch < 4; ch++) {
+        int sum = src[(static_cast<size_t>(y0) * width + x0) * 4 + ch] +
+                  src[(static_cast<size_t>(y0) * width + x1) * 4 + ch] +
+                  src[(static_cast<size_t>(y1) * width + x0) * 4 + ch] +
+                  src[(static_cast<size_t>(y1) * width + x1) * 4 + ch];
+        dst[ch] = static_cast<unsigned char>((sum + 2) / 4);
+      }
 
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    } else if (m_BPP == 1) {
-      internalFormat = GL_R8;
-      dataFormat = GL_RED;
+      if (normalMap) {
+        float n[3];
+        float len = 0.0f;
+        for (int ch = 0; ch < 3; ch++) {
+          n[ch] = dst[ch] / 127.5f - 1.0f;
+          len += n[ch] * n[ch];
+        }
+        len = std::sqrt(len);
+        if (len > 1e-4f) {
+          for (int ch = 0; ch < 3; ch++)
+            dst[ch] = static_cast<unsigned char>(
+                std::clamp((n[ch] / len + 1.0f) * 127.5f, 0.0f, 255.0f));
+        }
+      }
     }
+  }
+  return out;
+}
 
-    if (internalFormat != 0) {
-      glTextureParameteri(m_textureID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-      glTextureParameteri(m_textureID, GL_TEXTURE_WRAP_T, GL_REPEAT);
-      glTextureParameteri(m_textureID, GL_TEXTURE_MIN_FILTER,
-                          GL_LINEAR_MIPMAP_LINEAR);
-      glTextureParameteri(m_textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+// Builds the mip chain (block-compressed when enabled) from freshly decoded
+// RGBA pixels, which it takes ownership of.
+TextureData bakeData(unsigned char *pixels, int width, int height,
+                     int channels, TextureType type,
+                     const TextureConfig &config) {
+  TextureData data;
+  std::vector<unsigned char> rgba(pixels,
+                                  pixels + static_cast<size_t>(width) *
+                                               height * 4);
+  stbi_image_free(pixels);
 
-      GLsizei levels = 1 + static_cast<GLsizei>(std::floor(
-                               std::log2(std::max(m_width, m_height))));
+  data.width = width;
+  data.height = height;
+  data.channels = channels;
 
-      glTextureStorage2D(m_textureID, levels, internalFormat, m_width,
-                         m_height);
+  bool hasAlpha = false;
+  for (size_t i = 3; i < rgba.size() && !hasAlpha; i += 4)
+    hasAlpha = rgba[i] != 255;
 
-      glTextureSubImage2D(m_textureID, 0, 0, 0, m_width, m_height, dataFormat,
-                          GL_UNSIGNED_BYTE, texData);
+  if (config.Compress)
+    data.format = TextureCompressor::selectFormat(type, hasAlpha, config);
+  else
+    data.format = channels == 1 ? TextureFormat::R8 : TextureFormat::RGBA8;
 
-      glGenerateTextureMipmap(m_textureID);
+  if (data.format == TextureFormat::BC4 && channels >= 3) {
+    for (size_t i = 0; i < rgba.size(); i += 4)
+      rgba[i] = static_cast<unsigned char>(
+          (rgba[i] * 54 + rgba[i + 1] * 183 + rgba[i + 2] * 19 + 128) >> 8);
+  }
 
-      if (m_BPP == 1) {
-        glTextureParameteri(m_textureID, GL_TEXTURE_SWIZZLE_R, GL_RED);
-        glTextureParameteri(m_textureID, GL_TEXTURE_SWIZZLE_G, GL_RED);
-        glTextureParameteri(m_textureID, GL_TEXTURE_SWIZZLE_B, GL_RED);
-        glTextureParameteri(m_textureID, GL_TEXTURE_SWIZZLE_A, GL_ONE);
-      }
+  const bool isNormalMap = type == TextureType::Normal;
+  int levelWidth = width, levelHeight = height;
+  std::vector<unsigned char> level = std::move(rgba);
 
-      if (m_BPP == 3)
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  while (true) {
+    TextureLevel out;
+    out.width = levelWidth;
+    out.height = levelHeight;
 
-      LOG_CORE_INFO("Texture loaded: {0} ({1}x{2}, {3} channel(s))",
-                    textureFilePath, m_width, m_height, m_BPP);
-      loadedSuccessfully = true;
+    if (TextureCompressor::isCompressed(data.format)) {
+      out.data = TextureCompressor::compress(level.data(), levelWidth,
+                                             levelHeight, data.format);
+      if (data.levels.empty())
+        data.psnr = TextureCompressor::measurePSNR(
+            level.data(), out.data, levelWidth, levelHeight, data.format);
+    } else if (data.format == TextureFormat::R8) {
+      out.data.resize(static_cast<size_t>(levelWidth) * levelHeight);
+      for (size_t i = 0; i < out.data.size(); i++)
+        out.data[i] = level[i * 4];
     } else {
-      LOG_CORE_ERROR("Texture {0} has unsupported BPP: {1}", textureFilePath,
-                     m_BPP);
+      out.data = level;
     }
+    data.levels.push_back(std::move(out));
+
+    if (levelWidth == 1 && levelHeight == 1)
+      break;
 
-    stbi_image_free(texData);
+    level = downsample(level, levelWidth, levelHeight, isNormalMap);
+    levelWidth = std::max(1, levelWidth / 2);
+    levelHeight = std::max(1, levelHeight / 2);
   }
 
-  if (!loadedSuccessfully) {
+  return data;
+}
+
+TextureData withContentHash(TextureData data, TextureType type) {
+  if (data.levels.empty())
+    return data;
+  Hash128 seed;
+  seed.low = static_cast<uint64_t>(data.format) << 32 |
+             static_cast<uint64_t>(type);
+  seed.high = static_cast<uint64_t>(data.width) << 32 |
+              static_cast<uint64_t>(data.height);
+  const std::vector<unsigned char> &texels = data.levels[0].data;
+  data.contentHash = Hash::content128(texels.data(), texels.size(), seed);
+  return data;
+}
+
+} // namespace
+
+TextureData Texture::loadData(const std::string &textureFilePath,
+                              TextureType type, const TextureConfig &config) {
+  uint64_t cacheKey = 0;
+  if (config.Compress) {
+    cacheKey = TextureCache::makeKey(textureFilePath, type, config);
+    TextureData cached;
+    if (TextureCache::load(config.CacheDirectory, cacheKey, cached)) {
+      LOG_CORE_TRACE("Texture cache hit: {0}", textureFilePath);
+      return withContentHash(std::move(cached), type);
+    }
+  }
+
+  int width = 0, height = 0, channels = 0;
+  stbi_set_flip_vertically_on_load_thread(1);
+  unsigned char *pixels =
+      stbi_load(textureFilePath.c_str(), &width, &height, &channels, 4);
+  if (!pixels)
+    return {};
+
+  TextureData data = bakeData(pixels, width, height, channels, type, config);
+  if (config.Compress)
+    TextureCache::store(config.CacheDirectory, cacheKey, data);
+
+  return withContentHash(std::move(data), type);
+}
+
+TextureData Texture::loadData(const unsigned char *encoded, size_t size,
+                              TextureType type, const TextureConfig &config) {
+  uint64_t cacheKey = 0;
+  if (config.Compress) {
+    cacheKey = TextureCache::makeKey(encoded, size, type, config);
+    TextureData cached;
+    if (TextureCache::load(config.CacheDirectory, cacheKey, cached))
+      return withContentHash(std::move(cached), type);
+  }
+
+  int width = 0, height = 0, channels = 0;
+  stbi_set_flip_vertically_on_load_thread(1);
+  unsigned char *pixels =
+      stbi_load_from_memory(encoded, static_cast<int>(size), &width, &height,
+                            &channels, 4);
+  if (!pixels)
+    return {};
+
+  TextureData data = bakeData(pixels, width, height, channels, type, config);
+  if (config.Compress)
+    TextureCache::store(config.CacheDirectory, cacheKey, data);
+
+  return withContentHash(std::move(data), type);
+}
+
+Texture::Texture(const std::string &textureFilePath, TextureType type,
+                 const TextureConfig &config)
+    : m_path(textureFilePath), m_type(type) {
+  LOG_CORE_TRACE("Loading texture: {0}", textureFilePath);
+
+  if (!upload(loadData(textureFilePath, type, config), config)) {
     LOG_CORE_ERROR("Failed to load texture {0}. Using fallback.",
                    textureFilePath);
+    createFallback();
+  }
+}
+
+Texture::Texture(const std::string &textureFilePath, TextureType type,
+                 TextureData data, const TextureConfig &config)
+    : m_path(textureFilePath), m_type(type) {
+  if (!upload(std::move(data), config)) {
+    LOG_CORE_ERROR("Failed to load texture {0}. Using fallback.",
+                   textureFilePath);
+    createFallback();
+  }
+}
+
+bool Texture::upload(TextureData data, const TextureConfig &config) {
+  if (data.levels.empty() || data.width <= 0 || data.height <= 0)
+    return false;
+
+  m_width = data.width;
+  m_height = data.height;
+  m_BPP = data.channels;
+  m_format = data.format;
+  m_data = std::move(data);
+
+  const int levelCount = getLevelCount();
+
+  // Streamed textures start from the largest mip that fits the initial size
+  // and let the streamer raise residency once they are actually on screen.
+  m_floorLevel = 0;
+  if (config.Streaming) {
+    while (m_floorLevel < levelCount - 1 &&
+           std::max(m_data.levels[m_floorLevel].width,
+                    m_data.levels[m_floorLevel].height) >
+               config.StreamingInitialSize)
+      m_floorLevel++;
+  }
+
+  m_residentLevel = levelCount;
+  setResidentLevel(m_floorLevel);
+
+  size_t fullSize = 0;
+  for (int i = 0; i < levelCount; i++)
+    fullSize += getLevelMemorySize(i);
+
+  if (TextureCompressor::isCompressed(m_format)) {
+    size_t rawSize = static_cast<size_t>(m_width) * m_height * 4 * 4 / 3;
+    LOG_CORE_INFO("Texture loaded: {0} ({1}x{2}, {3}, {4} mips, PSNR {5:.2f} "
+                  "dB, {6} KB vs {7} KB as RGBA8)",
+                  m_path, m_width, m_height,
+                  TextureCompressor::formatName(m_format), levelCount,
+                  m_data.psnr, fullSize / 1024, rawSize / 1024);
+  } else {
+    LOG_CORE_INFO("Texture loaded: {0} ({1}x{2}, {3} channel(s))", m_path,
+                  m_width, m_height, m_BPP);
+  }
+
+  if (config.Streaming && levelCount > 1) {
+    m_streamed = true;
+    TextureStreamer::get().registerTexture(this);
+  } else {
+    m_data.levels.clear();
+    m_data.levels.shrink_to_fit();
+  }
+
+  return true;
+}
+
+size_t Texture::getLevelMemorySize(int level) const {
+  if (level < 0 || level >= getLevelCount())
+    return 0;
+  const TextureLevel &l = m_data.levels[level];
+  if (TextureCompressor::isCompressed(m_format))
+    return l.data.size();
+  return static_cast<size_t>(l.width) * l.height *
+         (m_format == TextureFormat::R8 ? 1 : 4);
+}
+
+void Texture::setResidentLevel(int level) {
+  const int levelCount = getLevelCount();
+  if (levelCount == 0)
+    return;
+
+  level = std::clamp(level, 0, levelCount - 1);
+  if (level == m_residentLevel)
+    return;
+
+  // Immutable storage cannot shrink or grow, so a residency change moves the
+  // texture into a new object sized for the new top mip. Levels that are
+  // already resident are copied on the GPU; only new ones are uploaded.
+  const GLenum internalFormat = toGLInternalFormat(m_format);
+  const TextureLevel &top = m_data.levels[level];
+
+  unsigned int textureID = 0;
+  glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+  glTextureStorage2D(textureID, levelCount - level, internalFormat, top.width,
+                     top.height);
+
+  for (int i = level; i < levelCount; i++) {
+    const TextureLevel &l = m_data.levels[i];
+    if (m_textureID != 0 && i >= m_residentLevel) {
+      glCopyImageSubData(m_textureID, GL_TEXTURE_2D, i - m_residentLevel, 0, 0,
+                         0, textureID, GL_TEXTURE_2D, i - level, 0, 0, 0,
+                         l.width, l.height, 1);
+    } else {
+      uploadLevel(textureID, i, i - level);
+    }
+  }
+
+  applyParameters(textureID, m_format);
+
+  dropBindlessHandle();
+  glDeleteTextures(1, &m_textureID);
+  m_textureID = textureID;
+  m_residentLevel = level;
+  m_gpuLevelCount = levelCount - level;
+
+  m_memorySize = 0;
+  for (int i = level; i < levelCount; i++)
+    m_memorySize += getLevelMemorySize(i);
+}
 
-    unsigned char magenta[] = {255, 0, 255, 255};
+void Texture::requestScreenSize(float pixels) {
+  if (!m_streamed || pixels <= 0.0f)
+    return;
 
-    m_width = 1;
-    m_height = 1;
-    m_BPP = 4;
+  float ratio = static_cast<float>(std::max(m_width, m_height)) / pixels;
+  int level = ratio <= 1.0f ? 0 : static_cast<int>(std::floor(std::log2(ratio)));
+  level = std::min(level, getLevelCount() - 1);
+  m_requestedLevel = std::min(m_requestedLevel, level);
+}
 
-    glTextureStorage2D(m_textureID, 1, GL_RGBA8, 1, 1);
-    glTextureSubImage2D(m_textureID, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE,
-                        magenta);
+void Texture::uploadLevel(unsigned int textureID, int sourceLevel,
+                          int targetLevel) {
+  const TextureLevel &level = m_data.levels[sourceLevel];
 
-    glTextureParameteri(m_textureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTextureParameteri(m_textureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTextureParameteri(m_textureID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTextureParameteri(m_textureID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  if (TextureCompressor::isCompressed(m_format)) {
+    glCompressedTextureSubImage2D(
+        textureID, targetLevel, 0, 0, level.width, level.height,
+        toGLInternalFormat(m_format), static_cast<GLsizei>(level.data.size()),
+        level.data.data());
+    return;
   }
+
+  if (m_format == TextureFormat::R8)
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  glTextureSubImage2D(textureID, targetLevel, 0, 0, level.width, level.height,
+                      m_format == TextureFormat::R8 ? GL_RED : GL_RGBA,
+                      GL_UNSIGNED_BYTE, level.data.data());
+
+  if (m_format == TextureFormat::R8)
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
-Texture::~Texture() { glDeleteTextures(1, &m_textureID); }
+void Texture::applyParameters(unsigned int textureID, TextureFormat format) {
+  glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER,
+                      GL_LINEAR_MIPMAP_LINEAR);
+  glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  if (format == TextureFormat::R8 || format == TextureFormat::BC4) {
+    glTextureParameteri(textureID, GL_TEXTURE_SWIZZLE_R, GL_RED);
+    glTextureParameteri(textureID, GL_TEXTURE_SWIZZLE_G, GL_RED);
+    glTextureParameteri(textureID, GL_TEXTURE_SWIZZLE_B, GL_RED);
+    glTextureParameteri(textureID, GL_TEXTURE_SWIZZLE_A, GL_ONE);
+  }
+}
+
+void Texture::createFallback() {
+  glCreateTextures(GL_TEXTURE_2D, 1, &m_textureID);
+
+  unsigned char magenta[] = {255, 0, 255, 255};
+
+  m_width = 1;
+  m_height = 1;
+  m_BPP = 4;
+  m_format = TextureFormat::RGBA8;
+  m_memorySize = 4;
+  m_gpuLevelCount = 1;
+
+  glTextureStorage2D(m_textureID, 1, GL_RGBA8, 1, 1);
+  glTextureSubImage2D(m_textureID, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                      magenta);
+
+  glTextureParameteri(m_textureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTextureParameteri(m_textureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTextureParameteri(m_textureID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTextureParameteri(m_textureID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+uint64_t Texture::getBindlessHandle() {
+  if (m_bindlessHandle == 0 && m_textureID != 0 &&
+      GLCapabilities::supportsBindlessTextures()) {
+    m_bindlessHandle = GLCapabilities::getTextureHandle(m_textureID);
+    GLCapabilities::makeTextureHandleResident(m_bindlessHandle, true);
+  }
+  return m_bindlessHandle;
+}
+
+void Texture::dropBindlessHandle() {
+  // A resident handle keeps the old storage alive, so release it before the
+  // texture object goes away.
+  GLCapabilities::makeTextureHandleResident(m_bindlessHandle, false);
+  m_bindlessHandle = 0;
+}
+
+void Texture::setArrayLocation(int index, int layer) {
+  m_arrayIndex = index;
+  m_arrayLayer = layer;
+}
+
+void Texture::releaseStorage() {
+  if (m_streamed) {
+    TextureStreamer::get().unregisterTexture(this);
+    m_streamed = false;
+  }
+  dropBindlessHandle();
+  glDeleteTextures(1, &m_textureID);
+  m_textureID = 0;
+}
+
+Texture::~Texture() {
+  if (m_streamed)
+    TextureStreamer::get().unregisterTexture(this);
+  if (m_arrayIndex >= 0)
+    TextureArrayPool::get().release(m_arrayIndex, m_arrayLayer);
+  dropBindlessHandle();
+  glDeleteTextures(1, &m_textureID);
+}
 
 Texture::Texture(Texture &&other) noexcept {
   m_textureID = other.m_textureID;
   m_width = other.m_width;
   m_height = other.m_height;
   m_BPP = other.m_BPP;
+  m_path = std::move(other.m_path);
+  m_type = other.m_type;
+  m_format = other.m_format;
+  m_memorySize = other.m_memorySize;
+  m_data = std::move(other.m_data);
+  m_residentLevel = other.m_residentLevel;
+  m_floorLevel = other.m_floorLevel;
+  m_requestedLevel = other.m_requestedLevel;
+  m_streamed = other.m_streamed;
+  m_gpuLevelCount = other.m_gpuLevelCount;
+  m_bindlessHandle = other.m_bindlessHandle;
+  m_arrayIndex = other.m_arrayIndex;
+  m_arrayLayer = other.m_arrayLayer;
 
   other.m_textureID = 0;
+  other.m_bindlessHandle = 0;
+  other.m_arrayIndex = -1;
+  if (m_streamed) {
+    other.m_streamed = false;
+    TextureStreamer::get().unregisterTexture(&other);
+    TextureStreamer::get().registerTexture(this);
+  }
 }
 
 Texture &Texture::operator=(Texture &&other) noexcept {
   if (this != &other) {
+    if (m_streamed)
+      TextureStreamer::get().unregisterTexture(this);
+    if (m_arrayIndex >= 0)
+      TextureArrayPool::get().release(m_arrayIndex, m_arrayLayer);
+    dropBindlessHandle();
     glDeleteTextures(1, &m_textureID);
 
     m_textureID = other.m_textureID;
     m_width = other.m_width;
     m_height = other.m_height;
     m_BPP = other.m_BPP;
+    m_path = std::move(other.m_path);
+    m_type = other.m_type;
+    m_format = other.m_format;
+    m_memorySize = other.m_memorySize;
+    m_data = std::move(other.m_data);
+    m_residentLevel = other.m_residentLevel;
+    m_floorLevel = other.m_floorLevel;
+    m_requestedLevel = other.m_requestedLevel;
+    m_streamed = other.m_streamed;
+    m_gpuLevelCount = other.m_gpuLevelCount;
+    m_bindlessHandle = other.m_bindlessHandle;
+    m_arrayIndex = other.m_arrayIndex;
+    m_arrayLayer = other.m_arrayLayer;
 
     other.m_textureID = 0;
+    other.m_bindlessHandle = 0;
+    other.m_arrayIndex = -1;
+    if (m_streamed) {
+      other.m_streamed = false;
+      TextureStreamer::get().unregisterTexture(&other);
+      TextureStreamer::get().registerTexture(this);
+    }
   }
   return *this;
 }
@@ -1,12 +1,43 @@
 #pragma once
 
+#include "Config.hpp"
+#include "Core/Hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 enum class TextureType { None = 0, Diffuse, Specular, Normal, Height };
 
+enum class TextureFormat { RGBA8 = 0, RGB8, R8, BC1, BC3, BC4, BC5, BC7 };
+
+struct TextureLevel {
+  int width = 0;
+  int height = 0;
+  std::vector<unsigned char> data;
+};
+
+struct TextureData {
+  TextureFormat format = TextureFormat::RGBA8;
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  float psnr = 0.0f;
+  std::vector<TextureLevel> levels;
+  // Of the decoded texels, so one image stored under several paths is
+  // recognised; set by Texture::loadData.
+  Hash128 contentHash;
+};
+
 class Texture {
 public:
-  Texture(const std::string &textureFilePath);
+  Texture(const std::string &textureFilePath,
+          TextureType type = TextureType::Diffuse,
+          const TextureConfig &config = TextureConfig());
+  // Uploads data prepared off the main thread by loadData().
+  Texture(const std::string &textureFilePath, TextureType type,
+          TextureData data, const TextureConfig &config);
   ~Texture();
 
   Texture(const Texture &other) = delete;
@@ -15,6 +46,14 @@ public:
   Texture(Texture &&other) noexcept;
   Texture &operator=(Texture &&other) noexcept;
 
+  // CPU-only part of loading: decode, build the mip chain and, when enabled,
+  // block-compress it (or fetch the result from the bake cache).
+  static TextureData loadData(const std::string &textureFilePath,
+                              TextureType type, const TextureConfig &config);
+  // Same, for an encoded image (PNG, JPEG, ...) already in memory.
+  static TextureData loadData(const unsigned char *encoded, size_t size,
+                              TextureType type, const TextureConfig &config);
+
   void bind(unsigned int slot = 0);
 
   int getWidth() const { return m_width; }
@@ -22,10 +61,64 @@ public:
   std::string getPath() const { return m_path; }
   TextureType getType() const { return m_type; }
   void setType(TextureType type) { m_type = type; }
+  TextureFormat getFormat() const { return m_format; }
+  size_t getMemorySize() const { return m_memorySize; }
+  unsigned int getTextureID() const { return m_textureID; }
+  // Mips currently allocated on the GPU (the CPU chain may hold more).
+  int getGPULevelCount() const { return m_gpuLevelCount; }
+
+  // --- Streaming ---
+  // Level 0 is the full-resolution mip. Only levels at or below the resident
+  // level live on the GPU; the rest stay in the CPU-side mip chain.
+  int getLevelCount() const { return static_cast<int>(m_data.levels.size()); }
+  int getResidentLevel() const { return m_residentLevel; }
+  int getStreamingFloorLevel() const { return m_floorLevel; }
+  size_t getLevelMemorySize(int level) const;
+
+  void setResidentLevel(int level);
+
+  // Records the mip needed to cover `pixels` on screen this frame.
+  void requestScreenSize(float pixels);
+  int getRequestedLevel() const { return m_requestedLevel; }
+  void clearRequest() { m_requestedLevel = NO_REQUEST; }
+
+  static constexpr int NO_REQUEST = 1 << 30;
+
+  // --- Bindless / array binding ---
+  // Streaming reallocates storage, so the handle is re-created on demand
+  // after a residency change.
+  uint64_t getBindlessHandle();
+
+  int getArrayIndex() const { return m_arrayIndex; }
+  int getArrayLayer() const { return m_arrayLayer; }
+  void setArrayLocation(int index, int layer);
+  // Drops the standalone GL object once its contents live in an array.
+  void releaseStorage();
+
+  static unsigned int toGLInternalFormat(TextureFormat format);
+  static void applyParameters(unsigned int textureID, TextureFormat format);
 
 private:
-  unsigned int m_textureID;
-  int m_width, m_height, m_BPP;
+  unsigned int m_textureID = 0;
+  int m_width = 0, m_height = 0, m_BPP = 0;
   std::string m_path;
   TextureType m_type = TextureType::None;
+  TextureFormat m_format = TextureFormat::RGBA8;
+  size_t m_memorySize = 0;
+
+  TextureData m_data;
+  int m_residentLevel = 0;
+  int m_floorLevel = 0;
+  int m_requestedLevel = NO_REQUEST;
+  bool m_streamed = false;
+  int m_gpuLevelCount = 0;
+
+  uint64_t m_bindlessHandle = 0;
+  int m_arrayIndex = -1;
+  int m_arrayLayer = 0;
+
+  bool upload(TextureData data, const TextureConfig &config);
+  void uploadLevel(unsigned int textureID, int sourceLevel, int targetLevel);
+  void createFallback();
+  void dropBindlessHandle();
 };
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "Graphics/TextureArrayPool.hpp"
+#include "Core/Log.hpp"
+#include "Graphics/TextureCompressor.hpp"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+bool TextureArrayPool::add(Texture &texture) {
+  if (texture.getArrayIndex() >= 0)
+    return true;
+  if (texture.getTextureID() == 0)
+    return false;
+
+  int index = findOrCreate(texture);
+  if (index < 0) {
+    if (!m_warnedFull) {
+      LOG_CORE_WARN("TextureArrayPool: all {0} array slots are in use, {1} "
+                    "will render untextured",
+                    MAX_ARRAYS, texture.getPath());
+      m_warnedFull = true;
+    }
+    return false;
+  }
+
+  TextureArray &array = m_arrays[index];
+
+  int layer;
+  if (!array.freeLayers.empty()) {
+    layer = array.freeLayers.back();
+    array.freeLayers.pop_back();
+  } else {
+    if (array.layerCount == array.capacity)
+      grow(array);
+    layer = array.layerCount++;
+  }
+
+  for (int level = 0; level < array.levels; level++) {
+    glCopyImageSubData(texture.getTextureID(), GL_TEXTURE_2D, level, 0, 0, 0,
+                       array.textureID, GL_TEXTURE_2D_ARRAY, level, 0, 0,
+                       layer, std::max(1, array.width >> level),
+                       std::max(1, array.height >> level), 1);
+  }
+
+  texture.setArrayLocation(index, layer);
+  texture.releaseStorage();
+  return true;
+}
+
+void TextureArrayPool::release(int arrayIndex, int layer) {
+  if (arrayIndex < 0 || arrayIndex >= static_cast<int>(m_arrays.size()))
+    return;
+  m_arrays[arrayIndex].freeLayers.push_back(layer);
+}
+
+void TextureArrayPool::bind(unsigned int firstSlot) const {
+  for (size_t i = 0; i < m_arrays.size(); i++)
+    glBindTextureUnit(firstSlot + static_cast<unsigned int>(i),
+                      m_arrays[i].textureID);
+}
+
+void TextureArrayPool::shutdown() {
+  for (auto &array : m_arrays)
+    glDeleteTextures(1, &array.textureID);
+  m_arrays.clear();
+  m_warnedFull = false;
+}
+
+int TextureArrayPool::findOrCreate(const Texture &texture) {
+  for (size_t i = 0; i < m_arrays.size(); i++) {
+    const TextureArray &array = m_arrays[i];
+    if (array.format == texture.getFormat() &&
+        array.width == texture.getWidth() &&
+        array.height == texture.getHeight() &&
+        array.levels == texture.getGPULevelCount())
+      return static_cast<int>(i);
+  }
+
+  if (m_arrays.size() >= MAX_ARRAYS)
+    return -1;
+
+  TextureArray array;
+  array.format = texture.getFormat();
+  array.width = texture.getWidth();
+  array.height = texture.getHeight();
+  array.levels = texture.getGPULevelCount();
+  m_arrays.push_back(std::move(array));
+
+  LOG_CORE_TRACE("TextureArrayPool: new {0}x{1} {2} array ({3} mips)",
+                 texture.getWidth(), texture.getHeight(),
+                 TextureCompressor::formatName(texture.getFormat()),
+                 texture.getGPULevelCount());
+  return static_cast<int>(m_arrays.size() - 1);
+}
+
+void TextureArrayPool::grow(TextureArray &array) {
+  // Array storage is immutable too, so growing means a new object and a GPU
+  // copy of the layers already packed.
+  int capacity = std::max(4, array.capacity * 2);
+
+  unsigned int textureID = 0;
+  glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &textureID);
+  glTextureStorage3D(textureID, array.levels,
+                     Texture::toGLInternalFormat(array.format), array.width,
+                     array.height, capacity);
+  Texture::applyParameters(textureID, array.format);
+
+  if (array.textureID != 0 && array.layerCount > 0) {
+    for (int level = 0; level < array.levels; level++) {
+      glCopyImageSubData(array.textureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+                         textureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+                         std::max(1, array.width >> level),
+                         std::max(1, array.height >> level),
+                         array.layerCount);
+    }
+  }
+
+  glDeleteTextures(1, &array.textureID);
+  array.textureID = textureID;
+  array.capacity = capacity;
+}
\ No newline at end of file
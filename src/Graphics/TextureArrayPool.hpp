@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Graphics/Texture.hpp"
+
+#include <vector>
+
+// Packs textures that share a format, size and mip count into layers of a
+// GL_TEXTURE_2D_ARRAY, so one sampler per array covers every material.
+class TextureArrayPool {
+public:
+  static TextureArrayPool &get() {
+    static TextureArrayPool instance;
+    return instance;
+  }
+
+  // One texture unit per array; matches MAX_TEXTURE_ARRAYS in frag.glsl.
+  static constexpr int MAX_ARRAYS = 12;
+
+  // Copies the texture into a layer and frees its standalone storage.
+  // Returns false when every array slot is already taken by another shape.
+  bool add(Texture &texture);
+  void release(int arrayIndex, int layer);
+
+  void bind(unsigned int firstSlot = 0) const;
+  void shutdown();
+
+  int getArrayCount() const { return static_cast<int>(m_arrays.size()); }
+
+private:
+  TextureArrayPool() = default;
+
+  struct TextureArray {
+    TextureFormat format;
+    int width, height, levels;
+    unsigned int textureID = 0;
+    int layerCount = 0;
+    int capacity = 0;
+    std::vector<int> freeLayers;
+  };
+
+  std::vector<TextureArray> m_arrays;
+  bool m_warnedFull = false;
+
+  int findOrCreate(const Texture &texture);
+  void grow(TextureArray &array);
+};
\ No newline at end of file
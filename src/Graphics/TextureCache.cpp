@@ -0,0 +1,173 @@
+#include "Graphics/TextureCache.hpp"
+#include "Core/Hash.hpp"
+#include "Core/Log.hpp"
+#include "Graphics/GLCapabilities.hpp"
+#include "Graphics/TextureCompressor.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+constexpr uint32_t CACHE_MAGIC = 0x58545644; // "DVTX"
+constexpr uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t format;
+  int32_t width;
+  int32_t height;
+  int32_t channels;
+  uint32_t levelCount;
+  float psnr;
+};
+
+struct LevelHeader {
+  int32_t width;
+  int32_t height;
+  uint64_t size;
+};
+
+std::filesystem::path cachePath(const std::string &directory, uint64_t key) {
+  return std::filesystem::path(directory) / (Hash::toHex(key) + ".dvt");
+}
+
+} // namespace
+
+uint64_t TextureCache::makeKey(const std::string &sourcePath, TextureType type,
+                               const TextureConfig &config) {
+  std::error_code ec;
+  auto size = std::filesystem::file_size(sourcePath, ec);
+  auto time = std::filesystem::last_write_time(sourcePath, ec);
+  int64_t stamp = time.time_since_epoch().count();
+
+  uint64_t key = Hash::fnv1a(sourcePath);
+  key = Hash::fnv1a(&size, sizeof(size), key);
+  key = Hash::fnv1a(&stamp, sizeof(stamp), key);
+  return finishKey(key, type, config);
+}
+
+uint64_t TextureCache::makeKey(const unsigned char *encoded, size_t size,
+                               TextureType type, const TextureConfig &config) {
+  // Embedded images have no file of their own, so the bytes are the key.
+  return finishKey(Hash::fnv1a(encoded, size), type, config);
+}
+
+uint64_t TextureCache::finishKey(uint64_t key, TextureType type,
+                                 const TextureConfig &config) {
+  key = Hash::fnv1a(&type, sizeof(type), key);
+  // Anything that can change the selected format must be part of the key.
+  uint8_t variant = (config.HighQualityDiffuse ? 1 : 0) |
+                    (GLCapabilities::supportsS3TC() ? 2 : 0);
+  key = Hash::fnv1a(&variant, sizeof(variant), key);
+  key = Hash::fnv1a(&CACHE_VERSION, sizeof(CACHE_VERSION), key);
+  return key;
+}
+
+bool TextureCache::load(const std::string &directory, uint64_t key,
+                        TextureData &data) {
+  std::ifstream file(cachePath(directory, key),
+                     std::ios::binary | std::ios::ate);
+  if (!file.is_open())
+    return false;
+  uint64_t remaining = static_cast<uint64_t>(file.tellg());
+  file.seekg(0);
+
+  // A truncated or corrupt entry is a miss: nothing read from the file is
+  // trusted until it matches what the baker would have written.
+  CacheHeader header;
+  if (remaining < sizeof(header) ||
+      !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+      header.format > static_cast<uint32_t>(TextureFormat::BC7) ||
+      header.width <= 0 || header.height <= 0 || header.levelCount == 0)
+    return false;
+  remaining -= sizeof(header);
+
+  TextureData result;
+  result.format = static_cast<TextureFormat>(header.format);
+  result.width = header.width;
+  result.height = header.height;
+  result.channels = header.channels;
+  result.psnr = header.psnr;
+
+  // Levels form the full mip chain down to 1x1, as Texture::loadData bakes.
+  int width = header.width, height = header.height;
+  for (uint32_t i = 0; i < header.levelCount; i++) {
+    LevelHeader levelHeader;
+    if (remaining < sizeof(levelHeader) ||
+        !file.read(reinterpret_cast<char *>(&levelHeader),
+                   sizeof(levelHeader)))
+      return false;
+    remaining -= sizeof(levelHeader);
+
+    const uint64_t expected =
+        TextureCompressor::levelSize(result.format, width, height);
+    const bool last = i + 1 == header.levelCount;
+    if (levelHeader.width != width || levelHeader.height != height ||
+        levelHeader.size != expected || levelHeader.size > remaining ||
+        last != (width == 1 && height == 1))
+      return false;
+
+    TextureLevel level;
+    level.width = width;
+    level.height = height;
+    level.data.resize(static_cast<size_t>(levelHeader.size));
+    if (!file.read(reinterpret_cast<char *>(level.data.data()),
+                   static_cast<std::streamsize>(levelHeader.size)))
+      return false;
+    remaining -= levelHeader.size;
+    result.levels.push_back(std::move(level));
+
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+  }
+
+  data = std::move(result);
+  return true;
+}
+
+bool TextureCache::store(const std::string &directory, uint64_t key,
+                         const TextureData &data) {
+  std::error_code ec;
+  std::filesystem::create_directories(directory, ec);
+
+  auto path = cachePath(directory, key);
+  auto tmpPath = path;
+  tmpPath += ".tmp";
+
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      LOG_CORE_WARN("TextureCache: Cannot write {0}", tmpPath.string());
+      return false;
+    }
+
+    CacheHeader header{CACHE_MAGIC,
+                       CACHE_VERSION,
+                       static_cast<uint32_t>(data.format),
+                       data.width,
+                       data.height,
+                       data.channels,
+                       static_cast<uint32_t>(data.levels.size()),
+                       data.psnr};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    for (const auto &level : data.levels) {
+      LevelHeader levelHeader{level.width, level.height, level.data.size()};
+      file.write(reinterpret_cast<const char *>(&levelHeader),
+                 sizeof(levelHeader));
+      file.write(reinterpret_cast<const char *>(level.data.data()),
+                 static_cast<std::streamsize>(level.data.size()));
+    }
+
+    if (!file)
+      return false;
+  }
+
+  // Rename last so a crash mid-write never leaves a truncated entry behind.
+  std::filesystem::rename(tmpPath, path, ec);
+  return !ec;
+}
\ No newline at end of file
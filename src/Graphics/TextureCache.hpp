@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Graphics/Texture.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// On-disk store for baked (mip-mapped and block-compressed) textures, so the
+// encoder only runs the first time a given source image is seen.
+class TextureCache {
+public:
+  static uint64_t makeKey(const std::string &sourcePath, TextureType type,
+                          const TextureConfig &config);
+  static uint64_t makeKey(const unsigned char *encoded, size_t size,
+                          TextureType type, const TextureConfig &config);
+
+  static bool load(const std::string &directory, uint64_t key,
+                   TextureData &data);
+  static bool store(const std::string &directory, uint64_t key,
+                    const TextureData &data);
+
+private:
+  static uint64_t finishKey(uint64_t key, TextureType type,
+                            const TextureConfig &config);
+};
\ No newline at end of file
@@ -0,0 +1,732 @@
+#include "Graphics/TextureCompressor.hpp"
+#include "Core/JobSystem.hpp"
+#include "Graphics/GLCapabilities.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DV_BC_SSE2 1
+#endif
+
+namespace {
+
+struct Block {
+  alignas(16) float c[4][16];
+};
+
+const int BC7_WEIGHTS4[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                              34, 38, 43, 47, 51, 55, 60, 64};
+
+void fetchBlock(const unsigned char *rgba, int width, int height, int bx,
+                int by, Block &block) {
+  for (int y = 0; y < 4; y++) {
+    int sy = std::min(by * 4 + y, height - 1);
+    for (int x = 0; x < 4; x++) {
+      int sx = std::min(bx * 4 + x, width - 1);
+      const unsigned char *src =
+          rgba + (static_cast<size_t>(sy) * width + sx) * 4;
+      for (int ch = 0; ch < 4; ch++)
+        block.c[ch][y * 4 + x] = static_cast<float>(src[ch]);
+    }
+  }
+}
+
+// Nearest-palette-entry search shared by every encoder. This is where the
+// encoder spends most of its time, so it runs four pixels per iteration.
+float selectIndices(const Block &block, int firstChannel, int channelCount,
+                    const float (*palette)[4], int paletteSize,
+                    uint8_t indices[16]) {
+  float total = 0.0f;
+#ifdef DV_BC_SSE2
+  for (int i = 0; i < 16; i += 4) {
+    __m128 best = _mm_set1_ps(FLT_MAX);
+    __m128i bestIdx = _mm_setzero_si128();
+    for (int k = 0; k < paletteSize; k++) {
+      __m128 dist = _mm_setzero_ps();
+      for (int ch = firstChannel; ch < firstChannel + channelCount; ch++) {
+        __m128 diff = _mm_sub_ps(_mm_load_ps(&block.c[ch][i]),
+                                 _mm_set1_ps(palette[k][ch]));
+        dist = _mm_add_ps(dist, _mm_mul_ps(diff, diff));
+      }
+      __m128i less = _mm_castps_si128(_mm_cmplt_ps(dist, best));
+      best = _mm_min_ps(dist, best);
+      bestIdx = _mm_or_si128(_mm_andnot_si128(less, bestIdx),
+                             _mm_and_si128(less, _mm_set1_epi32(k)));
+    }
+    alignas(16) int32_t idx[4];
+    alignas(16) float err[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(idx), bestIdx);
+    _mm_store_ps(err, best);
+    for (int j = 0; j < 4; j++) {
+      indices[i + j] = static_cast<uint8_t>(idx[j]);
+      total += err[j];
+    }
+  }
+#else
+  for (int i = 0; i < 16; i++) {
+    float best = FLT_MAX;
+    int bestIdx = 0;
+    for (int k = 0; k < paletteSize; k++) {
+      float dist = 0.0f;
+      for (int ch = firstChannel; ch < firstChannel + channelCount; ch++) {
+        float diff = block.c[ch][i] - palette[k][ch];
+        dist += diff * diff;
+      }
+      if (dist < best) {
+        best = dist;
+        bestIdx = k;
+      }
+    }
+    indices[i] = static_cast<uint8_t>(bestIdx);
+    total += best;
+  }
+#endif
+  return total;
+}
+
+// Endpoints along the principal axis of the block's colour distribution.
+void principalEndpoints(const Block &block, int channels, float e0[4],
+                        float e1[4]) {
+  float mean[4] = {0, 0, 0, 0};
+  for (int ch = 0; ch < channels; ch++) {
+    for (int i = 0; i < 16; i++)
+      mean[ch] += block.c[ch][i];
+    mean[ch] /= 16.0f;
+  }
+
+  float cov[4][4] = {};
+  for (int i = 0; i < 16; i++) {
+    float d[4];
+    for (int ch = 0; ch < channels; ch++)
+      d[ch] = block.c[ch][i] - mean[ch];
+    for (int a = 0; a < channels; a++)
+      for (int b = a; b < channels; b++)
+        cov[a][b] += d[a] * d[b];
+  }
+  for (int a = 0; a < channels; a++)
+    for (int b = 0; b < a; b++)
+      cov[a][b] = cov[b][a];
+
+  float axis[4] = {1, 1, 1, 1};
+  for (int iter = 0; iter < 8; iter++) {
+    float next[4] = {0, 0, 0, 0};
+    for (int a = 0; a < channels; a++)
+      for (int b = 0; b < channels; b++)
+        next[a] += cov[a][b] * axis[b];
+    float len = 0.0f;
+    for (int ch = 0; ch < channels; ch++)
+      len = std::max(len, std::fabs(next[ch]));
+    if (len < 1e-6f)
+      break;
+    for (int ch = 0; ch < channels; ch++)
+      axis[ch] = next[ch] / len;
+  }
+
+  float norm = 0.0f;
+  for (int ch = 0; ch < channels; ch++)
+    norm += axis[ch] * axis[ch];
+  norm = std::sqrt(norm);
+  if (norm < 1e-6f) {
+    for (int ch = 0; ch < channels; ch++)
+      e0[ch] = e1[ch] = mean[ch];
+    return;
+  }
+  for (int ch = 0; ch < channels; ch++)
+    axis[ch] /= norm;
+
+  float minT = FLT_MAX, maxT = -FLT_MAX;
+  for (int i = 0; i < 16; i++) {
+    float t = 0.0f;
+    for (int ch = 0; ch < channels; ch++)
+      t += (block.c[ch][i] - mean[ch]) * axis[ch];
+    minT = std::min(minT, t);
+    maxT = std::max(maxT, t);
+  }
+
+  for (int ch = 0; ch < channels; ch++) {
+    e0[ch] = std::clamp(mean[ch] + axis[ch] * maxT, 0.0f, 255.0f);
+    e1[ch] = std::clamp(mean[ch] + axis[ch] * minT, 0.0f, 255.0f);
+  }
+}
+
+// Least-squares endpoints for fixed per-pixel interpolation weights, where
+// weights[i] is the fraction of e1 in pixel i's palette entry.
+void refineEndpoints(const Block &block, int channels, const float weights[16],
+                     float e0[4], float e1[4]) {
+  float aa = 0, ab = 0, bb = 0;
+  float ax[4] = {0, 0, 0, 0}, bx[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 16; i++) {
+    float b = weights[i];
+    float a = 1.0f - b;
+    aa += a * a;
+    ab += a * b;
+    bb += b * b;
+    for (int ch = 0; ch < channels; ch++) {
+      ax[ch] += a * block.c[ch][i];
+      bx[ch] += b * block.c[ch][i];
+    }
+  }
+  float det = aa * bb - ab * ab;
+  if (std::fabs(det) < 1e-6f)
+    return;
+  float inv = 1.0f / det;
+  for (int ch = 0; ch < channels; ch++) {
+    e0[ch] = std::clamp((ax[ch] * bb - bx[ch] * ab) * inv, 0.0f, 255.0f);
+    e1[ch] = std::clamp((bx[ch] * aa - ax[ch] * ab) * inv, 0.0f, 255.0f);
+  }
+}
+
+// --- BC1 ---
+
+uint16_t packRGB565(const float c[4]) {
+  int r = static_cast<int>(std::lround(c[0] * 31.0f / 255.0f));
+  int g = static_cast<int>(std::lround(c[1] * 63.0f / 255.0f));
+  int b = static_cast<int>(std::lround(c[2] * 31.0f / 255.0f));
+  return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpackRGB565(uint16_t c, float out[4]) {
+  int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+  out[0] = static_cast<float>((r << 3) | (r >> 2));
+  out[1] = static_cast<float>((g << 2) | (g >> 4));
+  out[2] = static_cast<float>((b << 3) | (b >> 2));
+  out[3] = 255.0f;
+}
+
+void bc1Palette(uint16_t c0, uint16_t c1, bool fourColor, float pal[4][4]) {
+  unpackRGB565(c0, pal[0]);
+  unpackRGB565(c1, pal[1]);
+  for (int ch = 0; ch < 3; ch++) {
+    if (fourColor) {
+      pal[2][ch] = std::floor((2.0f * pal[0][ch] + pal[1][ch]) / 3.0f);
+      pal[3][ch] = std::floor((pal[0][ch] + 2.0f * pal[1][ch]) / 3.0f);
+    } else {
+      pal[2][ch] = std::floor((pal[0][ch] + pal[1][ch]) / 2.0f);
+      pal[3][ch] = 0.0f;
+    }
+  }
+  pal[2][3] = 255.0f;
+  pal[3][3] = fourColor ? 255.0f : 0.0f;
+}
+
+float evaluateBC1(const Block &block, uint16_t c0, uint16_t c1,
+                  uint8_t indices[16]) {
+  float pal[4][4];
+  bc1Palette(c0, c1, true, pal);
+  return selectIndices(block, 0, 3, pal, c0 == c1 ? 1 : 4, indices);
+}
+
+// Always emits four-colour blocks, which is also what BC3's colour half
+// requires.
+void encodeBC1Block(const Block &block, unsigned char out[8]) {
+  float e0[4], e1[4];
+  principalEndpoints(block, 3, e0, e1);
+
+  uint16_t c0 = packRGB565(e0), c1 = packRGB565(e1);
+  uint8_t indices[16];
+  float error = evaluateBC1(block, c0, c1, indices);
+
+  static const float weightOf[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+  float weights[16];
+  for (int i = 0; i < 16; i++)
+    weights[i] = weightOf[indices[i]];
+  float r0[4] = {e0[0], e0[1], e0[2], 0}, r1[4] = {e1[0], e1[1], e1[2], 0};
+  refineEndpoints(block, 3, weights, r0, r1);
+
+  uint16_t rc0 = packRGB565(r0), rc1 = packRGB565(r1);
+  uint8_t refined[16];
+  float refinedError = evaluateBC1(block, rc0, rc1, refined);
+  if (refinedError < error) {
+    c0 = rc0;
+    c1 = rc1;
+    std::memcpy(indices, refined, 16);
+  }
+
+  if (c0 < c1) {
+    std::swap(c0, c1);
+    static const uint8_t flip[4] = {1, 0, 3, 2};
+    for (int i = 0; i < 16; i++)
+      indices[i] = flip[indices[i]];
+  } else if (c0 == c1) {
+    std::memset(indices, 0, 16);
+  }
+
+  uint32_t bits = 0;
+  for (int i = 0; i < 16; i++)
+    bits |= static_cast<uint32_t>(indices[i]) << (2 * i);
+
+  out[0] = c0 & 0xFF;
+  out[1] = c0 >> 8;
+  out[2] = c1 & 0xFF;
+  out[3] = c1 >> 8;
+  for (int i = 0; i < 4; i++)
+    out[4 + i] = (bits >> (8 * i)) & 0xFF;
+}
+
+void decodeBC1Block(const unsigned char in[8], bool forceFourColor,
+                    unsigned char rgba[64]) {
+  uint16_t c0 = in[0] | (in[1] << 8);
+  uint16_t c1 = in[2] | (in[3] << 8);
+  uint32_t bits = in[4] | (in[5] << 8) | (in[6] << 16) |
+                  (static_cast<uint32_t>(in[7]) << 24);
+  float pal[4][4];
+  bc1Palette(c0, c1, forceFourColor || c0 > c1, pal);
+  for (int i = 0; i < 16; i++) {
+    int idx = (bits >> (2 * i)) & 3;
+    for (int ch = 0; ch < 4; ch++)
+      rgba[i * 4 + ch] = static_cast<unsigned char>(pal[idx][ch]);
+  }
+}
+
+// --- BC4 (also the alpha half of BC3 and both halves of BC5) ---
+
+void bc4Palette(int a0, int a1, float pal[8][4], int channel) {
+  float values[8];
+  values[0] = static_cast<float>(a0);
+  values[1] = static_cast<float>(a1);
+  if (a0 > a1) {
+    for (int i = 2; i < 8; i++)
+      values[i] = std::floor(((8 - i) * a0 + (i - 1) * a1) / 7.0f + 0.5f);
+  } else {
+    for (int i = 2; i < 6; i++)
+      values[i] = std::floor(((6 - i) * a0 + (i - 1) * a1) / 5.0f + 0.5f);
+    values[6] = 0.0f;
+    values[7] = 255.0f;
+  }
+  for (int i = 0; i < 8; i++)
+    pal[i][channel] = values[i];
+}
+
+void encodeBC4Block(const Block &block, int channel, unsigned char out[8]) {
+  float lo = 255.0f, hi = 0.0f;
+  for (int i = 0; i < 16; i++) {
+    lo = std::min(lo, block.c[channel][i]);
+    hi = std::max(hi, block.c[channel][i]);
+  }
+
+  int a0 = static_cast<int>(std::lround(hi));
+  int a1 = static_cast<int>(std::lround(lo));
+  uint8_t indices[16] = {};
+
+  if (a0 != a1) {
+    float pal[8][4];
+    bc4Palette(a0, a1, pal, channel);
+    float error = selectIndices(block, channel, 1, pal, 8, indices);
+
+    // Pulling the endpoints in by a step often wins on blocks with a lone
+    // outlier; keep whichever candidate measures better.
+    const int hiValue = a0, loValue = a1;
+    for (int inset = 1; inset <= 2 && hiValue - loValue > 2 * inset;
+         inset++) {
+      float candidatePal[8][4];
+      uint8_t candidate[16];
+      bc4Palette(hiValue - inset, loValue + inset, candidatePal, channel);
+      float candidateError =
+          selectIndices(block, channel, 1, candidatePal, 8, candidate);
+      if (candidateError < error) {
+        error = candidateError;
+        std::memcpy(indices, candidate, 16);
+        a0 = hiValue - inset;
+        a1 = loValue + inset;
+      }
+    }
+  }
+
+  out[0] = static_cast<unsigned char>(a0);
+  out[1] = static_cast<unsigned char>(a1);
+  uint64_t bits = 0;
+  for (int i = 0; i < 16; i++)
+    bits |= static_cast<uint64_t>(indices[i]) << (3 * i);
+  for (int i = 0; i < 6; i++)
+    out[2 + i] = (bits >> (8 * i)) & 0xFF;
+}
+
+void decodeBC4Block(const unsigned char in[8], int channel,
+                    unsigned char rgba[64]) {
+  float pal[8][4];
+  bc4Palette(in[0], in[1], pal, 0);
+  uint64_t bits = 0;
+  for (int i = 0; i < 6; i++)
+    bits |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+  for (int i = 0; i < 16; i++)
+    rgba[i * 4 + channel] =
+        static_cast<unsigned char>(pal[(bits >> (3 * i)) & 7][0]);
+}
+
+// --- BC7 (mode 6: one subset, RGBA, 7-bit endpoints + p-bits, 4-bit
+// indices) ---
+
+struct BitWriter {
+  unsigned char *out;
+  int pos = 0;
+
+  void write(uint32_t value, int bits) {
+    for (int i = 0; i < bits; i++, pos++) {
+      if ((value >> i) & 1)
+        out[pos >> 3] |= static_cast<unsigned char>(1 << (pos & 7));
+    }
+  }
+};
+
+struct BitReader {
+  const unsigned char *in;
+  int pos = 0;
+
+  uint32_t read(int bits) {
+    uint32_t value = 0;
+    for (int i = 0; i < bits; i++, pos++)
+      value |= static_cast<uint32_t>((in[pos >> 3] >> (pos & 7)) & 1) << i;
+    return value;
+  }
+};
+
+void bc7Palette(const int q0[4], const int q1[4], int p0, int p1,
+                float pal[16][4]) {
+  for (int ch = 0; ch < 4; ch++) {
+    int v0 = (q0[ch] << 1) | p0;
+    int v1 = (q1[ch] << 1) | p1;
+    for (int k = 0; k < 16; k++)
+      pal[k][ch] = static_cast<float>(
+          ((64 - BC7_WEIGHTS4[k]) * v0 + BC7_WEIGHTS4[k] * v1 + 32) >> 6);
+  }
+}
+
+float quantizeBC7(const Block &block, const float e0[4], const float e1[4],
+                  int q0[4], int q1[4], int &p0, int &p1,
+                  uint8_t indices[16]) {
+  float bestError = FLT_MAX;
+  for (int pb = 0; pb < 4; pb++) {
+    int cp0 = pb & 1, cp1 = pb >> 1;
+    int c0[4], c1[4];
+    for (int ch = 0; ch < 4; ch++) {
+      c0[ch] = std::clamp(static_cast<int>(std::lround((e0[ch] - cp0) / 2.0f)),
+                          0, 127);
+      c1[ch] = std::clamp(static_cast<int>(std::lround((e1[ch] - cp1) / 2.0f)),
+                          0, 127);
+    }
+    float pal[16][4];
+    bc7Palette(c0, c1, cp0, cp1, pal);
+    uint8_t candidate[16];
+    float error = selectIndices(block, 0, 4, pal, 16, candidate);
+    if (error < bestError) {
+      bestError = error;
+      std::memcpy(q0, c0, sizeof(c0));
+      std::memcpy(q1, c1, sizeof(c1));
+      p0 = cp0;
+      p1 = cp1;
+      std::memcpy(indices, candidate, 16);
+    }
+  }
+  return bestError;
+}
+
+void encodeBC7Block(const Block &block, unsigned char out[16]) {
+  float e0[4], e1[4];
+  principalEndpoints(block, 4, e0, e1);
+
+  int q0[4], q1[4], p0 = 0, p1 = 0;
+  uint8_t indices[16];
+  float error = quantizeBC7(block, e0, e1, q0, q1, p0, p1, indices);
+
+  float weights[16];
+  for (int i = 0; i < 16; i++)
+    weights[i] = BC7_WEIGHTS4[indices[i]] / 64.0f;
+  refineEndpoints(block, 4, weights, e0, e1);
+
+  int rq0[4], rq1[4], rp0 = 0, rp1 = 0;
+  uint8_t refined[16];
+  if (quantizeBC7(block, e0, e1, rq0, rq1, rp0, rp1, refined) < error) {
+    std::memcpy(q0, rq0, sizeof(q0));
+    std::memcpy(q1, rq1, sizeof(q1));
+    p0 = rp0;
+    p1 = rp1;
+    std::memcpy(indices, refined, 16);
+  }
+
+  // The anchor (first) index is stored with its top bit implied zero.
+  if (indices[0] & 8) {
+    std::swap(q0, q1);
+    std::swap(p0, p1);
+    for (int i = 0; i < 16; i++)
+      indices[i] = 15 - indices[i];
+  }
+
+  std::memset(out, 0, 16);
+  BitWriter writer{out};
+  writer.write(1u << 6, 7);
+  for (int ch = 0; ch < 4; ch++) {
+    writer.write(q0[ch], 7);
+    writer.write(q1[ch], 7);
+  }
+  writer.write(p0, 1);
+  writer.write(p1, 1);
+  writer.write(indices[0], 3);
+  for (int i = 1; i < 16; i++)
+    writer.write(indices[i], 4);
+}
+
+void decodeBC7Block(const unsigned char in[16], unsigned char rgba[64]) {
+  BitReader reader{in};
+  if (reader.read(7) != (1u << 6)) {
+    std::memset(rgba, 0, 64);
+    return;
+  }
+  int q0[4], q1[4];
+  for (int ch = 0; ch < 4; ch++) {
+    q0[ch] = reader.read(7);
+    q1[ch] = reader.read(7);
+  }
+  int p0 = reader.read(1), p1 = reader.read(1);
+  float pal[16][4];
+  bc7Palette(q0, q1, p0, p1, pal);
+  for (int i = 0; i < 16; i++) {
+    int idx = reader.read(i == 0 ? 3 : 4);
+    for (int ch = 0; ch < 4; ch++)
+      rgba[i * 4 + ch] = static_cast<unsigned char>(pal[idx][ch]);
+  }
+}
+
+void encodeBlock(const Block &block, TextureFormat format,
+                 unsigned char *out) {
+  switch (format) {
+  case TextureFormat::BC1:
+    encodeBC1Block(block, out);
+    break;
+  case TextureFormat::BC3:
+    encodeBC4Block(block, 3, out);
+    encodeBC1Block(block, out + 8);
+    break;
+  case TextureFormat::BC4:
+    encodeBC4Block(block, 0, out);
+    break;
+  case TextureFormat::BC5:
+    encodeBC4Block(block, 0, out);
+    encodeBC4Block(block, 1, out + 8);
+    break;
+  case TextureFormat::BC7:
+    encodeBC7Block(block, out);
+    break;
+  default:
+    break;
+  }
+}
+
+void decodeBlock(const unsigned char *in, TextureFormat format,
+                 unsigned char rgba[64]) {
+  for (int i = 0; i < 16; i++) {
+    rgba[i * 4 + 0] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = 0;
+    rgba[i * 4 + 3] = 255;
+  }
+  switch (format) {
+  case TextureFormat::BC1:
+    decodeBC1Block(in, false, rgba);
+    break;
+  case TextureFormat::BC3:
+    decodeBC1Block(in + 8, true, rgba);
+    decodeBC4Block(in, 3, rgba);
+    break;
+  case TextureFormat::BC4:
+    decodeBC4Block(in, 0, rgba);
+    break;
+  case TextureFormat::BC5:
+    decodeBC4Block(in, 0, rgba);
+    decodeBC4Block(in + 8, 1, rgba);
+    break;
+  case TextureFormat::BC7:
+    decodeBC7Block(in, rgba);
+    break;
+  default:
+    break;
+  }
+}
+
+// Splits block rows across the job system; small levels stay inline.
+template <typename Fn> void parallelRows(int rows, Fn &&fn) {
+  JobSystem::get().parallelFor(
+      static_cast<size_t>(rows),
+      [&fn](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++)
+          fn(static_cast<int>(row));
+      },
+      4);
+}
+
+} // namespace
+
+TextureFormat TextureCompressor::selectFormat(TextureType type, bool hasAlpha,
+                                              const TextureConfig &config) {
+  TextureFormat format;
+  switch (type) {
+  case TextureType::Specular:
+  case TextureType::Height:
+    format = TextureFormat::BC4;
+    break;
+  case TextureType::Normal:
+    format = TextureFormat::BC5;
+    break;
+  default:
+    if (config.HighQualityDiffuse)
+      format = TextureFormat::BC7;
+    else
+      format = hasAlpha ? TextureFormat::BC7 : TextureFormat::BC1;
+    break;
+  }
+
+  // S3TC is an extension on desktop GL, BPTC and RGTC are core.
+  if ((format == TextureFormat::BC1 || format == TextureFormat::BC3) &&
+      !GLCapabilities::supportsS3TC())
+    format = TextureFormat::BC7;
+
+  return format;
+}
+
+bool TextureCompressor::isCompressed(TextureFormat format) {
+  return format == TextureFormat::BC1 || format == TextureFormat::BC3 ||
+         format == TextureFormat::BC4 || format == TextureFormat::BC5 ||
+         format == TextureFormat::BC7;
+}
+
+size_t TextureCompressor::blockSize(TextureFormat format) {
+  switch (format) {
+  case TextureFormat::BC1:
+  case TextureFormat::BC4:
+    return 8;
+  case TextureFormat::BC3:
+  case TextureFormat::BC5:
+  case TextureFormat::BC7:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+size_t TextureCompressor::levelSize(TextureFormat format, int width,
+                                    int height) {
+  if (isCompressed(format)) {
+    size_t blocksX = (width + 3) / 4;
+    size_t blocksY = (height + 3) / 4;
+    return blocksX * blocksY * blockSize(format);
+  }
+
+  size_t texel = 4;
+  if (format == TextureFormat::RGB8)
+    texel = 3;
+  else if (format == TextureFormat::R8)
+    texel = 1;
+  return static_cast<size_t>(width) * height * texel;
+}
+
+const char *TextureCompressor::formatName(TextureFormat format) {
+  switch (format) {
+  case TextureFormat::RGBA8:
+    return "RGBA8";
+  case TextureFormat::RGB8:
+    return "RGB8";
+  case TextureFormat::R8:
+    return "R8";
+  case TextureFormat::BC1:
+    return "BC1";
+  case TextureFormat::BC3:
+    return "BC3";
+  case TextureFormat::BC4:
+    return "BC4";
+  case TextureFormat::BC5:
+    return "BC5";
+  case TextureFormat::BC7:
+    return "BC7";
+  }
+  return "Unknown";
+}
+
+std::vector<unsigned char> TextureCompressor::compress(const unsigned char *rgba,
+                                                       int width, int height,
+                                                       TextureFormat format) {
+  if (!isCompressed(format) || width <= 0 || height <= 0)
+    return {};
+
+  const int blocksX = (width + 3) / 4;
+  const int blocksY = (height + 3) / 4;
+  const size_t bytesPerBlock = blockSize(format);
+
+  std::vector<unsigned char> out(static_cast<size_t>(blocksX) * blocksY *
+                                 bytesPerBlock);
+
+  parallelRows(blocksY, [&](int by) {
+    Block block;
+    unsigned char *dst = out.data() + static_cast<size_t>(by) * blocksX *
+                                          bytesPerBlock;
+    for (int bx = 0; bx < blocksX; bx++) {
+      fetchBlock(rgba, width, height, bx, by, block);
+      encodeBlock(block, format, dst + bx * bytesPerBlock);
+    }
+  });
+
+  return out;
+}
+
+std::vector<unsigned char>
+TextureCompressor::decompress(const std::vector<unsigned char> &blocks,
+                              int width, int height, TextureFormat format) {
+  std::vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+  if (!isCompressed(format) || blocks.size() < levelSize(format, width, height))
+    return rgba;
+
+  const int blocksX = (width + 3) / 4;
+  const int blocksY = (height + 3) / 4;
+  const size_t bytesPerBlock = blockSize(format);
+
+  parallelRows(blocksY, [&](int by) {
+    unsigned char texels[64];
+    for (int bx = 0; bx < blocksX; bx++) {
+      decodeBlock(blocks.data() +
+                      (static_cast<size_t>(by) * blocksX + bx) * bytesPerBlock,
+                  format, texels);
+      for (int y = 0; y < 4 && by * 4 + y < height; y++) {
+        for (int x = 0; x < 4 && bx * 4 + x < width; x++) {
+          size_t dst =
+              (static_cast<size_t>(by * 4 + y) * width + (bx * 4 + x)) * 4;
+          std::memcpy(&rgba[dst], &texels[(y * 4 + x) * 4], 4);
+        }
+      }
+    }
+  });
+
+  return rgba;
+}
+
+float TextureCompressor::measurePSNR(const unsigned char *rgba,
+                                     const std::vector<unsigned char> &blocks,
+                                     int width, int height,
+                                     TextureFormat format) {
+  int channels = 4;
+  if (format == TextureFormat::BC1)
+    channels = 3;
+  else if (format == TextureFormat::BC4)
+    channels = 1;
+  else if (format == TextureFormat::BC5)
+    channels = 2;
+
+  std::vector<unsigned char> decoded =
+      decompress(blocks, width, height, format);
+
+  double sum = 0.0;
+  size_t texels = static_cast<size_t>(width) * height;
+  for (size_t i = 0; i < texels; i++) {
+    for (int ch = 0; ch < channels; ch++) {
+      double diff = static_cast<double>(rgba[i * 4 + ch]) -
+                    static_cast<double>(decoded[i * 4 + ch]);
+      sum += diff * diff;
+    }
+  }
+
+  double mse = sum / static_cast<double>(texels * channels);
+  if (mse <= 0.0)
+    return std::numeric_limits<float>::infinity();
+  return static_cast<float>(10.0 * std::log10(255.0 * 255.0 / mse));
+}
\ No newline at end of file
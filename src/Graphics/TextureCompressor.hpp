@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Graphics/Texture.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// CPU encoder for the BCn block formats. Input is always tightly packed
+// RGBA8; output is a row-major array of 4x4 blocks ready for
+// glCompressedTextureSubImage2D.
+class TextureCompressor {
+public:
+  static TextureFormat selectFormat(TextureType type, bool hasAlpha,
+                                    const TextureConfig &config);
+
+  static bool isCompressed(TextureFormat format);
+  static size_t blockSize(TextureFormat format);
+  static size_t levelSize(TextureFormat format, int width, int height);
+  static const char *formatName(TextureFormat format);
+
+  static std::vector<unsigned char> compress(const unsigned char *rgba,
+                                             int width, int height,
+                                             TextureFormat format);
+
+  static std::vector<unsigned char>
+  decompress(const std::vector<unsigned char> &blocks, int width, int height,
+             TextureFormat format);
+
+  // Peak signal-to-noise ratio (dB) of the encoded level against its source,
+  // measured only over the channels the format actually stores.
+  static float measurePSNR(const unsigned char *rgba,
+                           const std::vector<unsigned char> &blocks, int width,
+                           int height, TextureFormat format);
+};
\ No newline at end of file
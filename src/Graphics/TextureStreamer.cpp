@@ -0,0 +1,149 @@
+#include "Graphics/TextureStreamer.hpp"
+#include "Core/Log.hpp"
+#include "Graphics/Texture.hpp"
+
+#include <algorithm>
+
+void TextureStreamer::init(const TextureConfig &config) {
+  m_budgetBytes = static_cast<size_t>(config.StreamingBudgetMB) * 1024 * 1024;
+  m_uploadBytesPerFrame =
+      static_cast<size_t>(config.StreamingUploadMBPerFrame) * 1024 * 1024;
+
+  LOG_CORE_INFO("TextureStreamer initialized. Budget: {0}MB, upload: {1}MB "
+                "per frame",
+                config.StreamingBudgetMB, config.StreamingUploadMBPerFrame);
+}
+
+void TextureStreamer::registerTexture(Texture *texture) {
+  if (m_lookup.count(texture))
+    return;
+  m_lookup[texture] = m_entries.size();
+  m_entries.push_back({texture, m_frame});
+}
+
+void TextureStreamer::unregisterTexture(Texture *texture) {
+  auto it = m_lookup.find(texture);
+  if (it == m_lookup.end())
+    return;
+
+  size_t index = it->second;
+  m_lookup.erase(it);
+
+  if (index != m_entries.size() - 1) {
+    m_entries[index] = m_entries.back();
+    m_lookup[m_entries[index].texture] = index;
+  }
+  m_entries.pop_back();
+}
+
+bool TextureStreamer::evictOne(size_t &residentBytes, bool allowVisible) {
+  // Prefer textures that have been off screen the longest, then the ones
+  // holding the largest mips. Mips a visible texture still needs are only
+  // dropped when the budget leaves no other choice.
+  Entry *victim = nullptr;
+  for (auto &entry : m_entries) {
+    Texture *texture = entry.texture;
+    if (texture->getResidentLevel() >= texture->getStreamingFloorLevel())
+      continue;
+
+    bool surplus = texture->getResidentLevel() < texture->getRequestedLevel();
+    if (!surplus && !allowVisible)
+      continue;
+
+    if (!victim || entry.lastVisibleFrame < victim->lastVisibleFrame ||
+        (entry.lastVisibleFrame == victim->lastVisibleFrame &&
+         texture->getResidentLevel() <
+             victim->texture->getResidentLevel()))
+      victim = &entry;
+  }
+
+  if (!victim)
+    return false;
+
+  Texture *texture = victim->texture;
+  size_t before = texture->getMemorySize();
+  texture->setResidentLevel(texture->getResidentLevel() + 1);
+  residentBytes -= before - texture->getMemorySize();
+  return true;
+}
+
+void TextureStreamer::update() {
+  m_frame++;
+
+  size_t residentBytes = 0;
+  m_stats.visibleCount = 0;
+  m_stats.pendingCount = 0;
+
+  std::vector<Entry *> upgrades;
+  for (auto &entry : m_entries) {
+    Texture *texture = entry.texture;
+    residentBytes += texture->getMemorySize();
+
+    int requested = texture->getRequestedLevel();
+    if (requested == Texture::NO_REQUEST)
+      continue;
+
+    entry.lastVisibleFrame = m_frame;
+    m_stats.visibleCount++;
+    if (requested < texture->getResidentLevel())
+      upgrades.push_back(&entry);
+  }
+
+  // Biggest residency deficit first, so the most blurry surfaces sharpen
+  // before ones that are only a level short.
+  std::sort(upgrades.begin(), upgrades.end(), [](Entry *a, Entry *b) {
+    return a->texture->getResidentLevel() - a->texture->getRequestedLevel() >
+           b->texture->getResidentLevel() - b->texture->getRequestedLevel();
+  });
+
+  size_t uploadBudget = m_uploadBytesPerFrame;
+  size_t uploaded = 0;
+
+  for (Entry *entry : upgrades) {
+    Texture *texture = entry->texture;
+    int current = texture->getResidentLevel();
+    int target = current;
+
+    // Step towards the request one level at a time while the upload and
+    // memory budgets allow it. The first step is always allowed so a single
+    // huge mip cannot stall streaming forever.
+    size_t cost = 0;
+    while (target > texture->getRequestedLevel()) {
+      size_t levelCost = texture->getLevelMemorySize(target - 1);
+      if (cost + levelCost > uploadBudget && !(uploaded == 0 && cost == 0))
+        break;
+
+      while (residentBytes + cost + levelCost > m_budgetBytes &&
+             evictOne(residentBytes, false)) {
+      }
+      if (residentBytes + cost + levelCost > m_budgetBytes)
+        break;
+
+      cost += levelCost;
+      target--;
+    }
+
+    if (target < current) {
+      texture->setResidentLevel(target);
+      residentBytes += cost;
+      uploaded += cost;
+      uploadBudget = uploadBudget > cost ? uploadBudget - cost : 0;
+    }
+
+    if (target > texture->getRequestedLevel())
+      m_stats.pendingCount++;
+  }
+
+  // Budget may have shrunk or requests dropped: trim back under it.
+  while (residentBytes > m_budgetBytes &&
+         (evictOne(residentBytes, false) || evictOne(residentBytes, true))) {
+  }
+
+  for (auto &entry : m_entries)
+    entry.texture->clearRequest();
+
+  m_stats.residentBytes = residentBytes;
+  m_stats.budgetBytes = m_budgetBytes;
+  m_stats.uploadedBytes = uploaded;
+  m_stats.textureCount = static_cast<unsigned int>(m_entries.size());
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Texture;
+
+struct TextureStreamingStats {
+  size_t residentBytes = 0;
+  size_t budgetBytes = 0;
+  size_t uploadedBytes = 0;
+  unsigned int textureCount = 0;
+  unsigned int visibleCount = 0;
+  unsigned int pendingCount = 0;
+};
+
+// Raises and lowers per-texture mip residency once per frame, driven by the
+// screen-space requests the renderer records on each texture.
+class TextureStreamer {
+public:
+  static TextureStreamer &get() {
+    static TextureStreamer instance;
+    return instance;
+  }
+
+  void init(const TextureConfig &config);
+
+  void registerTexture(Texture *texture);
+  void unregisterTexture(Texture *texture);
+
+  void update();
+
+  const TextureStreamingStats &getStats() const { return m_stats; }
+
+private:
+  TextureStreamer() = default;
+
+  struct Entry {
+    Texture *texture;
+    uint64_t lastVisibleFrame = 0;
+  };
+
+  std::vector<Entry> m_entries;
+  std::unordered_map<Texture *, size_t> m_lookup;
+
+  size_t m_budgetBytes = 512ull * 1024 * 1024;
+  size_t m_uploadBytesPerFrame = 32ull * 1024 * 1024;
+  uint64_t m_frame = 0;
+
+  TextureStreamingStats m_stats;
+
+  bool evictOne(size_t &residentBytes, bool allowVisible);
+};
\ No newline at end of file
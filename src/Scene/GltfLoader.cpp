@@ -0,0 +1,591 @@
+#include "Scene/GltfLoader.hpp"
+#include "Core/Hash.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Log.hpp"
+#include "Core/MappedFile.hpp"
+#include "Graphics/GeometryManager.hpp"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr uint32_t GLB_MAGIC = 0x46546C67; // "glTF"
+constexpr uint32_t CHUNK_JSON = 0x4E4F534A;
+constexpr uint32_t CHUNK_BIN = 0x004E4942;
+
+constexpr int COMPONENT_BYTE = 5120;
+constexpr int COMPONENT_UNSIGNED_BYTE = 5121;
+constexpr int COMPONENT_SHORT = 5122;
+constexpr int COMPONENT_UNSIGNED_SHORT = 5123;
+constexpr int COMPONENT_UNSIGNED_INT = 5125;
+constexpr int COMPONENT_FLOAT = 5126;
+constexpr int MODE_TRIANGLES = 4;
+
+struct GlbFile {
+  MappedFile file;
+  const unsigned char *bin = nullptr;
+  size_t binSize = 0;
+};
+
+// Where an accessor's elements sit inside the binary chunk.
+struct AccessorView {
+  const unsigned char *data = nullptr;
+  size_t count = 0;
+  size_t stride = 0;
+  int componentType = 0;
+  int components = 0;
+  bool normalized = false;
+};
+
+uint32_t readU32(const char *p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+size_t componentSize(int componentType) {
+  switch (componentType) {
+  case COMPONENT_BYTE:
+  case COMPONENT_UNSIGNED_BYTE:
+    return 1;
+  case COMPONENT_SHORT:
+  case COMPONENT_UNSIGNED_SHORT:
+    return 2;
+  case COMPONENT_UNSIGNED_INT:
+  case COMPONENT_FLOAT:
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+int componentCount(const std::string &type) {
+  if (type == "SCALAR")
+    return 1;
+  if (type == "VEC2")
+    return 2;
+  if (type == "VEC3")
+    return 3;
+  if (type == "VEC4")
+    return 4;
+  return 0;
+}
+
+bool resolveAccessor(const json &doc, const GlbFile &glb, size_t index,
+                     AccessorView &view) {
+  if (!doc.contains("accessors") || index >= doc["accessors"].size())
+    return false;
+  const json &accessor = doc["accessors"][index];
+  if (accessor.contains("sparse") || !accessor.contains("bufferView"))
+    return false;
+
+  size_t viewIndex = accessor["bufferView"].get<size_t>();
+  if (!doc.contains("bufferViews") || viewIndex >= doc["bufferViews"].size())
+    return false;
+  const json &bufferView = doc["bufferViews"][viewIndex];
+  if (bufferView.value("buffer", 0) != 0)
+    return false;
+
+  view.componentType = accessor.value("componentType", 0);
+  view.components = componentCount(accessor.value("type", ""));
+  view.count = accessor.value("count", size_t(0));
+  view.normalized = accessor.value("normalized", false);
+
+  const size_t elementSize =
+      componentSize(view.componentType) * view.components;
+  if (elementSize == 0)
+    return false;
+  view.stride = bufferView.value("byteStride", elementSize);
+  if (view.stride < elementSize)
+    return false;
+
+  // Every size comes from the file, so nothing is added or multiplied
+  // before it is known not to wrap.
+  const uint64_t viewOffset = bufferView.value("byteOffset", uint64_t(0));
+  const uint64_t viewLength = bufferView.value("byteLength", uint64_t(0));
+  const uint64_t offset = accessor.value("byteOffset", uint64_t(0));
+  if (viewOffset > glb.binSize || viewLength > glb.binSize - viewOffset ||
+      offset > viewLength)
+    return false;
+  const uint64_t available = viewLength - offset;
+  if (view.count > 0 &&
+      (elementSize > available ||
+       view.count - 1 > (available - elementSize) / view.stride))
+    return false;
+
+  view.data = glb.bin + viewOffset + offset;
+  return true;
+}
+
+float readComponent(const unsigned char *p, int componentType,
+                    bool normalized) {
+  switch (componentType) {
+  case COMPONENT_FLOAT: {
+    float value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+  }
+  case COMPONENT_UNSIGNED_BYTE:
+    return normalized ? p[0] / 255.0f : p[0];
+  case COMPONENT_BYTE: {
+    float value = static_cast<int8_t>(p[0]);
+    return normalized ? std::max(value / 127.0f, -1.0f) : value;
+  }
+  case COMPONENT_UNSIGNED_SHORT: {
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return normalized ? value / 65535.0f : value;
+  }
+  case COMPONENT_SHORT: {
+    int16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+  }
+  default:
+    return 0.0f;
+  }
+}
+
+unsigned int readIndex(const AccessorView &view, size_t i) {
+  const unsigned char *p = view.data + i * view.stride;
+  switch (view.componentType) {
+  case COMPONENT_UNSIGNED_BYTE:
+    return p[0];
+  case COMPONENT_UNSIGNED_SHORT: {
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+  }
+  case COMPONENT_UNSIGNED_INT: {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+  }
+  default:
+    return 0;
+  }
+}
+
+bool isIndexType(int componentType) {
+  return componentType == COMPONENT_UNSIGNED_BYTE ||
+         componentType == COMPONENT_UNSIGNED_SHORT ||
+         componentType == COMPONENT_UNSIGNED_INT;
+}
+
+bool isFloatVec3(const AccessorView &view) {
+  return view.componentType == COMPONENT_FLOAT && view.components == 3;
+}
+
+// An interleaved view laid out exactly like Vertex can go to the GPU as is.
+// glTF's top-left UV origin is what Assimp produces with aiProcess_FlipUVs,
+// so texture coordinates never need rewriting either.
+bool matchesVertexLayout(const AccessorView &positions,
+                         const AccessorView &normals, const AccessorView &uvs) {
+  return normals.data && uvs.data && uvs.componentType == COMPONENT_FLOAT &&
+         positions.stride == sizeof(Vertex) &&
+         normals.stride == sizeof(Vertex) && uvs.stride == sizeof(Vertex) &&
+         normals.data == positions.data + offsetof(Vertex, Normal) &&
+         uvs.data == positions.data + offsetof(Vertex, TexCoords);
+}
+
+BoundingBox computeBounds(const json &accessor, const AccessorView &positions) {
+  BoundingBox bounds;
+  if (accessor.contains("min") && accessor.contains("max") &&
+      accessor["min"].size() == 3 && accessor["max"].size() == 3) {
+    for (int i = 0; i < 3; i++) {
+      bounds.min[i] = accessor["min"][i].get<float>();
+      bounds.max[i] = accessor["max"][i].get<float>();
+    }
+    return bounds;
+  }
+
+  for (size_t i = 0; i < positions.count; i++) {
+    glm::vec3 p;
+    std::memcpy(&p, positions.data + i * positions.stride, sizeof(p));
+    bounds.min = i == 0 ? p : glm::min(bounds.min, p);
+    bounds.max = i == 0 ? p : glm::max(bounds.max, p);
+  }
+  return bounds;
+}
+
+// Hashes exactly what uploadPrimitive reads, so primitives built from
+// identical accessor data (e.g. one mesh placed by several nodes) match.
+Hash128 hashPrimitive(const AccessorView *views, size_t viewCount) {
+  Hash128 hash;
+  for (size_t v = 0; v < viewCount; v++) {
+    const AccessorView &view = views[v];
+    const uint64_t layout[5] = {view.count, view.stride,
+                                uint64_t(view.componentType),
+                                uint64_t(view.components),
+                                uint64_t(view.normalized)};
+    hash = Hash::content128(layout, sizeof(layout), hash);
+    if (!view.data || view.count == 0)
+      continue;
+    size_t span = (view.count - 1) * view.stride +
+                  componentSize(view.componentType) * view.components;
+    hash = Hash::content128(view.data, span, hash);
+  }
+  return hash;
+}
+
+void writeVertices(const AccessorView &positions, const AccessorView &normals,
+                   const AccessorView &uvs, Vertex *dst) {
+  const size_t vertexCount = positions.count;
+  if (matchesVertexLayout(positions, normals, uvs)) {
+    std::memcpy(dst, positions.data, vertexCount * sizeof(Vertex));
+    return;
+  }
+  JobSystem::get().parallelFor(
+      vertexCount,
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          Vertex v;
+          std::memcpy(&v.Position, positions.data + i * positions.stride,
+                      sizeof(v.Position));
+          if (normals.data)
+            std::memcpy(&v.Normal, normals.data + i * normals.stride,
+                        sizeof(v.Normal));
+          else
+            v.Normal = glm::vec3(0.0f);
+          if (uvs.data) {
+            const unsigned char *p = uvs.data + i * uvs.stride;
+            size_t size = componentSize(uvs.componentType);
+            v.TexCoords = {
+                readComponent(p, uvs.componentType, uvs.normalized),
+                readComponent(p + size, uvs.componentType, uvs.normalized)};
+          } else {
+            v.TexCoords = glm::vec2(0.0f);
+          }
+          // One whole-struct store per vertex keeps writes to the
+          // write-combined mapping sequential.
+          dst[i] = v;
+        }
+      },
+      4096);
+}
+
+template <typename Index>
+void writeIndices(const AccessorView &indices, size_t indexCount, Index *dst) {
+  JobSystem::get().parallelFor(
+      indexCount,
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+          dst[i] = static_cast<Index>(indices.data ? readIndex(indices, i)
+                                                   : i);
+      },
+      16384);
+}
+
+std::shared_ptr<Mesh> uploadPrimitive(const AccessorView &positions,
+                                      const AccessorView &normals,
+                                      const AccessorView &uvs,
+                                      const AccessorView &indices,
+                                      const BoundingBox &bounds) {
+  GeometryManager &geometry = GeometryManager::get();
+  const size_t vertexCount = positions.count;
+  const size_t indexCount = indices.data ? indices.count : vertexCount;
+  const bool shortIndices =
+      GeometryManager::chooseIndexType(vertexCount) == IndexType::UInt16;
+  const bool directIndices =
+      indices.data &&
+      (shortIndices ? indices.componentType == COMPONENT_UNSIGNED_SHORT &&
+                          indices.stride == sizeof(uint16_t)
+                    : indices.componentType == COMPONENT_UNSIGNED_INT &&
+                          indices.stride == sizeof(unsigned int));
+
+  if (matchesVertexLayout(positions, normals, uvs) && directIndices) {
+    // glTF aligns accessors to their component size, so both ranges are
+    // suitably aligned views into the mapping.
+    const Vertex *vertices = reinterpret_cast<const Vertex *>(positions.data);
+    MeshRange range =
+        shortIndices
+            ? geometry.upload(
+                  vertices, vertexCount,
+                  reinterpret_cast<const uint16_t *>(indices.data), indexCount)
+            : geometry.upload(
+                  vertices, vertexCount,
+                  reinterpret_cast<const unsigned int *>(indices.data),
+                  indexCount);
+    return std::make_shared<Mesh>(range, bounds);
+  }
+
+  MeshRange range = geometry.upload(
+      vertexCount,
+      [&](Vertex *dst) { writeVertices(positions, normals, uvs, dst); },
+      indexCount, [&](void *dst, IndexType type) {
+        if (type == IndexType::UInt16)
+          writeIndices(indices, indexCount, static_cast<uint16_t *>(dst));
+        else
+          writeIndices(indices, indexCount, static_cast<unsigned int *>(dst));
+      });
+  return std::make_shared<Mesh>(range, bounds);
+}
+
+void collectNodeMeshes(const json &doc, size_t node, std::vector<bool> &visited,
+                       std::vector<size_t> &meshes) {
+  if (node >= visited.size() || visited[node])
+    return;
+  visited[node] = true;
+
+  const json &n = doc["nodes"][node];
+  if (n.contains("mesh"))
+    meshes.push_back(n["mesh"].get<size_t>());
+  if (n.contains("children"))
+    for (const json &child : n["children"])
+      collectNodeMeshes(doc, child.get<size_t>(), visited, meshes);
+}
+
+// Meshes in the order Model::collectMeshes would see them through Assimp:
+// a depth-first walk of the default scene.
+std::vector<size_t> collectMeshes(const json &doc) {
+  std::vector<size_t> meshes;
+  size_t meshCount = doc.contains("meshes") ? doc["meshes"].size() : 0;
+
+  if (doc.contains("scenes") && doc.contains("nodes") &&
+      !doc["scenes"].empty()) {
+    size_t scene = doc.value("scene", size_t(0));
+    if (scene >= doc["scenes"].size())
+      scene = 0;
+    std::vector<bool> visited(doc["nodes"].size(), false);
+    if (doc["scenes"][scene].contains("nodes"))
+      for (const json &node : doc["scenes"][scene]["nodes"])
+        collectNodeMeshes(doc, node.get<size_t>(), visited, meshes);
+  } else {
+    for (size_t i = 0; i < meshCount; i++)
+      meshes.push_back(i);
+  }
+
+  meshes.erase(std::remove_if(meshes.begin(), meshes.end(),
+                              [meshCount](size_t m) { return m >= meshCount; }),
+               meshes.end());
+  return meshes;
+}
+
+void addTexture(const json &doc, const std::shared_ptr<GlbFile> &glb,
+                const json &textureInfo, const std::string &path,
+                const std::string &directory, const std::string &uniformName,
+                TextureType type, ModelPartData &part) {
+  if (!textureInfo.contains("index") || !doc.contains("textures"))
+    return;
+  size_t textureIndex = textureInfo["index"].get<size_t>();
+  if (textureIndex >= doc["textures"].size())
+    return;
+  const json &texture = doc["textures"][textureIndex];
+  if (!texture.contains("source") || !doc.contains("images"))
+    return;
+  size_t imageIndex = texture["source"].get<size_t>();
+  if (imageIndex >= doc["images"].size())
+    return;
+  const json &image = doc["images"][imageIndex];
+
+  ModelTextureRef ref;
+  ref.uniformName = uniformName;
+  ref.type = type;
+
+  if (image.contains("bufferView")) {
+    size_t viewIndex = image["bufferView"].get<size_t>();
+    if (viewIndex >= doc["bufferViews"].size())
+      return;
+    const json &bufferView = doc["bufferViews"][viewIndex];
+    size_t offset = bufferView.value("byteOffset", size_t(0));
+    size_t length = bufferView.value("byteLength", size_t(0));
+    if (offset > glb->binSize || length > glb->binSize - offset)
+      return;
+
+    ref.path = path + "#image" + std::to_string(imageIndex);
+    ref.owner = glb;
+    ref.encoded = glb->bin + offset;
+    ref.encodedSize = length;
+  } else {
+    std::string uri = image.value("uri", "");
+    if (uri.empty() || uri.rfind("data:", 0) == 0) {
+      LOG_CORE_WARN("GltfLoader: skipping data-URI image in {0}", path);
+      return;
+    }
+    ref.path = directory + "/" + uri;
+  }
+
+  part.textures.push_back(std::move(ref));
+}
+
+void addMaterialTextures(const json &doc, const std::shared_ptr<GlbFile> &glb,
+                         size_t materialIndex, const std::string &path,
+                         const std::string &directory, ModelPartData &part) {
+  if (!doc.contains("materials") || materialIndex >= doc["materials"].size())
+    return;
+  const json &material = doc["materials"][materialIndex];
+
+  // Same mapping as Assimp's glTF importer: base color is the diffuse map,
+  // and the specular-glossiness extension supplies the specular one.
+  const json empty = json::object();
+  const json &pbr = material.value("pbrMetallicRoughness", empty);
+  const json &extensions = material.value("extensions", empty);
+  const json &specGloss =
+      extensions.value("KHR_materials_pbrSpecularGlossiness", empty);
+
+  if (pbr.contains("baseColorTexture"))
+    addTexture(doc, glb, pbr["baseColorTexture"], path, directory,
+               "texture_diffuse", TextureType::Diffuse, part);
+  else if (specGloss.contains("diffuseTexture"))
+    addTexture(doc, glb, specGloss["diffuseTexture"], path, directory,
+               "texture_diffuse", TextureType::Diffuse, part);
+
+  if (specGloss.contains("specularGlossinessTexture"))
+    addTexture(doc, glb, specGloss["specularGlossinessTexture"], path,
+               directory, "texture_specular", TextureType::Specular, part);
+}
+
+} // namespace
+
+bool GltfLoader::canLoad(const std::string &path) {
+  std::string extension = std::filesystem::path(path).extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return extension == ".glb";
+}
+
+bool GltfLoader::load(const std::string &path,
+                      std::vector<ModelPartData> &parts,
+                      bool stageForMeshlets, bool stageForSplit) {
+  auto glb = std::make_shared<GlbFile>();
+  if (!glb->file.open(path) || glb->file.size() < 20)
+    return false;
+
+  const char *data = glb->file.data();
+  const size_t size = glb->file.size();
+  if (readU32(data) != GLB_MAGIC || readU32(data + 4) != 2 ||
+      readU32(data + 8) > size)
+    return false;
+
+  size_t jsonLength = readU32(data + 12);
+  if (readU32(data + 16) != CHUNK_JSON || 20 + jsonLength > size)
+    return false;
+
+  // Chunks are 4-byte aligned; the binary chunk, if any, follows the JSON.
+  size_t binHeader = 20 + ((jsonLength + 3) & ~size_t(3));
+  if (binHeader + 8 <= size && readU32(data + binHeader + 4) == CHUNK_BIN) {
+    size_t binLength = readU32(data + binHeader);
+    if (binHeader + 8 + binLength > size)
+      return false;
+    glb->bin = reinterpret_cast<const unsigned char *>(data + binHeader + 8);
+    glb->binSize = binLength;
+  }
+
+  json doc;
+  try {
+    doc = json::parse(data + 20, data + 20 + jsonLength);
+  } catch (const json::exception &e) {
+    LOG_CORE_WARN("GltfLoader: invalid JSON in {0}: {1}", path, e.what());
+    return false;
+  }
+
+  // Buffer 0 is the binary chunk; external .bin files go through Assimp.
+  if (doc.contains("buffers"))
+    for (const json &buffer : doc["buffers"])
+      if (buffer.contains("uri")) {
+        LOG_CORE_INFO("GltfLoader: {0} references external buffers", path);
+        return false;
+      }
+
+  const std::string directory =
+      std::filesystem::path(path).parent_path().string();
+  std::vector<ModelPartData> result;
+
+  try {
+    for (size_t meshIndex : collectMeshes(doc)) {
+      const json &mesh = doc["meshes"][meshIndex];
+      if (!mesh.contains("primitives"))
+        continue;
+
+      for (const json &primitive : mesh["primitives"]) {
+        if (primitive.value("mode", MODE_TRIANGLES) != MODE_TRIANGLES)
+          continue;
+
+        const json &attributes = primitive["attributes"];
+        if (!attributes.contains("POSITION"))
+          continue;
+
+        size_t positionAccessor = attributes["POSITION"].get<size_t>();
+        AccessorView positions, normals, uvs, indices;
+        if (!resolveAccessor(doc, *glb, positionAccessor, positions) ||
+            !isFloatVec3(positions))
+          return false;
+        if (attributes.contains("NORMAL") &&
+            (!resolveAccessor(doc, *glb, attributes["NORMAL"].get<size_t>(),
+                              normals) ||
+             !isFloatVec3(normals) || normals.count != positions.count))
+          return false;
+        if (attributes.contains("TEXCOORD_0") &&
+            (!resolveAccessor(doc, *glb,
+                              attributes["TEXCOORD_0"].get<size_t>(), uvs) ||
+             uvs.components != 2 || uvs.count != positions.count))
+          return false;
+        if (primitive.contains("indices")) {
+          if (!resolveAccessor(doc, *glb, primitive["indices"].get<size_t>(),
+                               indices) ||
+              indices.components != 1 || !isIndexType(indices.componentType))
+            return false;
+
+          // Out-of-range indices would read other meshes' vertices out of
+          // the shared buffer.
+          for (size_t i = 0; i < indices.count; i++) {
+            if (readIndex(indices, i) >= positions.count) {
+              LOG_CORE_WARN("GltfLoader: {0} has out-of-range indices", path);
+              return false;
+            }
+          }
+        }
+
+        BoundingBox bounds =
+            computeBounds(doc["accessors"][positionAccessor], positions);
+
+        ModelPartData part;
+        part.occluder = OccluderMesh::build(
+            positions.data, positions.stride, positions.count, indices.data,
+            indices.data ? componentSize(indices.componentType) : 0,
+            indices.count);
+        const AccessorView views[] = {positions, normals, uvs, indices};
+        part.contentHash = hashPrimitive(views, 4);
+        const size_t indexCount =
+            indices.data ? indices.count : positions.count;
+        if (normals.data &&
+            !(stageForMeshlets &&
+              indexCount / 3 >= Meshlet::MIN_MESH_TRIANGLES) &&
+            !(stageForSplit &&
+              positions.count > GeometryManager::MAX_16BIT_VERTICES)) {
+          part.createMesh = [glb, positions, normals, uvs, indices,
+                             bounds]() {
+            return uploadPrimitive(positions, normals, uvs, indices, bounds);
+          };
+          part.vertexCount = positions.count;
+          part.indexCount = indexCount;
+        } else {
+          // Staged on the CPU so the import can generate the normals, build
+          // meshlets or split the mesh.
+          part.vertices.resize(positions.count);
+          writeVertices(positions, normals, uvs, part.vertices.data());
+          part.indices.resize(indexCount);
+          writeIndices(indices, indexCount, part.indices.data());
+        }
+        if (primitive.contains("material"))
+          addMaterialTextures(doc, glb, primitive["material"].get<size_t>(),
+                              path, directory, part);
+
+        result.push_back(std::move(part));
+      }
+    }
+  } catch (const json::exception &e) {
+    LOG_CORE_WARN("GltfLoader: malformed {0}: {1}", path, e.what());
+    return false;
+  }
+
+  parts = std::move(result);
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Scene/Model.hpp"
+
+#include <string>
+#include <vector>
+
+// Native reader for binary glTF (.glb). Only the JSON chunk is parsed up
+// front: every part's createMesh uploads vertex and index data to the
+// GeometryManager straight from the memory-mapped binary chunk (with no
+// repacking at all when an interleaved view already matches Vertex), and
+// embedded images are decoded in place. The mapping is shared by the parts
+// and their texture refs, and goes away with the last of them. Primitives
+// without normals are staged on the CPU instead, so the import can generate
+// them, and so are large ones when meshlets or 16-bit splitting are wanted.
+class GltfLoader {
+public:
+  static bool canLoad(const std::string &path);
+
+  // Returns false when the file needs something this reader does not handle
+  // (external or data-URI buffers, sparse or quantized positions, ...), so
+  // the caller can fall back to Assimp.
+  static bool load(const std::string &path, std::vector<ModelPartData> &parts,
+                   bool stageForMeshlets = false, bool stageForSplit = false);
+};
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "Scene/ImportPipeline.hpp"
+#include "Core/Log.hpp"
+#include "Graphics/GeometryManager.hpp"
+#include "Scene/Model.hpp"
+
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+namespace {
+
+// Above the 32 aiProcess_* bits.
+constexpr uint64_t KEY_NATIVE_READERS = 1ull << 32;
+constexpr uint64_t KEY_SPLIT_16BIT_MESHES = 1ull << 33;
+constexpr uint64_t KEY_MESHLETS = 1ull << 34;
+
+constexpr unsigned int FAST_STEPS = aiProcess_Triangulate | aiProcess_FlipUVs;
+constexpr unsigned int BALANCED_STEPS =
+    FAST_STEPS | aiProcess_FindDegenerates | aiProcess_SortByPType |
+    aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices |
+    aiProcess_ImproveCacheLocality;
+constexpr unsigned int MAX_QUALITY_STEPS =
+    BALANCED_STEPS | aiProcess_ValidateDataStructure |
+    aiProcess_FindInvalidData | aiProcess_RemoveRedundantMaterials |
+    aiProcess_OptimizeMeshes | aiProcess_SplitLargeMeshes;
+
+} // namespace
+
+ImportOptions ImportOptions::fromConfig(const ImportConfig &config) {
+  ImportOptions options;
+  options.preset = config.Preset;
+  options.logStages = config.LogStages;
+  options.split16BitMeshes = config.Split16BitMeshes;
+  options.buildMeshlets = config.Meshlets;
+  switch (config.Preset) {
+  case ImportPreset::Fast:
+    options.assimpSteps = FAST_STEPS;
+    break;
+  case ImportPreset::Balanced:
+    options.assimpSteps = BALANCED_STEPS;
+    break;
+  case ImportPreset::MaxQuality:
+    options.assimpSteps = MAX_QUALITY_STEPS;
+    options.nativeReaders = false;
+    break;
+  }
+  return options;
+}
+
+ImportOptions ImportOptions::fromKeyFlags(uint64_t keyFlags,
+                                          const ImportConfig &config) {
+  ImportOptions options = fromConfig(config);
+  options.assimpSteps = static_cast<unsigned int>(keyFlags & 0xFFFFFFFFu);
+  options.nativeReaders = keyFlags & KEY_NATIVE_READERS;
+  options.split16BitMeshes = keyFlags & KEY_SPLIT_16BIT_MESHES;
+  options.buildMeshlets = keyFlags & KEY_MESHLETS;
+  for (ImportPreset preset : {ImportPreset::Fast, ImportPreset::Balanced,
+                              ImportPreset::MaxQuality}) {
+    ImportConfig presetConfig;
+    presetConfig.Preset = preset;
+    if (fromConfig(presetConfig).assimpSteps == options.assimpSteps)
+      options.preset = preset;
+  }
+  return options;
+}
+
+const char *ImportOptions::getPresetName(ImportPreset preset) {
+  switch (preset) {
+  case ImportPreset::Fast:
+    return "Fast";
+  case ImportPreset::Balanced:
+    return "Balanced";
+  case ImportPreset::MaxQuality:
+    return "MaxQuality";
+  }
+  return "Unknown";
+}
+
+uint64_t ImportOptions::getKeyFlags() const {
+  return assimpSteps | (nativeReaders ? KEY_NATIVE_READERS : 0) |
+         (split16BitMeshes ? KEY_SPLIT_16BIT_MESHES : 0) |
+         (buildMeshlets ? KEY_MESHLETS : 0);
+}
+
+size_t GeometryCount::getBytes() const {
+  return vertices * sizeof(Vertex) + indexBytes;
+}
+
+GeometryCount GeometryCount::of(const aiScene &scene) {
+  GeometryCount count;
+  count.meshes = scene.mNumMeshes;
+  for (unsigned int m = 0; m < scene.mNumMeshes; m++) {
+    const aiMesh *mesh = scene.mMeshes[m];
+    count.vertices += mesh->mNumVertices;
+    size_t indices = 0;
+    for (unsigned int f = 0; f < mesh->mNumFaces; f++)
+      indices += mesh->mFaces[f].mNumIndices;
+    count.indices += indices;
+    count.indexBytes +=
+        indices * getIndexSize(
+                      GeometryManager::chooseIndexType(mesh->mNumVertices));
+  }
+  return count;
+}
+
+void GeometryCount::add(const ModelPartData &part) {
+  const size_t partVertices =
+      part.createMesh ? part.vertexCount : part.vertices.size();
+  const size_t partIndices =
+      part.createMesh ? part.indexCount : part.indices.size();
+  meshes++;
+  vertices += partVertices;
+  indices += partIndices;
+  indexBytes += partIndices *
+                getIndexSize(GeometryManager::chooseIndexType(partVertices));
+}
+
+GeometryCount GeometryCount::of(const std::vector<ModelPartData> &parts) {
+  GeometryCount count;
+  for (const ModelPartData &part : parts)
+    count.add(part);
+  return count;
+}
+
+void ImportReport::add(const std::string &name, Clock::time_point start,
+                       const GeometryCount &before,
+                       const GeometryCount &after) {
+  add(name,
+      std::chrono::duration<float, std::milli>(Clock::now() - start).count(),
+      before, after);
+}
+
+void ImportReport::add(const std::string &name, float milliseconds,
+                       const GeometryCount &before,
+                       const GeometryCount &after) {
+  m_stages.push_back({name, milliseconds, before, after});
+}
+
+float ImportReport::getMilliseconds() const {
+  float total = 0.0f;
+  for (const ImportStage &stage : m_stages)
+    total += stage.milliseconds;
+  return total;
+}
+
+void ImportReport::log(const std::string &path,
+                       const ImportOptions &options) const {
+  GeometryCount result = m_stages.empty() ? GeometryCount()
+                                          : m_stages.back().after;
+  LOG_CORE_INFO("Import {0} [{1}]: {2:.1f} ms, {3} meshes, {4} vertices, "
+                "{5} triangles, {6:.2f} MB",
+                path, ImportOptions::getPresetName(options.preset),
+                getMilliseconds(), result.meshes, result.vertices,
+                result.indices / 3, result.getBytes() / (1024.0 * 1024.0));
+  if (!options.logStages)
+    return;
+  for (const ImportStage &stage : m_stages) {
+    LOG_CORE_INFO("  {0}: {1:.2f} ms, {2} -> {3} vertices, "
+                  "{4:.2f} -> {5:.2f} MB",
+                  stage.name, stage.milliseconds, stage.before.vertices,
+                  stage.after.vertices,
+                  stage.before.getBytes() / (1024.0 * 1024.0),
+                  stage.after.getBytes() / (1024.0 * 1024.0));
+  }
+}
\ No newline at end of file
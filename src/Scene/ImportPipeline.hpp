@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct aiScene;
+struct ModelPartData;
+
+// What an ImportPreset turns into.
+struct ImportOptions {
+  ImportPreset preset = ImportPreset::Balanced;
+  // aiProcess_* steps. They are applied one at a time, in a fixed order, so
+  // each can be timed on its own.
+  unsigned int assimpSteps = 0;
+  // The native OBJ/GLB readers weld vertices themselves but run none of the
+  // Assimp steps.
+  bool nativeReaders = true;
+  bool logStages = true;
+  bool split16BitMeshes = false;
+  bool buildMeshlets = true;
+
+  static ImportOptions fromConfig(const ImportConfig &config);
+  // The options getKeyFlags() was taken from, e.g. to repeat an import the
+  // same way; stage logging follows `config`.
+  static ImportOptions fromKeyFlags(uint64_t keyFlags,
+                                    const ImportConfig &config);
+  static const char *getPresetName(ImportPreset preset);
+  // Distinguishes imports of one file under different options in the model
+  // registry.
+  uint64_t getKeyFlags() const;
+};
+
+// Size of a model's geometry at some point of the import.
+struct GeometryCount {
+  size_t meshes = 0;
+  size_t vertices = 0;
+  size_t indices = 0;
+  // Each mesh's indices at the width the GeometryManager will pick.
+  size_t indexBytes = 0;
+
+  // As it will be stored in the GeometryManager.
+  size_t getBytes() const;
+  void add(const ModelPartData &part);
+
+  static GeometryCount of(const aiScene &scene);
+  static GeometryCount of(const std::vector<ModelPartData> &parts);
+};
+
+struct ImportStage {
+  std::string name;
+  float milliseconds = 0.0f;
+  GeometryCount before;
+  GeometryCount after;
+};
+
+// Wall time and geometry counts of every stage of one model import.
+class ImportReport {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // Records a stage that started at `start` and ends now.
+  void add(const std::string &name, Clock::time_point start,
+           const GeometryCount &before, const GeometryCount &after);
+  void add(const std::string &name, float milliseconds,
+           const GeometryCount &before, const GeometryCount &after);
+
+  const std::vector<ImportStage> &getStages() const { return m_stages; }
+  float getMilliseconds() const;
+
+  // One summary line, plus a line per stage when the options ask for it.
+  void log(const std::string &path, const ImportOptions &options) const;
+
+private:
+  std::vector<ImportStage> m_stages;
+};
\ No newline at end of file
@@ -1,49 +1,396 @@
 #include "Scene/Model.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/Log.hpp"
+#include "Graphics/GeometryManager.hpp"
+#include "Scene/GltfLoader.hpp"
+#include "Scene/ObjLoader.hpp"
 
+#include <algorithm>
+#include <assimp/config.h>
 #include <filesystem>
+#include <utility>
 
 Model::Model(const std::string &path, ResourceManager &rm,
              std::shared_ptr<Shader> defaultShader)
+    : Model(path, rm, std::move(defaultShader),
+            ImportOptions::fromConfig(rm.getImportConfig())) {}
+
+Model::Model(const std::string &path, ResourceManager &rm,
+             std::shared_ptr<Shader> defaultShader,
+             const ImportOptions &options)
     : m_resourceManager(rm), m_defaultShader(defaultShader) {
-  loadModel(path);
+  loadModel(path, options);
 }
 
 void Model::addToScene(Scene &scene, const Transform &transform) {
-  for (const auto &part : m_parts) {
-    scene.addEntity(part.mesh, part.material, transform);
+  int model = scene.registerModel(m_path, m_keyFlags);
+  for (size_t i = 0; i < m_parts.size(); i++) {
+    scene.addEntity(m_parts[i].mesh, m_parts[i].material, transform, model,
+                    static_cast<int>(i));
   }
 }
 
-void Model::loadModel(const std::string &path) {
-  Assimp::Importer importer;
-  const aiScene *scene =
-      importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+void Model::loadModel(const std::string &path,
+                      const ImportOptions &options) {
+  m_path = path;
+  std::filesystem::path p(path);
+  m_directory = p.parent_path().string();
+  m_keyFlags = options.getKeyFlags();
 
-  if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
-      !scene->mRootNode) {
-    LOG_CORE_ERROR("Assimp Error ({0}): {1}", path, importer.GetErrorString());
-    throw std::runtime_error("ERROR::MODEL::FAILED_TO_LOAD_SCENE");
+  const std::string key = ResourceManager::modelKey(path, m_keyFlags);
+  if (m_resourceManager.getModel(key, m_parts))
+    return;
+
+  ImportReport report;
+  std::vector<ModelPartData> parts;
+  if (!options.nativeReaders || !importNative(path, parts, options, report)) {
+    Assimp::Importer importer;
+    const aiScene *scene = importAssimp(importer, path, options, report);
+
+    if (!scene) {
+      LOG_CORE_ERROR("Assimp Error ({0}): {1}", path,
+                     importer.GetErrorString());
+      throw std::runtime_error("ERROR::MODEL::FAILED_TO_LOAD_SCENE");
+    }
+
+    std::vector<const aiMesh *> meshes;
+    collectMeshes(scene->mRootNode, scene, meshes);
+
+    auto start = ImportReport::Clock::now();
+    const GeometryCount before = GeometryCount::of(*scene);
+    parts.reserve(meshes.size());
+    for (const aiMesh *mesh : meshes)
+      parts.push_back(importPart(mesh, scene, m_directory));
+    report.add("Convert", start, before, GeometryCount::of(parts));
+
+    if (options.split16BitMeshes) {
+      start = ImportReport::Clock::now();
+      const GeometryCount converted = GeometryCount::of(parts);
+      splitParts(parts);
+      report.add("Split", start, converted, GeometryCount::of(parts));
+    }
+    if (options.buildMeshlets) {
+      start = ImportReport::Clock::now();
+      const GeometryCount geometry = GeometryCount::of(parts);
+      buildMeshlets(parts);
+      report.add("Meshlets", start, geometry, geometry);
+    }
   }
 
-  std::filesystem::path p(path);
-  m_directory = p.parent_path().string();
-  processNode(scene->mRootNode, scene);
+  auto start = ImportReport::Clock::now();
+  const GeometryCount geometry = GeometryCount::of(parts);
+  for (ModelPartData &data : parts)
+    addPart(data);
+  report.add("Upload", start, geometry, geometry);
+
+  m_resourceManager.addModel(key, m_parts);
+  report.log(path, options);
+  logSavings(path, m_savings);
+}
+
+void Model::addPart(const ModelPartData &data) {
+  auto myMesh = createMesh(data, m_resourceManager, m_savings);
+  auto myMaterial = std::make_shared<Material>(m_defaultShader);
+  for (const auto &ref : data.textures) {
+    std::shared_ptr<Texture> texture;
+    if (ref.encoded) {
+      texture = m_resourceManager.getTexture(ref.path);
+      if (!texture)
+        texture = m_resourceManager.addTexture(
+            ref.path, ref.type,
+            Texture::loadData(ref.encoded, ref.encodedSize, ref.type,
+                              m_resourceManager.getTextureConfig()),
+            &m_savings);
+    } else {
+      texture = m_resourceManager.getTexture(ref.path);
+      if (!texture)
+        texture = m_resourceManager.addTexture(
+            ref.path, ref.type,
+            Texture::loadData(ref.path, ref.type,
+                              m_resourceManager.getTextureConfig()),
+            &m_savings);
+    }
+    myMaterial->setTexture(ref.uniformName, texture);
+  }
+
+  m_parts.push_back({myMesh, myMaterial});
+}
+
+std::shared_ptr<Mesh> Model::createMesh(const ModelPartData &data,
+                                        ResourceManager &rm,
+                                        DedupSavings &savings) {
+  const bool hashed = data.contentHash != Hash128();
+  // The same geometry with and without meshlets draws differently, so the
+  // clusters are part of the key.
+  Hash128 hash = data.contentHash;
+  if (hashed && !data.meshlets.empty())
+    hash = Hash::content128(data.meshlets.data(),
+                            data.meshlets.size() * sizeof(Meshlet), hash);
+  if (hashed) {
+    if (auto mesh = rm.findMesh(hash, &savings))
+      return mesh;
+  }
+
+  auto mesh = data.createMesh
+                  ? data.createMesh()
+                  : std::make_shared<Mesh>(data.vertices, data.indices,
+                                           data.meshlets);
+  mesh->setOccluder(data.occluder);
+  if (hashed)
+    rm.addMesh(hash, mesh);
+  return mesh;
 }
 
-void Model::processNode(aiNode *node, const aiScene *scene) {
+Hash128 Model::hashGeometry(const std::vector<Vertex> &vertices,
+                            const std::vector<unsigned int> &indices) {
+  Hash128 hash =
+      Hash::content128(vertices.data(), vertices.size() * sizeof(Vertex));
+  return Hash::content128(indices.data(),
+                          indices.size() * sizeof(unsigned int), hash);
+}
+
+bool Model::fillMissingNormals(ModelPartData &part) {
+  std::vector<Vertex> &vertices = part.vertices;
+  const glm::vec3 zero(0.0f);
+  if (std::none_of(vertices.begin(), vertices.end(),
+                   [&zero](const Vertex &v) { return v.Normal == zero; }))
+    return false;
+
+  // Unnormalized cross products weigh each triangle by its area.
+  std::vector<glm::vec3> sums(vertices.size(), zero);
+  const std::vector<unsigned int> &indices = part.indices;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const unsigned int a = indices[i], b = indices[i + 1], c = indices[i + 2];
+    const glm::vec3 normal =
+        glm::cross(vertices[b].Position - vertices[a].Position,
+                   vertices[c].Position - vertices[a].Position);
+    sums[a] += normal;
+    sums[b] += normal;
+    sums[c] += normal;
+  }
+
+  for (size_t i = 0; i < vertices.size(); i++) {
+    if (vertices[i].Normal == zero && glm::dot(sums[i], sums[i]) > 0.0f)
+      vertices[i].Normal = glm::normalize(sums[i]);
+  }
+  return true;
+}
+
+std::vector<ModelPartData> Model::splitPart(ModelPartData part) {
+  std::vector<ModelPartData> chunks;
+  if (part.createMesh ||
+      part.vertices.size() <= GeometryManager::MAX_16BIT_VERTICES) {
+    chunks.push_back(std::move(part));
+    return chunks;
+  }
+
+  constexpr unsigned int UNASSIGNED = ~0u;
+  std::vector<unsigned int> remap(part.vertices.size(), UNASSIGNED);
+  std::vector<unsigned int> used;
+  ModelPartData chunk;
+  auto flush = [&]() {
+    for (unsigned int v : used)
+      remap[v] = UNASSIGNED;
+    used.clear();
+    chunk.textures = part.textures;
+    chunks.push_back(std::move(chunk));
+    chunk = ModelPartData();
+  };
+
+  const std::vector<unsigned int> &indices = part.indices;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const unsigned int a = indices[i], b = indices[i + 1], c = indices[i + 2];
+    const size_t added = (remap[a] == UNASSIGNED) +
+                         (remap[b] == UNASSIGNED && b != a) +
+                         (remap[c] == UNASSIGNED && c != a && c != b);
+    if (chunk.vertices.size() + added > GeometryManager::MAX_16BIT_VERTICES)
+      flush();
+
+    for (size_t k = i; k < i + 3; k++) {
+      unsigned int &slot = remap[indices[k]];
+      if (slot == UNASSIGNED) {
+        slot = static_cast<unsigned int>(chunk.vertices.size());
+        chunk.vertices.push_back(part.vertices[indices[k]]);
+        used.push_back(indices[k]);
+      }
+      chunk.indices.push_back(slot);
+    }
+  }
+  if (!chunk.indices.empty())
+    flush();
+  if (chunks.empty()) {
+    chunks.push_back(std::move(part));
+    return chunks;
+  }
+
+  JobSystem::get().parallelFor(chunks.size(), [&chunks](size_t begin,
+                                                         size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      chunks[i].occluder =
+          OccluderMesh::build(chunks[i].vertices, chunks[i].indices);
+      chunks[i].contentHash =
+          hashGeometry(chunks[i].vertices, chunks[i].indices);
+    }
+  });
+  return chunks;
+}
+
+void Model::splitParts(std::vector<ModelPartData> &parts) {
+  std::vector<ModelPartData> result;
+  result.reserve(parts.size());
+  for (ModelPartData &part : parts) {
+    for (ModelPartData &chunk : splitPart(std::move(part)))
+      result.push_back(std::move(chunk));
+  }
+  parts = std::move(result);
+}
+
+void Model::buildMeshlets(std::vector<ModelPartData> &parts) {
+  JobSystem::get().parallelFor(parts.size(), [&parts](size_t begin,
+                                                      size_t end) {
+    for (size_t i = begin; i < end; i++)
+      parts[i].meshlets =
+          Meshlet::build(parts[i].vertices, parts[i].indices);
+  });
+}
+
+void Model::logSavings(const std::string &path, const DedupSavings &savings) {
+  if (savings.meshes == 0 && savings.textures == 0)
+    return;
+  LOG_CORE_INFO("{0}: {1} duplicate meshes and {2} duplicate textures "
+                "shared, {3:.2f} MB saved",
+                path, savings.meshes, savings.textures,
+                savings.bytes / (1024.0 * 1024.0));
+}
+
+bool Model::importNative(const std::string &path,
+                         std::vector<ModelPartData> &parts,
+                         const ImportOptions &options, ImportReport &report,
+                         const std::function<bool(float)> &onProgress) {
+  auto start = ImportReport::Clock::now();
+  bool tried = false;
+  bool loaded = false;
+  if (GltfLoader::canLoad(path)) {
+    tried = true;
+    loaded = GltfLoader::load(path, parts, options.buildMeshlets,
+                              options.split16BitMeshes);
+  } else if (ObjLoader::canLoad(path)) {
+    tried = true;
+    loaded = ObjLoader::load(path, parts, onProgress);
+  }
+
+  if (tried && !loaded) {
+    LOG_CORE_INFO("Falling back to Assimp for {0}", path);
+    return false;
+  }
+
+  if (loaded) {
+    GeometryCount geometry = GeometryCount::of(parts);
+    report.add("Parse", start, GeometryCount(), geometry);
+
+    start = ImportReport::Clock::now();
+    JobSystem::get().parallelFor(parts.size(), [&parts](size_t begin,
+                                                        size_t end) {
+      for (size_t i = begin; i < end; i++)
+        fillMissingNormals(parts[i]);
+    });
+    report.add("Normals", start, geometry, geometry);
+
+    if (options.split16BitMeshes) {
+      start = ImportReport::Clock::now();
+      splitParts(parts);
+      const GeometryCount split = GeometryCount::of(parts);
+      report.add("Split", start, geometry, split);
+      geometry = split;
+    }
+
+    if (options.buildMeshlets) {
+      start = ImportReport::Clock::now();
+      buildMeshlets(parts);
+      report.add("Meshlets", start, geometry, geometry);
+    }
+
+    start = ImportReport::Clock::now();
+    JobSystem::get().parallelFor(parts.size(), [&parts](size_t begin,
+                                                        size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        if (parts[i].vertices.empty())
+          continue;
+        if (!parts[i].occluder)
+          parts[i].occluder =
+              OccluderMesh::build(parts[i].vertices, parts[i].indices);
+        parts[i].contentHash =
+            hashGeometry(parts[i].vertices, parts[i].indices);
+      }
+    });
+    report.add("Occluders + hashes", start, geometry, geometry);
+  }
+  return loaded;
+}
+
+const aiScene *Model::importAssimp(Assimp::Importer &importer,
+                                   const std::string &path,
+                                   const ImportOptions &options,
+                                   ImportReport &report) {
+  // Pipeline order; Assimp runs combined flags in much the same order.
+  static const std::pair<unsigned int, const char *> STEPS[] = {
+      {aiProcess_ValidateDataStructure, "ValidateDataStructure"},
+      {aiProcess_Triangulate, "Triangulate"},
+      {aiProcess_RemoveRedundantMaterials, "RemoveRedundantMaterials"},
+      {aiProcess_FindDegenerates, "FindDegenerates"},
+      {aiProcess_SortByPType, "SortByPType"},
+      {aiProcess_FindInvalidData, "FindInvalidData"},
+      {aiProcess_OptimizeMeshes, "OptimizeMeshes"},
+      {aiProcess_FlipUVs, "FlipUVs"},
+      {aiProcess_GenNormals, "GenNormals"},
+      {aiProcess_GenSmoothNormals, "GenSmoothNormals"},
+      {aiProcess_JoinIdenticalVertices, "JoinIdenticalVertices"},
+      {aiProcess_SplitLargeMeshes, "SplitLargeMeshes"},
+      {aiProcess_ImproveCacheLocality, "ImproveCacheLocality"}};
+
+  // Degenerate triangles are dropped rather than turned into lines and
+  // points, and whatever lines and points remain are split off and dropped.
+  importer.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, true);
+  importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE,
+                              aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+
+  auto start = ImportReport::Clock::now();
+  const aiScene *scene = importer.ReadFile(path, 0);
+  if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
+      !scene->mRootNode)
+    return nullptr;
+  GeometryCount geometry = GeometryCount::of(*scene);
+  report.add("Read", start, GeometryCount(), geometry);
+
+  for (const auto &[step, name] : STEPS) {
+    if (!(options.assimpSteps & step))
+      continue;
+    start = ImportReport::Clock::now();
+    scene = importer.ApplyPostProcessing(step);
+    if (!scene)
+      return nullptr;
+    GeometryCount after = GeometryCount::of(*scene);
+    report.add(name, start, geometry, after);
+    geometry = after;
+  }
+  return scene->mRootNode ? scene : nullptr;
+}
+
+void Model::collectMeshes(const aiNode *node, const aiScene *scene,
+                          std::vector<const aiMesh *> &meshes) {
   for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-    aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-    m_parts.push_back(processMesh(mesh, scene));
+    meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
   }
   for (unsigned int i = 0; i < node->mNumChildren; i++) {
-    processNode(node->mChildren[i], scene);
+    collectMeshes(node->mChildren[i], scene, meshes);
   }
 }
 
-Model::ModelPart Model::processMesh(aiMesh *mesh, const aiScene *scene) {
-  std::vector<Vertex> vertices;
-  std::vector<unsigned int> indices;
+ModelPartData Model::importPart(const aiMesh *mesh, const aiScene *scene,
+                                const std::string &directory) {
+  ModelPartData part;
+  part.vertices.reserve(mesh->mNumVertices);
+  part.indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
 
   for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
     Vertex v;
@@ -62,43 +409,42 @@ Model::ModelPart Model::processMesh(aiMesh *mesh, const aiScene *scene) {
     else
       v.TexCoords = {0.0f, 0.0f};
 
-    vertices.push_back(v);
+    part.vertices.push_back(v);
   }
 
   for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-    aiFace face = mesh->mFaces[i];
+    const aiFace &face = mesh->mFaces[i];
     for (unsigned int j = 0; j < face.mNumIndices; j++) {
-      indices.push_back(face.mIndices[j]);
+      part.indices.push_back(face.mIndices[j]);
     }
   }
-
-  auto myMesh = std::make_shared<Mesh>(vertices, indices);
-  auto myMaterial = std::make_shared<Material>(m_defaultShader);
+  fillMissingNormals(part);
+  part.occluder = OccluderMesh::build(part.vertices, part.indices);
+  part.contentHash = hashGeometry(part.vertices, part.indices);
 
   if (mesh->mMaterialIndex >= 0) {
-    aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
+    const aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
 
-    loadMaterialTextures(myMaterial, material, aiTextureType_DIFFUSE,
-                         "texture_diffuse");
-    loadMaterialTextures(myMaterial, material, aiTextureType_SPECULAR,
-                         "texture_specular");
+    addTextureRef(part, material, aiTextureType_DIFFUSE, "texture_diffuse",
+                  TextureType::Diffuse, directory);
+    addTextureRef(part, material, aiTextureType_SPECULAR, "texture_specular",
+                  TextureType::Specular, directory);
   }
 
-  return {myMesh, myMaterial};
+  return part;
 }
 
-void Model::loadMaterialTextures(std::shared_ptr<Material> mat,
-                                 aiMaterial *aiMat, aiTextureType type,
-                                 const std::string &typeName) {
+void Model::addTextureRef(ModelPartData &part, const aiMaterial *aiMat,
+                          aiTextureType type, const std::string &typeName,
+                          TextureType textureType,
+                          const std::string &directory) {
   // For simplicity, we only load the first texture of each type for now
   if (aiMat->GetTextureCount(type) > 0) {
     aiString str;
     aiMat->GetTexture(type, 0, &str);
 
     std::string filename = std::string(str.C_Str());
-    std::string fullPath = m_directory + "/" + filename;
-
-    auto texture = m_resourceManager.loadTexture(fullPath);
-    mat->setTexture(typeName, texture);
+    part.textures.push_back({typeName, directory + "/" + filename, textureType,
+                             nullptr, nullptr, 0});
   }
 }
\ No newline at end of file
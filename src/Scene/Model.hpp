@@ -1,33 +1,123 @@
 #pragma once
 
+#include "Core/Hash.hpp"
+#include "Graphics/OccluderMesh.hpp"
 #include "Graphics/ResourceManager.hpp"
+#include "Scene/ImportPipeline.hpp"
 #include "Scene/Scene.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <functional>
+#include <memory>
+
+// Texture a part wants, resolved relative to the model's directory.
+struct ModelTextureRef {
+  std::string uniformName;
+  std::string path;
+  TextureType type;
+
+  // Images embedded in the model file: `path` is then only a resource key,
+  // and the encoded bytes stay valid for as long as `owner` lives.
+  std::shared_ptr<const void> owner;
+  const unsigned char *encoded = nullptr;
+  size_t encodedSize = 0;
+};
+
+// CPU-side result of importing one mesh, before anything touches the GPU.
+struct ModelPartData {
+  std::vector<Vertex> vertices;
+  std::vector<unsigned int> indices;
+  std::vector<ModelTextureRef> textures;
+  // Simplified copy for occlusion culling; null for tiny meshes.
+  std::shared_ptr<const OccluderMesh> occluder;
+  // Of the geometry, for sharing identical meshes; zero if not computed.
+  Hash128 contentHash;
+  // Clusters over `indices`, which Meshlet::build() reordered to match.
+  std::vector<Meshlet> meshlets;
+
+  // Set instead of vertices/indices by loaders that upload straight from the
+  // source file. Main thread only. The counts describe what it uploads.
+  std::function<std::shared_ptr<Mesh>()> createMesh;
+  size_t vertexCount = 0;
+  size_t indexCount = 0;
+};
+
 class Model {
 public:
+  // Imports with the ResourceManager's import preset, or with `options`.
+  // Reuses the meshes and materials of an earlier load of the same file with
+  // the same options while any of its instances are still alive.
   Model(const std::string &path, ResourceManager &rm,
         std::shared_ptr<Shader> defaultShader);
+  Model(const std::string &path, ResourceManager &rm,
+        std::shared_ptr<Shader> defaultShader, const ImportOptions &options);
   void addToScene(Scene &scene, const Transform &transform = Transform());
 
-private:
-  struct ModelPart {
-    std::shared_ptr<Mesh> mesh;
-    std::shared_ptr<Material> material;
-  };
+  size_t getPartCount() const { return m_parts.size(); }
+  const std::shared_ptr<Mesh> &getMesh(size_t part) const {
+    return m_parts[part].mesh;
+  }
+  const std::shared_ptr<Material> &getMaterial(size_t part) const {
+    return m_parts[part].material;
+  }
+
+  // Thread-safe pieces of the import, shared with ModelLoader.
+
+  // Tries the native OBJ/GLB readers. False means Assimp has to handle the
+  // file (or the progress callback cancelled the load).
+  static bool importNative(const std::string &path,
+                           std::vector<ModelPartData> &parts,
+                           const ImportOptions &options, ImportReport &report,
+                           const std::function<bool(float)> &onProgress =
+                               nullptr);
+  // Reads the file and applies the options' Assimp steps one by one,
+  // recording each in `report`. Null if the file could not be read.
+  static const aiScene *importAssimp(Assimp::Importer &importer,
+                                     const std::string &path,
+                                     const ImportOptions &options,
+                                     ImportReport &report);
+  static void collectMeshes(const aiNode *node, const aiScene *scene,
+                            std::vector<const aiMesh *> &meshes);
+  static ModelPartData importPart(const aiMesh *mesh, const aiScene *scene,
+                                  const std::string &directory);
+  static Hash128 hashGeometry(const std::vector<Vertex> &vertices,
+                              const std::vector<unsigned int> &indices);
+  // Gives vertices with a zero normal the area-weighted average of their
+  // triangles' normals. False if every vertex already had one.
+  static bool fillMissingNormals(ModelPartData &part);
+  // Cuts a part with more vertices than 16-bit indices can address into
+  // chunks that fit, taking its triangles in order. Chunks share the part's
+  // textures and get their own occluder and hash. Anything else comes back
+  // as the only element.
+  static std::vector<ModelPartData> splitPart(ModelPartData part);
+  static void splitParts(std::vector<ModelPartData> &parts);
+  static void buildMeshlets(std::vector<ModelPartData> &parts);
 
-  std::vector<ModelPart> m_parts;
+  // Main thread: returns an existing mesh with the same content, or uploads
+  // the part's geometry and registers it.
+  static std::shared_ptr<Mesh> createMesh(const ModelPartData &data,
+                                          ResourceManager &rm,
+                                          DedupSavings &savings);
+  static void logSavings(const std::string &path,
+                         const DedupSavings &savings);
+
+private:
+  std::vector<SharedModelPart> m_parts;
+  DedupSavings m_savings;
+  std::string m_path;
   std::string m_directory;
+  uint64_t m_keyFlags = 0;
 
   ResourceManager &m_resourceManager;
   std::shared_ptr<Shader> m_defaultShader;
 
-  void loadModel(const std::string &path);
-  void processNode(aiNode *node, const aiScene *scene);
-  ModelPart processMesh(aiMesh *mesh, const aiScene *scene);
+  void loadModel(const std::string &path, const ImportOptions &options);
+  void addPart(const ModelPartData &data);
 
-  void loadMaterialTextures(std::shared_ptr<Material> mat, aiMaterial *aiMat,
-                            aiTextureType type, const std::string &typeName);
+  static void addTextureRef(ModelPartData &part, const aiMaterial *aiMat,
+                            aiTextureType type, const std::string &typeName,
+                            TextureType textureType,
+                            const std::string &directory);
 };
\ No newline at end of file
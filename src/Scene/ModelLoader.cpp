@@ -0,0 +1,310 @@
+#include "Scene/ModelLoader.hpp"
+#include "Core/Log.hpp"
+
+#include <assimp/ProgressHandler.hpp>
+#include <chrono>
+#include <filesystem>
+
+namespace {
+
+// Assimp owns this once it is handed to the importer. Returning false from
+// Update() aborts ReadFile, which is how cancellation reaches the parser.
+class ImportProgress : public Assimp::ProgressHandler {
+public:
+  ImportProgress(std::atomic<float> &progress, const ModelLoadHandle &handle)
+      : m_progress(progress), m_handle(handle) {}
+
+  bool Update(float percentage) override {
+    if (percentage >= 0.0f)
+      m_progress = 0.3f * percentage;
+    return !m_handle.isCancelled();
+  }
+
+private:
+  std::atomic<float> &m_progress;
+  const ModelLoadHandle &m_handle;
+};
+
+} // namespace
+
+bool ModelLoadHandle::isFinished() const {
+  ModelLoadState state = getState();
+  return state == ModelLoadState::Done || state == ModelLoadState::Failed ||
+         state == ModelLoadState::Cancelled;
+}
+
+float ModelLoadHandle::getProgress() const {
+  if (getState() == ModelLoadState::Done)
+    return 1.0f;
+
+  unsigned int parts = m_partCount.load();
+  float upload =
+      parts > 0 ? static_cast<float>(m_uploadedCount.load()) / parts : 0.0f;
+  return 0.5f * m_importProgress.load() + 0.5f * upload;
+}
+
+ModelLoader::ModelLoader(ResourceManager &resourceManager)
+    : m_resourceManager(resourceManager) {}
+
+ModelLoader::~ModelLoader() {
+  for (auto &job : m_jobs)
+    job->handle->cancel();
+  for (auto &job : m_jobs)
+    JobSystem::get().wait(job->importJob);
+}
+
+std::shared_ptr<ModelLoadHandle>
+ModelLoader::load(const std::string &path, Scene &scene,
+                  std::shared_ptr<Shader> shader, const Transform &transform) {
+  const ImportOptions options =
+      ImportOptions::fromConfig(m_resourceManager.getImportConfig());
+  const std::string key =
+      ResourceManager::modelKey(path, options.getKeyFlags());
+  std::vector<SharedModelPart> shared;
+  if (m_resourceManager.getModel(key, shared)) {
+    auto handle = std::make_shared<ModelLoadHandle>(path);
+    int modelId = scene.registerModel(path, options.getKeyFlags());
+    for (size_t i = 0; i < shared.size(); i++)
+      scene.addEntity(shared[i].mesh, shared[i].material, transform, modelId,
+                      static_cast<int>(i));
+    handle->m_partCount = static_cast<unsigned int>(shared.size());
+    handle->m_uploadedCount = static_cast<unsigned int>(shared.size());
+    handle->m_state = ModelLoadState::Done;
+    LOG_CORE_INFO("Model instanced: {0} ({1} shared parts)", path,
+                  shared.size());
+    return handle;
+  }
+
+  auto job = std::make_shared<Job>();
+  job->loader = this;
+  job->handle = std::make_shared<ModelLoadHandle>(path);
+  job->scene = &scene;
+  job->shader = std::move(shader);
+  job->transform = transform;
+  job->textureConfig = m_resourceManager.getTextureConfig();
+  job->modelId = scene.registerModel(path, options.getKeyFlags());
+  job->modelKey = key;
+  job->options = options;
+
+  LOG_CORE_INFO("Loading model: {0}", path);
+
+  JobSystem::get().runBackground([job]() { runImport(job); },
+                                 &job->importJob);
+
+  auto handle = job->handle;
+  m_jobs.push_back(std::move(job));
+  return handle;
+}
+
+void ModelLoader::runImport(const std::shared_ptr<Job> &jobPtr) {
+  Job &job = *jobPtr;
+  ModelLoadHandle &handle = *job.handle;
+  const std::string &path = handle.getPath();
+  std::unordered_set<std::string> decodedTextures;
+
+  std::vector<ModelPartData> parts;
+  bool loaded =
+      job.options.nativeReaders &&
+      Model::importNative(path, parts, job.options, job.report,
+                          [&handle](float progress) {
+                            handle.m_importProgress = 0.3f * progress;
+                            return !handle.isCancelled();
+                          });
+  if (handle.isCancelled())
+    return;
+
+  if (loaded) {
+    handle.m_partCount = static_cast<unsigned int>(parts.size());
+    job.geometry = GeometryCount::of(parts);
+    for (size_t i = 0; i < parts.size() && !handle.isCancelled(); i++)
+      queuePart(jobPtr, std::move(parts[i]), decodedTextures, i,
+                static_cast<float>(i + 1) / parts.size());
+    job.report.add("Textures", job.textureMs, job.geometry, job.geometry);
+    return;
+  }
+
+  Assimp::Importer importer;
+  importer.SetProgressHandler(
+      new ImportProgress(handle.m_importProgress, handle));
+  const aiScene *scene =
+      Model::importAssimp(importer, path, job.options, job.report);
+
+  if (!handle.isCancelled() && !scene) {
+    LOG_CORE_ERROR("Assimp Error ({0}): {1}", path, importer.GetErrorString());
+    std::lock_guard<std::mutex> lock(job.mutex);
+    job.error = importer.GetErrorString();
+    return;
+  }
+
+  std::vector<const aiMesh *> meshes;
+  if (!handle.isCancelled())
+    Model::collectMeshes(scene->mRootNode, scene, meshes);
+  handle.m_partCount = static_cast<unsigned int>(meshes.size());
+
+  const std::string directory =
+      std::filesystem::path(path).parent_path().string();
+
+  const GeometryCount before =
+      scene ? GeometryCount::of(*scene) : GeometryCount();
+  GeometryCount converted;
+  float convertMs = 0.0f, splitMs = 0.0f, meshletMs = 0.0f;
+  size_t partIndex = 0;
+  for (size_t i = 0; i < meshes.size() && !handle.isCancelled(); i++) {
+    auto start = ImportReport::Clock::now();
+    ModelPartData part = Model::importPart(meshes[i], scene, directory);
+    convertMs += std::chrono::duration<float, std::milli>(
+                     ImportReport::Clock::now() - start)
+                     .count();
+    converted.add(part);
+
+    std::vector<ModelPartData> chunks;
+    if (job.options.split16BitMeshes) {
+      start = ImportReport::Clock::now();
+      chunks = Model::splitPart(std::move(part));
+      splitMs += std::chrono::duration<float, std::milli>(
+                     ImportReport::Clock::now() - start)
+                     .count();
+      handle.m_partCount += static_cast<unsigned int>(chunks.size() - 1);
+    } else {
+      chunks.push_back(std::move(part));
+    }
+    if (job.options.buildMeshlets) {
+      start = ImportReport::Clock::now();
+      for (ModelPartData &chunk : chunks)
+        chunk.meshlets = Meshlet::build(chunk.vertices, chunk.indices);
+      meshletMs += std::chrono::duration<float, std::milli>(
+                       ImportReport::Clock::now() - start)
+                       .count();
+    }
+
+    for (ModelPartData &chunk : chunks) {
+      job.geometry.add(chunk);
+      queuePart(jobPtr, std::move(chunk), decodedTextures, partIndex++,
+                static_cast<float>(i + 1) / meshes.size());
+    }
+  }
+  job.report.add("Convert", convertMs, before, converted);
+  if (job.options.split16BitMeshes)
+    job.report.add("Split", splitMs, converted, job.geometry);
+  if (job.options.buildMeshlets)
+    job.report.add("Meshlets", meshletMs, job.geometry, job.geometry);
+  job.report.add("Textures", job.textureMs, job.geometry, job.geometry);
+}
+
+void ModelLoader::queuePart(const std::shared_ptr<Job> &jobPtr,
+                            ModelPartData data,
+                            std::unordered_set<std::string> &decodedTextures,
+                            size_t index, float progress) {
+  Job &job = *jobPtr;
+  auto partPtr = std::make_shared<ReadyPart>();
+  ReadyPart &part = *partPtr;
+  part.data = std::move(data);
+  part.index = static_cast<int>(index);
+
+  // Decoding and block-compressing textures is the slow part of an import,
+  // so it happens here rather than during the main-thread upload.
+  auto start = ImportReport::Clock::now();
+  part.textureData.resize(part.data.textures.size());
+  for (size_t t = 0; t < part.data.textures.size(); t++) {
+    const ModelTextureRef &ref = part.data.textures[t];
+    if (!decodedTextures.insert(ref.path).second)
+      continue;
+    part.textureData[t] =
+        ref.encoded ? Texture::loadData(ref.encoded, ref.encodedSize, ref.type,
+                                        job.textureConfig)
+                    : Texture::loadData(ref.path, ref.type, job.textureConfig);
+  }
+  job.textureMs += std::chrono::duration<float, std::milli>(
+                     ImportReport::Clock::now() - start)
+                     .count();
+
+  // Held weakly: a load dropped by the ModelLoader has nothing to upload
+  // into, and its queued parts then only release their CPU data.
+  job.pendingUploads++;
+  std::weak_ptr<Job> weakJob = jobPtr;
+  JobSystem::get().runOnMainThread([weakJob, partPtr]() {
+    std::shared_ptr<Job> job = weakJob.lock();
+    if (!job)
+      return;
+    ModelLoadHandle &handle = *job->handle;
+    if (!handle.isCancelled()) {
+      handle.m_state = ModelLoadState::Uploading;
+      auto start = std::chrono::steady_clock::now();
+      job->loader->uploadPart(*job, *partPtr);
+      job->uploadMs += std::chrono::duration<float, std::milli>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+      handle.m_uploadedCount++;
+    }
+    job->pendingUploads--;
+  });
+  job.handle->m_importProgress = 0.3f + 0.7f * progress;
+}
+
+void ModelLoader::update() {
+  for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+    Job &job = **it;
+    ModelLoadHandle &handle = *job.handle;
+
+    // Once the counter drains the import has returned and queues no more
+    // parts. Cancelled parts still in the main-thread queue are skipped
+    // when they run, so only finished uploads are waited for.
+    bool importFinished = job.importJob.isDone();
+    bool uploadsDone = job.pendingUploads.load() == 0;
+
+    if (handle.isCancelled())
+      handle.m_state = ModelLoadState::Cancelled;
+
+    if (!importFinished || (!uploadsDone && !handle.isCancelled())) {
+      ++it;
+      continue;
+    }
+
+    if (handle.isCancelled()) {
+      LOG_CORE_WARN("Model load cancelled: {0}", handle.getPath());
+    } else if (!job.error.empty()) {
+      handle.m_state = ModelLoadState::Failed;
+    } else {
+      handle.m_state = ModelLoadState::Done;
+      m_resourceManager.addModel(job.modelKey, job.parts);
+      LOG_CORE_INFO("Model loaded: {0} ({1} parts)", handle.getPath(),
+                    handle.m_partCount.load());
+      job.report.add("Upload", job.uploadMs, job.geometry, job.geometry);
+      job.report.log(handle.getPath(), job.options);
+      m_lastReportPath = handle.getPath();
+      m_lastReport = job.report;
+      Model::logSavings(handle.getPath(), job.savings);
+    }
+
+    it = m_jobs.erase(it);
+  }
+}
+
+void ModelLoader::uploadPart(Job &job, ReadyPart &part) {
+  auto mesh = Model::createMesh(part.data, m_resourceManager, job.savings);
+  auto material = std::make_shared<Material>(job.shader);
+
+  for (size_t i = 0; i < part.data.textures.size(); i++) {
+    const ModelTextureRef &ref = part.data.textures[i];
+    auto texture = m_resourceManager.getTexture(ref.path);
+    if (!texture)
+      texture = m_resourceManager.addTexture(
+          ref.path, ref.type, std::move(part.textureData[i]), &job.savings);
+    material->setTexture(ref.uniformName, texture);
+  }
+
+  job.scene->addEntity(mesh, material, job.transform, job.modelId, part.index);
+
+  if (job.parts.size() <= static_cast<size_t>(part.index))
+    job.parts.resize(part.index + 1);
+  job.parts[part.index] = {mesh, material};
+}
+
+std::vector<std::shared_ptr<ModelLoadHandle>>
+ModelLoader::getActiveLoads() const {
+  std::vector<std::shared_ptr<ModelLoadHandle>> loads;
+  loads.reserve(m_jobs.size());
+  for (const auto &job : m_jobs)
+    loads.push_back(job->handle);
+  return loads;
+}
\ No newline at end of file
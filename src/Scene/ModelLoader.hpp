@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Core/JobSystem.hpp"
+#include "Core/Transform.hpp"
+#include "Graphics/ResourceManager.hpp"
+#include "Scene/Model.hpp"
+#include "Scene/Scene.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+enum class ModelLoadState { Importing, Uploading, Done, Failed, Cancelled };
+
+// Shared between the caller, the import thread and ModelLoader::update().
+class ModelLoadHandle {
+public:
+  explicit ModelLoadHandle(std::string path) : m_path(std::move(path)) {}
+
+  const std::string &getPath() const { return m_path; }
+  ModelLoadState getState() const { return m_state.load(); }
+  bool isFinished() const;
+
+  // 0..1: the first half covers import and texture decoding, the second half
+  // GPU uploads on the main thread.
+  float getProgress() const;
+
+  // Stops importing and adding parts; parts already in the scene stay.
+  void cancel() { m_cancelled = true; }
+  bool isCancelled() const { return m_cancelled.load(); }
+
+private:
+  friend class ModelLoader;
+
+  std::string m_path;
+  std::atomic<ModelLoadState> m_state{ModelLoadState::Importing};
+  std::atomic<float> m_importProgress{0.0f};
+  std::atomic<unsigned int> m_partCount{0};
+  std::atomic<unsigned int> m_uploadedCount{0};
+  std::atomic<bool> m_cancelled{false};
+};
+
+// Imports models on the job system's background lane and feeds their parts
+// into a Scene through its main-thread queue, a few per frame, so rendering
+// continues while a model streams in.
+class ModelLoader {
+public:
+  explicit ModelLoader(ResourceManager &resourceManager);
+  ~ModelLoader();
+
+  ModelLoader(const ModelLoader &other) = delete;
+  ModelLoader &operator=(const ModelLoader &other) = delete;
+
+  // A model the ResourceManager still holds is added straight away, sharing
+  // its meshes and materials, and the returned handle is already Done.
+  std::shared_ptr<ModelLoadHandle>
+  load(const std::string &path, Scene &scene, std::shared_ptr<Shader> shader,
+       const Transform &transform = Transform());
+
+  // Main thread only: finishes loads whose parts have all been uploaded.
+  // The uploads themselves run from the JobSystem's main-thread queue.
+  void update();
+
+  std::vector<std::shared_ptr<ModelLoadHandle>> getActiveLoads() const;
+
+  // Stages of the most recently completed import, for the UI.
+  const std::string &getLastReportPath() const { return m_lastReportPath; }
+  const ImportReport &getLastReport() const { return m_lastReport; }
+
+private:
+  struct ReadyPart {
+    ModelPartData data;
+    int index = 0;
+    // Decoded on the import thread; empty for paths an earlier part of the
+    // same model already carried.
+    std::vector<TextureData> textureData;
+  };
+
+  struct Job {
+    std::shared_ptr<ModelLoadHandle> handle;
+    Scene *scene = nullptr;
+    std::shared_ptr<Shader> shader;
+    Transform transform;
+    TextureConfig textureConfig;
+    int modelId = -1;
+    std::string modelKey;
+    // Registered with the ResourceManager once every part is uploaded.
+    std::vector<SharedModelPart> parts;
+    DedupSavings savings;
+
+    ImportOptions options;
+    // Stages run on the import thread; texture decoding and uploads are
+    // spread over parts (and frames) and summed.
+    ImportReport report;
+    GeometryCount geometry;
+    float textureMs = 0.0f;
+    float uploadMs = 0.0f;
+
+    ModelLoader *loader = nullptr;
+    JobCounter importJob;
+    // Parts handed to JobSystem::runOnMainThread() and not uploaded yet.
+    std::atomic<int> pendingUploads{0};
+    std::mutex mutex;
+    std::string error;
+  };
+
+  ResourceManager &m_resourceManager;
+  std::vector<std::shared_ptr<Job>> m_jobs;
+  std::string m_lastReportPath;
+  ImportReport m_lastReport;
+
+  static void runImport(const std::shared_ptr<Job> &job);
+  // `progress` is how much of the import is done once this part is queued.
+  static void queuePart(const std::shared_ptr<Job> &job, ModelPartData data,
+                        std::unordered_set<std::string> &decodedTextures,
+                        size_t index, float progress);
+  void uploadPart(Job &job, ReadyPart &part);
+};
\ No newline at end of file
@@ -0,0 +1,690 @@
+#include "Scene/ObjLoader.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Log.hpp"
+#include "Core/MappedFile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+// Chunks smaller than this are not worth a job of their own.
+constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
+constexpr unsigned int SHARD_BITS = 6;
+constexpr size_t SHARD_COUNT = size_t(1) << SHARD_BITS;
+constexpr size_t CORNERS_PER_BATCH = 1 << 16;
+
+// 1-based OBJ indices are stored 0-based; NONE marks an omitted component.
+// Negative (relative) indices become an offset from the chunk's first
+// element, which may point into earlier chunks, and are stored as
+// REL_BASE - (offset + REL_BIAS) until chunk bases are known.
+constexpr int32_t NONE = -1;
+constexpr int32_t REL_BASE = -2;
+constexpr int64_t REL_BIAS = int64_t(1) << 29;
+
+struct Corner {
+  int32_t position;
+  int32_t uv;
+  int32_t normal;
+
+  bool operator==(const Corner &other) const {
+    return position == other.position && uv == other.uv &&
+           normal == other.normal;
+  }
+};
+
+struct Group {
+  std::string material;
+  // The first group of a chunk continues whatever material the previous
+  // chunk ended with.
+  bool inherited = false;
+  std::vector<Corner> corners;
+};
+
+struct Chunk {
+  const char *begin = nullptr;
+  const char *end = nullptr;
+
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec2> uvs;
+  std::vector<glm::vec3> normals;
+  std::vector<Group> groups;
+  std::vector<std::string> materialLibraries;
+
+  size_t positionBase = 0;
+  size_t uvBase = 0;
+  size_t normalBase = 0;
+  bool supported = true;
+};
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline const char *skipSpaces(const char *p, const char *end) {
+  while (p < end && isSpace(*p))
+    ++p;
+  return p;
+}
+
+inline const char *lineEnd(const char *p, const char *end) {
+  const void *nl = std::memchr(p, '\n', static_cast<size_t>(end - p));
+  return nl ? static_cast<const char *>(nl) : end;
+}
+
+// strtof() is locale-dependent and needs a terminated string; this parses
+// in place and is exact for the fixed-point values exporters write.
+bool parseFloat(const char *&p, const char *end, float &out) {
+  static constexpr double POW10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  p = skipSpaces(p, end);
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool any = false;
+
+  for (; p < end && isDigit(*p); ++p, any = true) {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+      digits += mantissa != 0;
+    } else {
+      exponent++;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && isDigit(*p); ++p, any = true) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        digits += mantissa != 0;
+        exponent--;
+      }
+    }
+  }
+  if (!any)
+    return false;
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool negativeExponent = false;
+    if (p < end && (*p == '-' || *p == '+'))
+      negativeExponent = *p++ == '-';
+    if (p >= end || !isDigit(*p))
+      return false;
+    int value = 0;
+    for (; p < end && isDigit(*p); ++p)
+      value = std::min(value * 10 + (*p - '0'), 10000);
+    exponent += negativeExponent ? -value : value;
+  }
+
+  double value = static_cast<double>(mantissa);
+  if (exponent < 0 && exponent >= -22)
+    value /= POW10[-exponent];
+  else if (exponent > 0 && exponent <= 22)
+    value *= POW10[exponent];
+  else if (exponent != 0)
+    value *= std::pow(10.0, exponent);
+
+  out = static_cast<float>(negative ? -value : value);
+  return true;
+}
+
+bool parseIndex(const char *&p, const char *end, int64_t &out) {
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+  if (p >= end || !isDigit(*p))
+    return false;
+  int64_t value = 0;
+  for (; p < end && isDigit(*p); ++p)
+    value = std::min<int64_t>(value * 10 + (*p - '0'), INT32_MAX);
+  out = negative ? -value : value;
+  return true;
+}
+
+// Maps an OBJ index onto the stored form described at NONE/REL_BASE.
+bool resolveIndex(int64_t index, size_t localCount, int32_t &out) {
+  if (index > 0) {
+    out = static_cast<int32_t>(index - 1);
+    return true;
+  }
+  if (index < 0) {
+    int64_t offset = static_cast<int64_t>(localCount) + index + REL_BIAS;
+    if (offset < 0 || offset > 3 * REL_BIAS)
+      return false;
+    out = static_cast<int32_t>(REL_BASE - offset);
+    return true;
+  }
+  return false;
+}
+
+bool parseFace(const char *p, const char *end, Chunk &chunk, Group &group,
+               std::vector<Corner> &face) {
+  face.clear();
+  while (true) {
+    p = skipSpaces(p, end);
+    if (p >= end)
+      break;
+
+    Corner corner{NONE, NONE, NONE};
+    int64_t index;
+    if (!parseIndex(p, end, index) ||
+        !resolveIndex(index, chunk.positions.size(), corner.position))
+      return false;
+
+    if (p < end && *p == '/') {
+      ++p;
+      if (p < end && *p != '/') {
+        if (!parseIndex(p, end, index) ||
+            !resolveIndex(index, chunk.uvs.size(), corner.uv))
+          return false;
+      }
+      if (p < end && *p == '/') {
+        ++p;
+        if (!parseIndex(p, end, index) ||
+            !resolveIndex(index, chunk.normals.size(), corner.normal))
+          return false;
+      }
+    }
+    if (p < end && !isSpace(*p))
+      return false;
+
+    face.push_back(corner);
+  }
+
+  // Fan triangulation, matching aiProcess_Triangulate for convex polygons.
+  for (size_t i = 1; i + 1 < face.size(); i++) {
+    group.corners.push_back(face[0]);
+    group.corners.push_back(face[i]);
+    group.corners.push_back(face[i + 1]);
+  }
+  return true;
+}
+
+std::string restOfLine(const char *p, const char *end) {
+  p = skipSpaces(p, end);
+  while (end > p && isSpace(end[-1]))
+    --end;
+  return std::string(p, end);
+}
+
+bool keywordIs(const char *p, const char *end, const char *keyword) {
+  size_t length = std::strlen(keyword);
+  return static_cast<size_t>(end - p) >= length &&
+         std::memcmp(p, keyword, length) == 0 &&
+         (static_cast<size_t>(end - p) == length || isSpace(p[length]));
+}
+
+void parseChunk(Chunk &chunk) {
+  std::vector<Corner> face;
+  chunk.groups.push_back({});
+  chunk.groups.back().inherited = true;
+
+  const char *p = chunk.begin;
+  while (p < chunk.end && chunk.supported) {
+    const char *end = lineEnd(p, chunk.end);
+    const char *line = skipSpaces(p, end);
+    p = end + 1;
+
+    if (line >= end || *line == '#')
+      continue;
+
+    const char *args = line + 1;
+    bool ok = true;
+    switch (*line) {
+    case 'v':
+      if (keywordIs(line, end, "v")) {
+        glm::vec3 v;
+        ok = parseFloat(args, end, v.x) && parseFloat(args, end, v.y) &&
+             parseFloat(args, end, v.z);
+        chunk.positions.push_back(v);
+      } else if (keywordIs(line, end, "vt")) {
+        args++;
+        glm::vec2 uv(0.0f);
+        ok = parseFloat(args, end, uv.x);
+        parseFloat(args, end, uv.y);
+        // Same convention as aiProcess_FlipUVs.
+        uv.y = 1.0f - uv.y;
+        chunk.uvs.push_back(uv);
+      } else if (keywordIs(line, end, "vn")) {
+        args++;
+        glm::vec3 n;
+        ok = parseFloat(args, end, n.x) && parseFloat(args, end, n.y) &&
+             parseFloat(args, end, n.z);
+        chunk.normals.push_back(n);
+      } else {
+        ok = false;
+      }
+      break;
+    case 'f':
+      ok = keywordIs(line, end, "f") &&
+           parseFace(args, end, chunk, chunk.groups.back(), face);
+      break;
+    case 'u':
+      if (keywordIs(line, end, "usemtl")) {
+        chunk.groups.push_back({});
+        chunk.groups.back().material = restOfLine(line + 6, end);
+      } else {
+        ok = false;
+      }
+      break;
+    case 'm':
+      if (keywordIs(line, end, "mtllib"))
+        chunk.materialLibraries.push_back(restOfLine(line + 6, end));
+      else
+        ok = false;
+      break;
+    case 'o':
+    case 'g':
+    case 's':
+    case 'l':
+    case 'p':
+      // Objects, smoothing groups and point/line primitives carry nothing a
+      // triangle mesh needs.
+      ok = args >= end || isSpace(*args);
+      break;
+    default:
+      ok = false;
+      break;
+    }
+
+    if (!ok)
+      chunk.supported = false;
+  }
+}
+
+// Texture statements put their options ("-bm 1.0", "-o 0.5 0.5", ...)
+// before the file name, which runs to the end of the line, spaces included.
+std::string mapFilename(const char *p, const char *end) {
+  // Most options take one argument; -o, -s and -t take one to three numbers.
+  static const std::pair<const char *, int> OPTIONS[] = {
+      {"-blendu", 1}, {"-blendv", 1},  {"-boost", 1}, {"-cc", 1},
+      {"-clamp", 1},  {"-imfchan", 1}, {"-texres", 1}, {"-type", 1},
+      {"-bm", 1},     {"-mm", 2},      {"-o", 3},      {"-s", 3},
+      {"-t", 3}};
+  auto tokenEnd = [end](const char *q) {
+    while (q < end && !isSpace(*q))
+      q++;
+    return q;
+  };
+
+  while ((p = skipSpaces(p, end)) < end && *p == '-') {
+    const char *optionEnd = tokenEnd(p);
+    int arguments = 0;
+    bool numbers = false;
+    for (const auto &[name, count] : OPTIONS) {
+      if (keywordIs(p, end, name)) {
+        arguments = count;
+        numbers = count == 3;
+        break;
+      }
+    }
+    p = optionEnd;
+    for (int i = 0; i < arguments; i++) {
+      const char *argument = skipSpaces(p, end);
+      if (argument >= end)
+        break;
+      if (numbers && i > 0 &&
+          !(std::isdigit(static_cast<unsigned char>(*argument)) ||
+            *argument == '-' || *argument == '+' || *argument == '.'))
+        break;
+      p = tokenEnd(argument);
+    }
+  }
+  return restOfLine(p, end);
+}
+
+// map_Kd/map_Ks per material.
+std::unordered_map<std::string, std::vector<ModelTextureRef>>
+parseMaterialLibrary(const std::string &path, const std::string &directory) {
+  std::unordered_map<std::string, std::vector<ModelTextureRef>> materials;
+
+  std::ifstream file(path);
+  if (!file) {
+    LOG_CORE_WARN("ObjLoader: could not open material library {0}", path);
+    return materials;
+  }
+
+  std::vector<ModelTextureRef> *current = nullptr;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream stream(line);
+    std::string keyword;
+    stream >> keyword;
+    if (keyword.empty())
+      continue;
+    const char *end = line.c_str() + line.size();
+    const char *args = line.c_str() + line.find(keyword) + keyword.size();
+
+    if (keyword == "newmtl") {
+      current = &materials[restOfLine(args, end)];
+      continue;
+    }
+    if (!current || (keyword != "map_Kd" && keyword != "map_Ks"))
+      continue;
+
+    const std::string filename = mapFilename(args, end);
+    if (filename.empty())
+      continue;
+
+    // Assimp only keeps the first map of each type, so do the same.
+    auto hasType = [current](TextureType type) {
+      return std::any_of(current->begin(), current->end(),
+                         [type](const ModelTextureRef &ref) {
+                           return ref.type == type;
+                         });
+    };
+    if (keyword == "map_Kd" && !hasType(TextureType::Diffuse))
+      current->push_back({"texture_diffuse", directory + "/" + filename,
+                          TextureType::Diffuse, nullptr, nullptr, 0});
+    else if (keyword == "map_Ks" && !hasType(TextureType::Specular))
+      current->push_back({"texture_specular", directory + "/" + filename,
+                          TextureType::Specular, nullptr, nullptr, 0});
+  }
+  return materials;
+}
+
+struct VertexTable {
+  struct Slot {
+    Corner key;
+    uint32_t value;
+  };
+
+  std::vector<Slot> slots;
+  std::vector<Corner> keys;
+
+  static uint64_t hash(const Corner &c) {
+    uint64_t h = static_cast<uint32_t>(c.position) * 0x9E3779B97F4A7C15ull;
+    h ^= static_cast<uint32_t>(c.uv) * 0xC2B2AE3D27D4EB4Full;
+    h ^= static_cast<uint32_t>(c.normal) * 0x165667B19E3779F9ull;
+    return h ^ (h >> 29);
+  }
+
+  static size_t shardOf(uint64_t h) { return h >> (64 - SHARD_BITS); }
+
+  void reserve(size_t count) {
+    size_t capacity = 16;
+    while (capacity < count * 2)
+      capacity <<= 1;
+    slots.assign(capacity, {{NONE, NONE, NONE}, 0});
+  }
+
+  uint32_t insert(const Corner &key, uint64_t h) {
+    const size_t mask = slots.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+      Slot &slot = slots[i];
+      if (slot.key.position == NONE) {
+        slot.key = key;
+        slot.value = static_cast<uint32_t>(keys.size());
+        keys.push_back(key);
+        return slot.value;
+      }
+      if (slot.key == key)
+        return slot.value;
+    }
+  }
+};
+
+} // namespace
+
+bool ObjLoader::canLoad(const std::string &path) {
+  std::string extension = std::filesystem::path(path).extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return extension == ".obj";
+}
+
+bool ObjLoader::load(const std::string &path, std::vector<ModelPartData> &parts,
+                     const ProgressCallback &onProgress) {
+  auto report = [&onProgress](float progress) {
+    return !onProgress || onProgress(progress);
+  };
+
+  MappedFile file(path);
+  if (!file.isOpen())
+    return false;
+
+  JobSystem &jobs = JobSystem::get();
+  const char *data = file.data();
+  const char *dataEnd = data + file.size();
+
+  // Split on line boundaries, a few chunks per thread.
+  const size_t threads = jobs.getWorkerCount() + 1;
+  const size_t chunkBytes =
+      std::max(MIN_CHUNK_BYTES, file.size() / (threads * 4) + 1);
+  std::vector<Chunk> chunks;
+  for (const char *p = data; p < dataEnd;) {
+    const char *end = p + std::min(chunkBytes, static_cast<size_t>(dataEnd - p));
+    end = end < dataEnd ? lineEnd(end, dataEnd) : dataEnd;
+    end = std::min(end + 1, dataEnd);
+
+    chunks.push_back({});
+    chunks.back().begin = p;
+    chunks.back().end = end;
+    p = end;
+  }
+
+  jobs.parallelFor(chunks.size(), [&chunks](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      parseChunk(chunks[i]);
+  });
+
+  for (const Chunk &chunk : chunks) {
+    if (!chunk.supported) {
+      LOG_CORE_INFO("ObjLoader: {0} uses unsupported statements", path);
+      return false;
+    }
+  }
+  if (!report(0.4f))
+    return false;
+
+  // Chunk bases turn local indices into global ones.
+  size_t positionCount = 0, uvCount = 0, normalCount = 0;
+  for (Chunk &chunk : chunks) {
+    chunk.positionBase = positionCount;
+    chunk.uvBase = uvCount;
+    chunk.normalBase = normalCount;
+    positionCount += chunk.positions.size();
+    uvCount += chunk.uvs.size();
+    normalCount += chunk.normals.size();
+  }
+  if (positionCount > static_cast<size_t>(INT32_MAX) ||
+      uvCount > static_cast<size_t>(INT32_MAX) ||
+      normalCount > static_cast<size_t>(INT32_MAX))
+    return false;
+
+  // Groups sharing a material become one part, in order of first use.
+  std::vector<std::string> materialOrder;
+  std::unordered_map<std::string, std::vector<std::pair<Chunk *, Group *>>>
+      groupsByMaterial;
+  std::string currentMaterial;
+  for (Chunk &chunk : chunks) {
+    for (Group &group : chunk.groups) {
+      if (!group.inherited)
+        currentMaterial = group.material;
+      if (group.corners.empty())
+        continue;
+      auto &list = groupsByMaterial[currentMaterial];
+      if (list.empty())
+        materialOrder.push_back(currentMaterial);
+      list.push_back({&chunk, &group});
+    }
+  }
+
+  const std::string directory =
+      std::filesystem::path(path).parent_path().string();
+  std::unordered_map<std::string, std::vector<ModelTextureRef>> materials;
+  for (const Chunk &chunk : chunks) {
+    for (const std::string &library : chunk.materialLibraries) {
+      // Either one library whose name has spaces, or several separated by
+      // them.
+      std::vector<std::string> names{library};
+      std::error_code ec;
+      if (!std::filesystem::exists(directory + "/" + library, ec)) {
+        std::istringstream stream(library);
+        names.clear();
+        for (std::string name; stream >> name;)
+          names.push_back(name);
+      }
+      for (const std::string &name : names) {
+        auto parsed = parseMaterialLibrary(directory + "/" + name, directory);
+        materials.insert(parsed.begin(), parsed.end());
+      }
+    }
+  }
+
+  // Global attribute arrays, copied chunk by chunk in parallel.
+  std::vector<glm::vec3> positions(positionCount);
+  std::vector<glm::vec2> uvs(uvCount);
+  std::vector<glm::vec3> normals(normalCount);
+  jobs.parallelFor(chunks.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const Chunk &chunk = chunks[i];
+      std::copy(chunk.positions.begin(), chunk.positions.end(),
+                positions.begin() + chunk.positionBase);
+      std::copy(chunk.uvs.begin(), chunk.uvs.end(),
+                uvs.begin() + chunk.uvBase);
+      std::copy(chunk.normals.begin(), chunk.normals.end(),
+                normals.begin() + chunk.normalBase);
+    }
+  });
+
+  std::vector<ModelPartData> result;
+  result.reserve(materialOrder.size());
+
+  for (size_t m = 0; m < materialOrder.size(); m++) {
+    const auto &groups = groupsByMaterial[materialOrder[m]];
+    const size_t groupCount = groups.size();
+
+    std::vector<size_t> groupBase(groupCount + 1, 0);
+    for (size_t g = 0; g < groupCount; g++)
+      groupBase[g + 1] = groupBase[g] + groups[g].second->corners.size();
+    const size_t cornerCount = groupBase[groupCount];
+    if (cornerCount > UINT32_MAX)
+      return false;
+
+    // Flatten the material's corners with global indices, releasing the
+    // per-chunk copies as we go.
+    std::vector<Corner> corners(cornerCount);
+    std::atomic<bool> valid{true};
+    jobs.parallelFor(groupCount, [&](size_t begin, size_t end) {
+      auto resolve = [](int32_t &index, size_t base, size_t count) {
+        if (index <= REL_BASE) {
+          int64_t global = static_cast<int64_t>(base) + (REL_BASE - index) -
+                           REL_BIAS;
+          if (global < 0)
+            return false;
+          index = static_cast<int32_t>(global);
+        }
+        return index < static_cast<int64_t>(count);
+      };
+
+      for (size_t g = begin; g < end; g++) {
+        const Chunk &chunk = *groups[g].first;
+        std::vector<Corner> &source = groups[g].second->corners;
+        Corner *out = corners.data() + groupBase[g];
+        for (Corner c : source) {
+          if (!resolve(c.position, chunk.positionBase, positionCount) ||
+              !resolve(c.uv, chunk.uvBase, uvCount) ||
+              !resolve(c.normal, chunk.normalBase, normalCount)) {
+            valid = false;
+            return;
+          }
+          *out++ = c;
+        }
+        std::vector<Corner>().swap(source);
+      }
+    });
+    if (!valid) {
+      LOG_CORE_WARN("ObjLoader: {0} has out-of-range face indices", path);
+      return false;
+    }
+
+    // Bucket corners by shard in fixed-size batches; identical corners hash
+    // to the same shard, so shards can be welded independently.
+    const size_t batchCount = std::max<size_t>(
+        1, std::min(threads * 4, cornerCount / CORNERS_PER_BATCH));
+    const size_t batchSize = (cornerCount + batchCount - 1) / batchCount;
+    std::vector<std::vector<uint32_t>> shardCorners(batchCount * SHARD_COUNT);
+    jobs.parallelFor(batchCount, [&](size_t begin, size_t end) {
+      for (size_t b = begin; b < end; b++) {
+        size_t last = std::min(cornerCount, (b + 1) * batchSize);
+        for (size_t i = b * batchSize; i < last; i++) {
+          size_t shard = VertexTable::shardOf(VertexTable::hash(corners[i]));
+          shardCorners[b * SHARD_COUNT + shard].push_back(
+              static_cast<uint32_t>(i));
+        }
+      }
+    });
+
+    std::vector<VertexTable> tables(SHARD_COUNT);
+    std::vector<uint32_t> cornerVertex(cornerCount);
+    jobs.parallelFor(SHARD_COUNT, [&](size_t begin, size_t end) {
+      for (size_t s = begin; s < end; s++) {
+        size_t count = 0;
+        for (size_t b = 0; b < batchCount; b++)
+          count += shardCorners[b * SHARD_COUNT + s].size();
+        tables[s].reserve(count);
+
+        for (size_t b = 0; b < batchCount; b++)
+          for (uint32_t i : shardCorners[b * SHARD_COUNT + s])
+            cornerVertex[i] =
+                tables[s].insert(corners[i], VertexTable::hash(corners[i]));
+      }
+    });
+
+    std::vector<size_t> shardBase(SHARD_COUNT + 1, 0);
+    for (size_t s = 0; s < SHARD_COUNT; s++)
+      shardBase[s + 1] = shardBase[s] + tables[s].keys.size();
+
+    ModelPartData part;
+    part.vertices.resize(shardBase[SHARD_COUNT]);
+    part.indices.resize(cornerCount);
+
+    jobs.parallelFor(SHARD_COUNT, [&](size_t begin, size_t end) {
+      for (size_t s = begin; s < end; s++) {
+        Vertex *out = part.vertices.data() + shardBase[s];
+        for (const Corner &c : tables[s].keys) {
+          out->Position = positions[c.position];
+          out->TexCoords = c.uv != NONE ? uvs[c.uv] : glm::vec2(0.0f);
+          out->Normal = c.normal != NONE ? normals[c.normal] : glm::vec3(0.0f);
+          ++out;
+        }
+      }
+    });
+
+    jobs.parallelFor(
+        cornerCount,
+        [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            size_t shard = VertexTable::shardOf(VertexTable::hash(corners[i]));
+            part.indices[i] =
+                static_cast<unsigned int>(shardBase[shard] + cornerVertex[i]);
+          }
+        },
+        CORNERS_PER_BATCH);
+
+    auto material = materials.find(materialOrder[m]);
+    if (material != materials.end())
+      part.textures = material->second;
+
+    result.push_back(std::move(part));
+    if (!report(0.4f + 0.6f * static_cast<float>(m + 1) / materialOrder.size()))
+      return false;
+  }
+
+  parts = std::move(result);
+  return true;
+}
\ No newline at end of file
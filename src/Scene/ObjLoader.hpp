@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Scene/Model.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Native Wavefront OBJ/MTL reader for large files. The file is memory-mapped
+// and split into line-aligned chunks that are parsed in parallel; corners
+// are then welded into shared vertices through a sharded hash, one shard per
+// job, and written straight into Vertex/index arrays.
+class ObjLoader {
+public:
+  // Called between phases with 0..1; returning false cancels the load.
+  using ProgressCallback = std::function<bool(float progress)>;
+
+  static bool canLoad(const std::string &path);
+
+  // Produces one part per material. Returns false, with `parts` untouched,
+  // when the file uses anything this reader does not handle (free-form
+  // geometry, smooth surfaces, ...) so the caller can fall
+  // back to Assimp, or when the callback cancelled the load.
+  static bool load(const std::string &path, std::vector<ModelPartData> &parts,
+                   const ProgressCallback &onProgress = nullptr);
+};
\ No newline at end of file
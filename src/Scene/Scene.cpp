@@ -4,19 +4,59 @@
 #include "Core/Input.hpp"
 #include "Core/KeyCodes.hpp"
 
+#include <algorithm>
+
 Scene::Scene(const CameraConfig &cameraConfig, const RenderConfig &renderConfig)
     : m_camera(cameraConfig), m_lightPos(renderConfig.LightPosition) {}
 
 void Scene::addEntity(const std::shared_ptr<Mesh> &mesh,
                       const std::shared_ptr<Material> &material,
-                      const Transform &transform) {
+                      const Transform &transform, int model, int part) {
   Entity e;
   e.mesh = mesh;
   e.material = material;
   e.transform = transform;
+  e.model = model;
+  e.part = part;
   m_entities.push_back(e);
 }
 
+void Scene::clear() {
+  m_entities.clear();
+  m_models.clear();
+}
+
+int Scene::registerModel(const std::string &path, uint64_t keyFlags) {
+  auto it = std::find_if(m_models.begin(), m_models.end(),
+                         [&](const SceneModel &model) {
+                           return model.path == path &&
+                                  model.keyFlags == keyFlags;
+                         });
+  if (it != m_models.end())
+    return static_cast<int>(it - m_models.begin());
+  m_models.push_back({path, keyFlags});
+  return static_cast<int>(m_models.size() - 1);
+}
+
+void Scene::setEntityDynamic(size_t index, bool dynamic) {
+  if (index < m_entities.size())
+    m_entities[index].dynamic = dynamic;
+}
+
+void Scene::setModelDynamic(int model, bool dynamic) {
+  for (Entity &entity : m_entities) {
+    if (entity.model == model)
+      entity.dynamic = dynamic;
+  }
+}
+
+bool Scene::isModelDynamic(int model) const {
+  return std::any_of(m_entities.begin(), m_entities.end(),
+                     [model](const Entity &entity) {
+                       return entity.model == model && entity.dynamic;
+                     });
+}
+
 void Scene::onUpdate(float dt, const InputManager &input) {
   if (input.isActionPressed(Action::MoveForward))
     m_camera.processKeyboard(CameraMovement::FORWARD, dt);
@@ -4,17 +4,34 @@
 #include "Core/InputManager.hpp"
 #include "Core/Transform.hpp"
 #include "Graphics/Camera.hpp"
+#include "Graphics/LightClusters.hpp"
 #include "Graphics/Material.hpp"
 #include "Graphics/Mesh.hpp"
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
+#include <string>
 #include <vector>
 
+// A model file and the import options it was loaded with
+// (ImportOptions::getKeyFlags()), which decide how it is split into parts.
+struct SceneModel {
+  std::string path;
+  uint64_t keyFlags = 0;
+};
+
 struct Entity {
   Transform transform;
   std::shared_ptr<Mesh> mesh;
   std::shared_ptr<Material> material;
+  // Model (index into Scene::getModels()) and part the entity was loaded
+  // from, so snapshots can refer to it; -1 for geometry built in code.
+  int model = -1;
+  int part = -1;
+  // Moves every frame: drawn into the shadow map each frame instead of
+  // invalidating its cached faces. Set with Scene::setEntityDynamic().
+  bool dynamic = false;
 };
 
 class Scene {
@@ -26,12 +43,27 @@ public:
 
   void addEntity(const std::shared_ptr<Mesh> &mesh,
                  const std::shared_ptr<Material> &material,
-                 const Transform &transform = Transform());
+                 const Transform &transform = Transform(), int model = -1,
+                 int part = -1);
+  void reserveEntities(size_t count) { m_entities.reserve(count); }
+  // Removes every entity and forgets the models.
+  void clear();
+
+  // Index of the model in the scene's model list, adding it if needed.
+  int registerModel(const std::string &path, uint64_t keyFlags);
+  const std::vector<SceneModel> &getModels() const { return m_models; }
+
+  void setEntityDynamic(size_t index, bool dynamic);
+  // Every entity loaded from the model; true if any of them is dynamic.
+  void setModelDynamic(int model, bool dynamic);
+  bool isModelDynamic(int model) const;
 
   Camera &getCamera() { return m_camera; }
   const std::vector<Entity> &getEntities() const { return m_entities; }
 
   glm::vec3 &getLightPos() { return m_lightPos; }
+  // Local lights on top of the main one at getLightPos().
+  std::vector<PointLight> &getPointLights() { return m_pointLights; }
   std::vector<glm::vec4> &getClippingPlanes() { return m_clippingPlanes; }
 
   void onMouseView(float xoffset, float yoffset);
@@ -39,7 +71,9 @@ public:
 private:
   Camera m_camera;
   std::vector<Entity> m_entities;
+  std::vector<SceneModel> m_models;
 
   glm::vec3 m_lightPos;
+  std::vector<PointLight> m_pointLights;
   std::vector<glm::vec4> m_clippingPlanes;
 };
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "Scene/SceneSnapshot.hpp"
+#include "Core/Log.hpp"
+#include "Core/MappedFile.hpp"
+#include "Scene/Model.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x4E535644; // "DVSN"
+constexpr uint32_t SNAPSHOT_VERSION = 3;
+constexpr uint32_t MAX_PLANES = 8;
+constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+struct SnapshotHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entityCount;
+  uint32_t modelCount;
+  uint64_t entitiesOffset;
+  uint64_t modelsOffset;
+  uint64_t stringsOffset;
+  uint64_t stringsSize;
+  uint64_t lightsOffset;
+
+  float cameraPosition[3];
+  float cameraYaw;
+  float cameraPitch;
+  float lightPosition[3];
+  uint32_t planeCount;
+  uint32_t pointLightCount;
+  float planes[MAX_PLANES][4];
+};
+
+struct SnapshotPointLight {
+  float position[3];
+  float radius;
+  float color[3];
+  float intensity;
+};
+
+static_assert(sizeof(SnapshotPointLight) == 32,
+              "SnapshotPointLight must stay packed");
+
+// Part indices depend on how the model was imported, so the import options
+// (ImportOptions::getKeyFlags()) are stored with the path and reused on load.
+struct SnapshotModel {
+  uint32_t pathOffset;
+  uint32_t pathLength;
+  uint64_t keyFlags;
+};
+
+static_assert(sizeof(SnapshotModel) == 16, "SnapshotModel must stay packed");
+
+struct SnapshotEntity {
+  float position[3];
+  float rotation[3];
+  float scale[3];
+  uint32_t model;
+  uint32_t part;
+  uint32_t flags;
+};
+
+constexpr uint32_t ENTITY_DYNAMIC = 1u << 0;
+
+static_assert(sizeof(SnapshotEntity) == 48, "SnapshotEntity must stay packed");
+
+struct PartRef {
+  std::shared_ptr<Mesh> mesh;
+  std::shared_ptr<Material> material;
+};
+
+uint64_t alignUp(uint64_t value) {
+  return (value + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+void writeAt(std::ofstream &file, uint64_t offset, const void *data,
+             size_t size) {
+  file.seekp(static_cast<std::streamoff>(offset));
+  file.write(static_cast<const char *>(data),
+             static_cast<std::streamsize>(size));
+}
+
+} // namespace
+
+bool SceneSnapshot::save(const std::string &path, Scene &scene) {
+  const auto &entities = scene.getEntities();
+  std::vector<SnapshotModel> models;
+  std::string strings;
+  for (const SceneModel &model : scene.getModels()) {
+    models.push_back({static_cast<uint32_t>(strings.size()),
+                      static_cast<uint32_t>(model.path.size()),
+                      model.keyFlags});
+    strings += model.path;
+  }
+
+  std::vector<SnapshotEntity> records;
+  records.reserve(entities.size());
+  size_t skipped = 0;
+  for (const Entity &entity : entities) {
+    if (entity.model < 0 || entity.part < 0) {
+      skipped++;
+      continue;
+    }
+    SnapshotEntity record{};
+    std::memcpy(record.position, &entity.transform.getPosition(),
+                sizeof(record.position));
+    std::memcpy(record.rotation, &entity.transform.getRotation(),
+                sizeof(record.rotation));
+    std::memcpy(record.scale, &entity.transform.getScale(),
+                sizeof(record.scale));
+    record.model = static_cast<uint32_t>(entity.model);
+    record.part = static_cast<uint32_t>(entity.part);
+    record.flags = entity.dynamic ? ENTITY_DYNAMIC : 0;
+    records.push_back(record);
+  }
+  if (skipped > 0)
+    LOG_CORE_WARN("SceneSnapshot: skipped {0} entities not loaded from a "
+                  "model file",
+                  skipped);
+
+  SnapshotHeader header{};
+  header.magic = SNAPSHOT_MAGIC;
+  header.version = SNAPSHOT_VERSION;
+  header.entityCount = static_cast<uint32_t>(records.size());
+  header.modelCount = static_cast<uint32_t>(models.size());
+  header.entitiesOffset = alignUp(sizeof(SnapshotHeader));
+  header.modelsOffset =
+      alignUp(header.entitiesOffset + records.size() * sizeof(SnapshotEntity));
+  std::vector<SnapshotPointLight> lights;
+  for (const PointLight &light : scene.getPointLights()) {
+    SnapshotPointLight record{};
+    std::memcpy(record.position, &light.position, sizeof(record.position));
+    record.radius = light.radius;
+    std::memcpy(record.color, &light.color, sizeof(record.color));
+    record.intensity = light.intensity;
+    lights.push_back(record);
+  }
+  header.pointLightCount = static_cast<uint32_t>(lights.size());
+  header.lightsOffset =
+      alignUp(header.modelsOffset + models.size() * sizeof(SnapshotModel));
+  header.stringsOffset = alignUp(header.lightsOffset +
+                                 lights.size() * sizeof(SnapshotPointLight));
+  header.stringsSize = strings.size();
+
+  Camera &camera = scene.getCamera();
+  glm::vec3 cameraPosition = camera.getPosition();
+  std::memcpy(header.cameraPosition, &cameraPosition,
+              sizeof(header.cameraPosition));
+  header.cameraYaw = camera.getYaw();
+  header.cameraPitch = camera.getPitch();
+  std::memcpy(header.lightPosition, &scene.getLightPos(),
+              sizeof(header.lightPosition));
+
+  const auto &planes = scene.getClippingPlanes();
+  header.planeCount =
+      static_cast<uint32_t>(std::min<size_t>(planes.size(), MAX_PLANES));
+  for (uint32_t i = 0; i < header.planeCount; i++)
+    std::memcpy(header.planes[i], &planes[i], sizeof(header.planes[i]));
+
+  std::error_code ec;
+  auto parent = std::filesystem::path(path).parent_path();
+  if (!parent.empty())
+    std::filesystem::create_directories(parent, ec);
+
+  std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      LOG_CORE_ERROR("SceneSnapshot: Cannot write {0}", tmpPath);
+      return false;
+    }
+
+    writeAt(file, 0, &header, sizeof(header));
+    writeAt(file, header.entitiesOffset, records.data(),
+            records.size() * sizeof(SnapshotEntity));
+    writeAt(file, header.modelsOffset, models.data(),
+            models.size() * sizeof(SnapshotModel));
+    writeAt(file, header.lightsOffset, lights.data(),
+            lights.size() * sizeof(SnapshotPointLight));
+    writeAt(file, header.stringsOffset, strings.data(), strings.size());
+
+    if (!file)
+      return false;
+  }
+
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec)
+    return false;
+
+  LOG_CORE_INFO("Scene saved to {0} ({1} entities, {2} models)", path,
+                records.size(), models.size());
+  return true;
+}
+
+bool SceneSnapshot::load(const std::string &path, Scene &scene,
+                         ResourceManager &resourceManager,
+                         std::shared_ptr<Shader> shader) {
+  auto start = std::chrono::steady_clock::now();
+
+  MappedFile file(path);
+  if (!file.isOpen() || file.size() < sizeof(SnapshotHeader)) {
+    LOG_CORE_ERROR("SceneSnapshot: Cannot read {0}", path);
+    return false;
+  }
+
+  const char *data = file.data();
+  const uint64_t size = file.size();
+  const auto *header = reinterpret_cast<const SnapshotHeader *>(data);
+
+  if (header->magic != SNAPSHOT_MAGIC ||
+      header->version != SNAPSHOT_VERSION ||
+      header->entitiesOffset + uint64_t(header->entityCount) *
+                                   sizeof(SnapshotEntity) >
+          size ||
+      header->modelsOffset +
+              uint64_t(header->modelCount) * sizeof(SnapshotModel) >
+          size ||
+      header->lightsOffset + uint64_t(header->pointLightCount) *
+                                 sizeof(SnapshotPointLight) >
+          size ||
+      header->stringsOffset + header->stringsSize > size ||
+      header->planeCount > MAX_PLANES) {
+    LOG_CORE_ERROR("SceneSnapshot: {0} is not a valid snapshot", path);
+    return false;
+  }
+
+  const auto *models =
+      reinterpret_cast<const SnapshotModel *>(data + header->modelsOffset);
+  const auto *records =
+      reinterpret_cast<const SnapshotEntity *>(data + header->entitiesOffset);
+  const char *strings = data + header->stringsOffset;
+
+  std::vector<SceneModel> sceneModels;
+  for (uint32_t i = 0; i < header->modelCount; i++) {
+    if (uint64_t(models[i].pathOffset) + models[i].pathLength >
+        header->stringsSize) {
+      LOG_CORE_ERROR("SceneSnapshot: {0} is not a valid snapshot", path);
+      return false;
+    }
+    sceneModels.push_back(
+        {std::string(strings + models[i].pathOffset, models[i].pathLength),
+         models[i].keyFlags});
+  }
+
+  // Parts already in the scene under the same import options are reused
+  // rather than imported (and uploaded to the geometry buffer) a second time.
+  std::vector<std::string> existingKeys;
+  for (const SceneModel &model : scene.getModels())
+    existingKeys.push_back(
+        ResourceManager::modelKey(model.path, model.keyFlags));
+  std::unordered_map<std::string, std::vector<PartRef>> existing;
+  for (const Entity &entity : scene.getEntities()) {
+    if (entity.model < 0 || entity.part < 0)
+      continue;
+    auto &parts = existing[existingKeys[entity.model]];
+    if (parts.size() <= static_cast<size_t>(entity.part))
+      parts.resize(entity.part + 1);
+    parts[entity.part] = {entity.mesh, entity.material};
+  }
+
+  scene.clear();
+
+  std::vector<std::vector<PartRef>> modelParts(header->modelCount);
+  for (uint32_t i = 0; i < header->modelCount; i++) {
+    const std::string &modelPath = sceneModels[i].path;
+    const uint64_t keyFlags = sceneModels[i].keyFlags;
+    // Registration order keeps snapshot model indices valid in the scene.
+    scene.registerModel(modelPath, keyFlags);
+
+    auto it = existing.find(ResourceManager::modelKey(modelPath, keyFlags));
+    if (it != existing.end() &&
+        std::all_of(it->second.begin(), it->second.end(),
+                    [](const PartRef &part) { return part.mesh != nullptr; })) {
+      modelParts[i] = std::move(it->second);
+      continue;
+    }
+
+    try {
+      Model model(modelPath, resourceManager, shader,
+                  ImportOptions::fromKeyFlags(
+                      keyFlags, resourceManager.getImportConfig()));
+      for (size_t p = 0; p < model.getPartCount(); p++)
+        modelParts[i].push_back({model.getMesh(p), model.getMaterial(p)});
+    } catch (const std::exception &e) {
+      LOG_CORE_ERROR("SceneSnapshot: Failed to load {0}: {1}", modelPath,
+                     e.what());
+    }
+  }
+  existing.clear();
+
+  auto modelsDone = std::chrono::steady_clock::now();
+
+  scene.reserveEntities(header->entityCount);
+  size_t dropped = 0;
+  for (uint32_t i = 0; i < header->entityCount; i++) {
+    const SnapshotEntity &record = records[i];
+    if (record.model >= modelParts.size() ||
+        record.part >= modelParts[record.model].size()) {
+      dropped++;
+      continue;
+    }
+    const PartRef &part = modelParts[record.model][record.part];
+
+    Transform transform;
+    transform.setPosition(glm::vec3(record.position[0], record.position[1],
+                                    record.position[2]));
+    transform.setRotation(glm::vec3(record.rotation[0], record.rotation[1],
+                                    record.rotation[2]));
+    transform.setScale(
+        glm::vec3(record.scale[0], record.scale[1], record.scale[2]));
+
+    scene.addEntity(part.mesh, part.material, transform,
+                    static_cast<int>(record.model),
+                    static_cast<int>(record.part));
+    if (record.flags & ENTITY_DYNAMIC)
+      scene.setEntityDynamic(scene.getEntities().size() - 1, true);
+  }
+
+  scene.getCamera().setPose(glm::vec3(header->cameraPosition[0],
+                                      header->cameraPosition[1],
+                                      header->cameraPosition[2]),
+                            header->cameraYaw, header->cameraPitch);
+  scene.getLightPos() =
+      glm::vec3(header->lightPosition[0], header->lightPosition[1],
+                header->lightPosition[2]);
+
+  auto &planes = scene.getClippingPlanes();
+  planes.clear();
+  for (uint32_t i = 0; i < header->planeCount; i++)
+    planes.emplace_back(header->planes[i][0], header->planes[i][1],
+                        header->planes[i][2], header->planes[i][3]);
+
+  const auto *lightRecords = reinterpret_cast<const SnapshotPointLight *>(
+      data + header->lightsOffset);
+  auto &lights = scene.getPointLights();
+  lights.clear();
+  lights.reserve(header->pointLightCount);
+  for (uint32_t i = 0; i < header->pointLightCount; i++) {
+    const SnapshotPointLight &record = lightRecords[i];
+    PointLight light;
+    light.position =
+        glm::vec3(record.position[0], record.position[1], record.position[2]);
+    light.radius = record.radius;
+    light.color = glm::vec3(record.color[0], record.color[1], record.color[2]);
+    light.intensity = record.intensity;
+    lights.push_back(light);
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  auto ms = [](auto a, auto b) {
+    return std::chrono::duration<float, std::milli>(b - a).count();
+  };
+  if (dropped > 0)
+    LOG_CORE_WARN("SceneSnapshot: dropped {0} entities with missing models",
+                  dropped);
+  LOG_CORE_INFO("Scene restored from {0}: {1} entities in {2:.1f} ms "
+                "(+{3:.1f} ms importing {4} models)",
+                path, header->entityCount - dropped, ms(modelsDone, end),
+                ms(start, modelsDone), header->modelCount);
+  return true;
+}
\ No newline at end of file
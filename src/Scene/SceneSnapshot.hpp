@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Graphics/ResourceManager.hpp"
+#include "Scene/Scene.hpp"
+
+#include <memory>
+#include <string>
+
+// Binary session file: camera, lights, clipping planes and every entity's
+// transform plus (model, part) reference. Fixed-size records at aligned
+// offsets are read straight out of a memory mapping, so restoring costs one
+// pass over the entity array on top of importing each distinct model once.
+class SceneSnapshot {
+public:
+  static bool save(const std::string &path, Scene &scene);
+
+  // Replaces the scene's contents. Models the scene already holds are
+  // reused, others are imported synchronously through the usual caches;
+  // entities whose model fails to load are dropped.
+  static bool load(const std::string &path, Scene &scene,
+                   ResourceManager &resourceManager,
+                   std::shared_ptr<Shader> shader);
+};
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Core/Log.hpp"
 
 #include <filesystem>
+#include <string>
 
 int main(int argc, char *argv[]) {
   Log::init();
@@ -11,8 +12,15 @@ int main(int argc, char *argv[]) {
   Config cfg = Config::load("config.json");
 
   std::filesystem::path modelPath = cfg.paths.DefaultModel;
-  if (argc > 1) {
-    modelPath = argv[1];
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--record" && i + 1 < argc) {
+      cfg.system.RecordInput = argv[++i];
+    } else if (arg == "--replay" && i + 1 < argc) {
+      cfg.system.ReplayInput = argv[++i];
+    } else {
+      modelPath = arg;
+    }
   }
 
   if (!std::filesystem::exists(modelPath)) {
@@ -0,0 +1,188 @@
+#include "Core/EventQueue.hpp"
+#include "Core/LayerStack.hpp"
+#include "Core/Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Dispatch cost under a synthetic event storm: every event walking the
+// LayerStack as it arrives (the old Window callbacks) against the per-frame
+// EventQueue with coalescing.
+//
+//   EventQueueBenchmark [frames]
+//
+// Each frame carries 2000 mouse moves with short scroll bursts and a few key
+// presses in between, roughly what a 8 kHz mouse delivers at 4 fps. The run
+// fails if the layers do not end up in the same state both ways.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int LAYERS = 4;
+constexpr int MOVES_PER_FRAME = 2000;
+constexpr int MOVES_PER_SCROLL = 50;
+constexpr int SCROLLS_PER_BURST = 3;
+constexpr int MOVES_PER_KEY = 500;
+
+// Roughly what the editor does with input: switch on the type, then a bit of
+// camera arithmetic.
+class InputLayer : public Layer {
+public:
+  float mouseX = 0.0f, mouseY = 0.0f;
+  float yaw = 0.0f, pitch = 0.0f;
+  float scroll = 0.0f;
+  std::vector<KeyCode> keys;
+  size_t calls = 0;
+
+  void onEvent(Event &event) override {
+    calls++;
+    switch (event.getType()) {
+    case EventType::MouseMoved: {
+      auto &moved = static_cast<MouseMovedEvent &>(event);
+      yaw += (moved.getX() - mouseX) * 0.1f;
+      pitch += (mouseY - moved.getY()) * 0.1f;
+      pitch = std::fmax(-89.0f, std::fmin(89.0f, pitch));
+      mouseX = moved.getX();
+      mouseY = moved.getY();
+      break;
+    }
+    case EventType::MouseScrolled:
+      scroll += static_cast<MouseScrolledEvent &>(event).getYOffset();
+      break;
+    case EventType::KeyPressed:
+      keys.push_back(static_cast<KeyPressedEvent &>(event).getKeyCode());
+      break;
+    default:
+      break;
+    }
+  }
+
+  bool sameInput(const InputLayer &other) const {
+    return mouseX == other.mouseX && mouseY == other.mouseY &&
+           scroll == other.scroll && keys == other.keys;
+  }
+};
+
+struct Stack {
+  LayerStack layers;
+  std::vector<InputLayer *> inputLayers;
+
+  Stack() {
+    for (int i = 0; i < LAYERS; i++) {
+      inputLayers.push_back(new InputLayer());
+      layers.pushLayer(inputLayers.back());
+    }
+  }
+
+  // Same walk as App::dispatchEvent.
+  void dispatch(Event &event) {
+    for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+      (*it)->onEvent(event);
+      if (event.m_handled)
+        break;
+    }
+  }
+
+  size_t calls() const {
+    size_t total = 0;
+    for (const InputLayer *layer : inputLayers)
+      total += layer->calls;
+    return total;
+  }
+};
+
+// Feeds one frame of the storm to `sink`: straight into a layer stack, or
+// into the queue.
+template <typename Sink> void storm(int frame, Sink &sink) {
+  for (int i = 0; i < MOVES_PER_FRAME; i++) {
+    const float t = static_cast<float>(frame * MOVES_PER_FRAME + i);
+    sink.move(400.0f + 300.0f * std::sin(t * 0.001f),
+              300.0f + 200.0f * std::cos(t * 0.0013f));
+    if (i % MOVES_PER_SCROLL == 0)
+      for (int s = 0; s < SCROLLS_PER_BURST; s++)
+        sink.scroll(1.0f);
+    if (i % MOVES_PER_KEY == 0)
+      sink.key(static_cast<KeyCode>(static_cast<int>(KeyCode::A) +
+                                    (i / MOVES_PER_KEY) % 26));
+  }
+}
+
+struct ImmediateSink {
+  Stack &stack;
+  void move(float x, float y) {
+    MouseMovedEvent event(x, y);
+    stack.dispatch(event);
+  }
+  void scroll(float y) {
+    MouseScrolledEvent event(0.0f, y);
+    stack.dispatch(event);
+  }
+  void key(KeyCode code) {
+    KeyPressedEvent event(code);
+    stack.dispatch(event);
+  }
+};
+
+struct QueueSink {
+  EventQueue &queue;
+  void move(float x, float y) { queue.push<MouseMovedEvent>(x, y); }
+  void scroll(float y) { queue.push<MouseScrolledEvent>(0.0f, y); }
+  void key(KeyCode code) { queue.push<KeyPressedEvent>(code); }
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Log::init();
+  const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+
+  Stack immediate, queued;
+  EventQueue queue;
+  queue.setHandler([&queued](Event &event) { queued.dispatch(event); });
+  ImmediateSink immediateSink{immediate};
+  QueueSink queueSink{queue};
+
+  float immediateMs = 0.0f, queuedMs = 0.0f;
+  bool ok = true;
+  for (int frame = 0; frame < frames; frame++) {
+    auto start = Clock::now();
+    storm(frame, immediateSink);
+    immediateMs +=
+        std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    storm(frame, queueSink);
+    queue.dispatch();
+    queuedMs +=
+        std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+
+    for (int i = 0; i < LAYERS; i++)
+      ok &= immediate.inputLayers[i]->sameInput(*queued.inputLayers[i]);
+  }
+
+  const double events =
+      static_cast<double>(MOVES_PER_FRAME) +
+      MOVES_PER_FRAME / MOVES_PER_SCROLL * SCROLLS_PER_BURST +
+      MOVES_PER_FRAME / MOVES_PER_KEY;
+  std::printf("%d frames, %.0f events and %d layers per frame\n", frames,
+              events, LAYERS);
+  std::printf("%-10s %12s %16s\n", "path", "us/frame", "layer calls/frame");
+  std::printf("%-10s %12.1f %16.0f\n", "immediate",
+              1000.0f * immediateMs / frames,
+              static_cast<double>(immediate.calls()) / frames);
+  std::printf("%-10s %12.1f %16.0f\n", "queued", 1000.0f * queuedMs / frames,
+              static_cast<double>(queued.calls()) / frames);
+  std::printf("speedup    %11.2fx, %zu events coalesced\n",
+              immediateMs / std::max(queuedMs, 0.001f),
+              queue.getCoalescedCount());
+
+  if (!ok)
+    std::fprintf(stderr, "FAILED: queued dispatch changed the input seen\n");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "Core/JobSystem.hpp"
+#include "Core/Log.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Stress test and scaling benchmark for the job system.
+//
+//   JobSystemBenchmark --stress       correctness under contention (ctest)
+//   JobSystemBenchmark [maxThreads]   throughput from 1 thread up to
+//                                     maxThreads (default: every hardware
+//                                     thread, at most 64)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+float elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(Clock::now() - start)
+      .count();
+}
+
+bool check(bool condition, const char *what, unsigned int workers) {
+  if (!condition)
+    std::fprintf(stderr, "FAILED with %u workers: %s\n", workers, what);
+  return condition;
+}
+
+// Roughly 50ns of arithmetic the compiler cannot fold away.
+float work(size_t i) {
+  float x = static_cast<float>(i & 1023) + 1.0f;
+  for (int k = 0; k < 8; k++)
+    x = std::sqrt(x * 1.7f + 0.3f);
+  return x;
+}
+
+// Every job adds one and schedules its children against the same counter,
+// so the counter only drains once the whole tree has run.
+void spawnTree(JobCounter &counter, std::atomic<int> &visited, int depth) {
+  visited.fetch_add(1, std::memory_order_relaxed);
+  if (depth == 0)
+    return;
+  for (int i = 0; i < 4; i++)
+    JobSystem::get().run(
+        [&counter, &visited, depth]() {
+          spawnTree(counter, visited, depth - 1);
+        },
+        &counter);
+}
+
+uint64_t sumRange(size_t count, size_t minChunk = 1) {
+  std::atomic<uint64_t> sum{0};
+  JobSystem::get().parallelFor(
+      count,
+      [&sum](size_t begin, size_t end) {
+        uint64_t local = 0;
+        for (size_t i = begin; i < end; i++)
+          local += i;
+        sum.fetch_add(local, std::memory_order_relaxed);
+      },
+      minChunk);
+  return sum.load();
+}
+
+bool stress(unsigned int workers) {
+  JobSystem &jobs = JobSystem::get();
+  jobs.init(workers);
+  bool ok = true;
+
+  // Parent/child trees: 4^0 + ... + 4^6 jobs each.
+  for (int round = 0; round < 20; round++) {
+    JobCounter counter;
+    std::atomic<int> visited{0};
+    jobs.run([&counter, &visited]() { spawnTree(counter, visited, 6); },
+             &counter);
+    jobs.wait(counter);
+    ok &= check(visited.load() == 5461, "job tree", workers);
+  }
+
+  // parallelFor nested inside parallelFor.
+  for (int round = 0; round < 20; round++) {
+    std::atomic<uint64_t> total{0};
+    jobs.parallelFor(64, [&total](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++)
+        total.fetch_add(sumRange(10000), std::memory_order_relaxed);
+    });
+    ok &= check(total.load() == 64ull * (10000ull * 9999ull / 2),
+                "nested parallelFor", workers);
+  }
+
+  // Long background jobs feeding the pool while the main thread runs loops
+  // of its own: the main thread must never end up running one of them.
+  const std::thread::id mainThread = std::this_thread::get_id();
+  JobCounter background;
+  std::atomic<int> backgroundDone{0};
+  std::atomic<bool> ranOnMain{false};
+  for (int i = 0; i < 4; i++)
+    jobs.runBackground(
+        [&]() {
+          if (std::this_thread::get_id() == mainThread)
+            ranOnMain = true;
+          for (int round = 0; round < 50; round++)
+            if (sumRange(200000, 64) != 200000ull * 199999ull / 2)
+              return;
+          backgroundDone++;
+        },
+        &background);
+  while (!background.isDone())
+    ok &= check(sumRange(100000, 64) == 100000ull * 99999ull / 2,
+                "parallelFor beside background jobs", workers);
+  ok &= check(backgroundDone.load() == 4, "background parallelFor", workers);
+  ok &= check(!ranOnMain.load(), "background job ran on the main thread",
+              workers);
+
+  // GL-style work handed back from jobs runs on the main thread only, and a
+  // zero budget still runs one job per frame.
+  std::vector<int> mainOrder;
+  bool offMain = false;
+  jobs.parallelFor(1000, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      jobs.runOnMainThread([&, i]() {
+        offMain |= std::this_thread::get_id() != mainThread;
+        mainOrder.push_back(static_cast<int>(i));
+      });
+    }
+  });
+  for (int frame = 0; frame < 1000 && mainOrder.size() < 1000; frame++)
+    jobs.executeMainThreadJobs(0.0f);
+  ok &= check(mainOrder.size() == 1000 && !offMain,
+              "main-thread jobs ran on the main thread", workers);
+
+  // Many tiny jobs on one counter.
+  JobCounter counter;
+  std::atomic<int> ran{0};
+  for (int i = 0; i < 200000; i++)
+    jobs.run([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); },
+             &counter);
+  jobs.wait(counter);
+  ok &= check(ran.load() == 200000, "tiny jobs", workers);
+
+  jobs.shutdown();
+  return ok;
+}
+
+struct Result {
+  float computeMs;
+  float fineMs;
+  float jobsMs;
+};
+
+Result measure(unsigned int threads) {
+  constexpr size_t COMPUTE_ITEMS = size_t(1) << 23;
+  constexpr size_t FINE_ITEMS = size_t(1) << 20;
+  constexpr int TINY_JOBS = 1 << 18;
+
+  JobSystem &jobs = JobSystem::get();
+  // A single thread is measured inline, without a pool.
+  if (threads > 1)
+    jobs.init(threads - 1);
+
+  std::vector<float> out(COMPUTE_ITEMS);
+  auto compute = [&out](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      out[i] = work(i);
+  };
+  // Chunked so scheduling overhead is measured, not the arithmetic.
+  auto fine = [&out](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      out[i] += 1.0f;
+  };
+
+  Result result{};
+  auto start = Clock::now();
+  if (threads > 1)
+    jobs.parallelFor(COMPUTE_ITEMS, compute, 4096);
+  else
+    compute(0, COMPUTE_ITEMS);
+  result.computeMs = elapsedMs(start);
+
+  start = Clock::now();
+  for (int round = 0; round < 16; round++) {
+    if (threads > 1)
+      jobs.parallelFor(FINE_ITEMS, fine, 256);
+    else
+      fine(0, FINE_ITEMS);
+  }
+  result.fineMs = elapsedMs(start) / 16.0f;
+
+  std::atomic<int> ran{0};
+  start = Clock::now();
+  if (threads > 1) {
+    JobCounter counter;
+    for (int i = 0; i < TINY_JOBS; i++)
+      jobs.run([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); },
+               &counter);
+    jobs.wait(counter);
+  } else {
+    for (int i = 0; i < TINY_JOBS; i++)
+      ran.fetch_add(1, std::memory_order_relaxed);
+  }
+  result.jobsMs = elapsedMs(start);
+
+  jobs.shutdown();
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Log::init();
+  const unsigned int hardware =
+      std::max(1u, std::thread::hardware_concurrency());
+
+  if (argc > 1 && std::string(argv[1]) == "--stress") {
+    bool ok = true;
+    for (unsigned int workers : {1u, 3u, 7u, std::max(1u, hardware - 1)})
+      ok &= stress(workers);
+    std::printf(ok ? "Stress test passed\n" : "Stress test FAILED\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  unsigned int maxThreads = std::min(64u, hardware);
+  if (argc > 1)
+    maxThreads = std::max(1, std::atoi(argv[1]));
+
+  std::vector<unsigned int> counts;
+  for (unsigned int t = 1; t < maxThreads; t *= 2)
+    counts.push_back(t);
+  counts.push_back(maxThreads);
+
+  std::printf("%7s %12s %8s %14s %14s\n", "threads", "compute ms", "speedup",
+              "chunk loop ms", "tiny jobs/ms");
+  float baseline = 0.0f;
+  for (unsigned int threads : counts) {
+    const Result result = measure(threads);
+    if (threads == 1)
+      baseline = result.computeMs;
+    std::printf("%7u %12.2f %7.2fx %14.3f %14.0f\n", threads,
+                result.computeMs, baseline / result.computeMs, result.fineMs,
+                (1 << 18) / result.jobsMs);
+  }
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
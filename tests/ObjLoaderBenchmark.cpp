@@ -0,0 +1,196 @@
+#include "Core/JobSystem.hpp"
+#include "Core/Log.hpp"
+#include "Scene/ImportPipeline.hpp"
+#include "Scene/ObjLoader.hpp"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Native OBJ reader against the Assimp path it replaces.
+//
+//   ObjLoaderBenchmark [file.obj]    times both readers on the file
+//   ObjLoaderBenchmark --grid N      on a generated N x N quad grid (ctest
+//                                    runs a small one)
+//
+// Without arguments a 1000 x 1000 grid is generated. Either way the run
+// fails if the two readers disagree on the triangle count. The generated
+// material library and texture have spaces in their names, and the texture
+// statement carries options, so the run also checks the file name parsing.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int RUNS = 3;
+const char *TEXTURE_NAME = "grid texture.png";
+
+float elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<float, std::milli>(Clock::now() - start)
+      .count();
+}
+
+std::string writeGrid(const std::filesystem::path &directory, int n) {
+  std::filesystem::create_directories(directory);
+  {
+    std::ofstream mtl(directory / "grid material.mtl");
+    mtl << "newmtl surface\nKd 1 1 1\nmap_Kd -bm 1.0 -o 0.5 0.5 "
+        << TEXTURE_NAME << "\n";
+  }
+
+  const std::filesystem::path path = directory / "grid.obj";
+  std::ofstream obj(path);
+  obj << "mtllib grid material.mtl\n";
+  char line[128];
+  for (int y = 0; y <= n; y++) {
+    for (int x = 0; x <= n; x++) {
+      const float u = static_cast<float>(x) / n, v = static_cast<float>(y) / n;
+      std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\n",
+                    u * 10.0f, 0.1f * ((x * 7 + y * 13) % 17), v * 10.0f, u,
+                    v);
+      obj << line << "vn 0 1 0\n";
+    }
+  }
+  obj << "usemtl surface\n";
+  for (int y = 0; y < n; y++) {
+    for (int x = 0; x < n; x++) {
+      const int a = y * (n + 1) + x + 1, b = a + 1, c = a + n + 1,
+                d = c + 1;
+      std::snprintf(line, sizeof(line),
+                    "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, c, c,
+                    c, d, d, d, b, b, b);
+      obj << line;
+    }
+  }
+  return path.string();
+}
+
+struct Counts {
+  size_t vertices = 0;
+  size_t triangles = 0;
+};
+
+Counts loadNative(const std::string &path, std::vector<ModelPartData> &parts) {
+  parts.clear();
+  if (!ObjLoader::load(path, parts))
+    return {};
+  Counts counts;
+  for (const ModelPartData &part : parts) {
+    counts.vertices += part.vertices.size();
+    counts.triangles += part.indices.size() / 3;
+  }
+  return counts;
+}
+
+// ReadFile with the default preset's steps, then the copy into Vertex and
+// index arrays that Model::importPart makes.
+Counts loadAssimp(const std::string &path) {
+  const ImportOptions options = ImportOptions::fromConfig(ImportConfig());
+  Assimp::Importer importer;
+  const aiScene *scene = importer.ReadFile(path, options.assimpSteps);
+  if (!scene)
+    return {};
+
+  Counts counts;
+  for (unsigned int m = 0; m < scene->mNumMeshes; m++) {
+    const aiMesh *mesh = scene->mMeshes[m];
+    ModelPartData part;
+    part.vertices.resize(mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+      Vertex &v = part.vertices[i];
+      v.Position = {mesh->mVertices[i].x, mesh->mVertices[i].y,
+                    mesh->mVertices[i].z};
+      if (mesh->HasNormals())
+        v.Normal = {mesh->mNormals[i].x, mesh->mNormals[i].y,
+                    mesh->mNormals[i].z};
+      if (mesh->mTextureCoords[0])
+        v.TexCoords = {mesh->mTextureCoords[0][i].x,
+                       mesh->mTextureCoords[0][i].y};
+    }
+    part.indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
+    for (unsigned int f = 0; f < mesh->mNumFaces; f++)
+      for (unsigned int k = 0; k < mesh->mFaces[f].mNumIndices; k++)
+        part.indices.push_back(mesh->mFaces[f].mIndices[k]);
+    counts.vertices += part.vertices.size();
+    counts.triangles += part.indices.size() / 3;
+  }
+  return counts;
+}
+
+template <typename Load> float bestOf(Load load) {
+  float best = 0.0f;
+  for (int run = 0; run < RUNS; run++) {
+    auto start = Clock::now();
+    load();
+    const float ms = elapsedMs(start);
+    best = run == 0 ? ms : std::min(best, ms);
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Log::init();
+  Log::getCoreLogger()->set_level(spdlog::level::warn);
+  JobSystem::get().init();
+
+  std::string path;
+  bool generated = true;
+  int gridSize = 1000;
+  if (argc > 2 && std::string(argv[1]) == "--grid") {
+    gridSize = std::max(1, std::atoi(argv[2]));
+  } else if (argc > 1) {
+    path = argv[1];
+    generated = false;
+  }
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "deltaviewer_obj_benchmark";
+  if (generated)
+    path = writeGrid(directory, gridSize);
+
+  std::error_code ec;
+  const double megabytes = std::filesystem::file_size(path, ec) / 1048576.0;
+  std::printf("%s: %.1f MB, %u worker threads\n", path.c_str(), megabytes,
+              JobSystem::get().getWorkerCount());
+
+  std::vector<ModelPartData> parts;
+  Counts native, assimp;
+  const float nativeMs = bestOf([&]() { native = loadNative(path, parts); });
+  const float assimpMs = bestOf([&]() { assimp = loadAssimp(path); });
+
+  std::printf("%-8s %10s %12s %12s\n", "reader", "ms", "vertices",
+              "triangles");
+  std::printf("%-8s %10.1f %12zu %12zu\n", "native", nativeMs,
+              native.vertices, native.triangles);
+  std::printf("%-8s %10.1f %12zu %12zu\n", "assimp", assimpMs,
+              assimp.vertices, assimp.triangles);
+  std::printf("speedup  %9.2fx\n", assimpMs / std::max(nativeMs, 0.001f));
+
+  bool ok = native.triangles > 0 && native.triangles == assimp.triangles;
+  if (!ok)
+    std::fprintf(stderr, "FAILED: the readers disagree\n");
+  if (generated) {
+    const bool textured =
+        parts.size() == 1 && parts[0].textures.size() == 1 &&
+        std::filesystem::path(parts[0].textures[0].path).filename() ==
+            TEXTURE_NAME;
+    if (!textured)
+      std::fprintf(stderr, "FAILED: texture \"%s\" not found\n",
+                   TEXTURE_NAME);
+    ok &= textured;
+    std::filesystem::remove_all(directory, ec);
+  }
+
+  JobSystem::get().shutdown();
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
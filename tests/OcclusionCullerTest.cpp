@@ -0,0 +1,137 @@
+#include "Core/JobSystem.hpp"
+#include "Core/Log.hpp"
+#include "Graphics/OccluderMesh.hpp"
+#include "Graphics/OcclusionCuller.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Occluder building, rasterization and visibility tests on the CPU. Hidden
+// boxes must be reported hidden, and anything that peeks past an occluder's
+// silhouette or through a gap in it must stay visible.
+
+namespace {
+
+struct Geometry {
+  std::vector<glm::vec3> positions;
+  std::vector<uint32_t> indices;
+
+  // An n x n grid of quads spanning [x0, x1] x [y0, y1] at depth z.
+  void addPlate(float x0, float x1, float y0, float y1, float z, int n) {
+    const uint32_t base = static_cast<uint32_t>(positions.size());
+    for (int j = 0; j <= n; j++)
+      for (int i = 0; i <= n; i++)
+        positions.push_back({x0 + (x1 - x0) * i / n,
+                             y0 + (y1 - y0) * j / n, z});
+    for (int j = 0; j < n; j++) {
+      for (int i = 0; i < n; i++) {
+        const uint32_t a = base + j * (n + 1) + i, b = a + 1,
+                       c = a + n + 1, d = c + 1;
+        indices.insert(indices.end(), {a, b, d, a, d, c});
+      }
+    }
+  }
+
+  std::shared_ptr<const OccluderMesh> build() const {
+    return OccluderMesh::build(positions.data(), sizeof(glm::vec3),
+                               positions.size(), indices.data(),
+                               sizeof(uint32_t), indices.size());
+  }
+};
+
+BoundingBox box(glm::vec3 min, glm::vec3 max) { return {min, max}; }
+
+bool check(bool condition, const char *what) {
+  if (!condition)
+    std::fprintf(stderr, "FAILED: %s\n", what);
+  return condition;
+}
+
+glm::mat4 viewProjection(float distance) {
+  const float aspect = float(OcclusionCuller::WIDTH) / OcclusionCuller::HEIGHT;
+  return glm::perspective(glm::radians(60.0f), aspect, 0.1f, 100.0f) *
+         glm::lookAt(glm::vec3(0.0f, 0.0f, distance), glm::vec3(0.0f),
+                     glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+// A two-triangle wall, kept as is.
+bool wall() {
+  Geometry geometry;
+  geometry.addPlate(-1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 1);
+  auto occluder = geometry.build();
+  bool ok = check(occluder && occluder->getTriangleCount() == 2, "wall copy");
+  if (!ok)
+    return false;
+
+  OcclusionCuller culler;
+  culler.begin(viewProjection(4.0f));
+  culler.addOccluder(*occluder, glm::mat4(1.0f));
+  culler.rasterize();
+
+  ok &= check(
+      !culler.isVisible(box({-0.3f, -0.3f, -2.0f}, {0.3f, 0.3f, -1.0f})),
+      "box behind the wall is hidden");
+  ok &= check(culler.isVisible(box({-0.3f, -0.3f, 0.5f}, {0.3f, 0.3f, 1.0f})),
+              "box in front of the wall is visible");
+  ok &= check(culler.isVisible(box({0.9f, -0.3f, -0.2f}, {1.2f, 0.3f, -0.1f})),
+              "box past the silhouette edge is visible");
+  ok &= check(culler.isVisible(box({1.6f, -0.3f, -0.2f}, {1.9f, 0.3f, -0.1f})),
+              "box beside the wall is visible");
+  return ok;
+}
+
+// A densely tessellated wall with a narrow vertical slot, well over the
+// triangle budget. Simplifying it must not close the slot.
+bool slottedWall() {
+  constexpr float SLOT_MIN = 0.26f, SLOT_MAX = 0.30f;
+  Geometry geometry;
+  geometry.addPlate(-1.0f, SLOT_MIN, -1.0f, 1.0f, 0.0f, 64);
+  geometry.addPlate(SLOT_MAX, 1.0f, -1.0f, 1.0f, 0.0f, 64);
+  auto occluder = geometry.build();
+  bool ok = check(occluder &&
+                      occluder->getTriangleCount() > 0 &&
+                      occluder->getTriangleCount() <=
+                          OccluderMesh::MAX_TRIANGLES,
+                  "slotted wall within the budget");
+  if (!ok)
+    return false;
+
+  // Every vertex kept must be one of the wall's own.
+  for (const glm::vec3 &p : occluder->positions) {
+    bool found = false;
+    for (const glm::vec3 &q : geometry.positions)
+      found |= p == q;
+    if (!check(found, "occluder vertex moved off the surface"))
+      return false;
+  }
+
+  OcclusionCuller culler;
+  culler.begin(viewProjection(0.6f));
+  culler.addOccluder(*occluder, glm::mat4(1.0f));
+  culler.rasterize();
+
+  ok &= check(culler.isVisible(box({0.275f, -0.05f, -1.0f},
+                                   {0.285f, 0.05f, -0.9f})),
+              "box behind the slot is visible");
+  ok &= check(culler.isVisible(box({0.27f, -0.05f, 0.1f},
+                                   {0.29f, 0.05f, 0.2f})),
+              "box in front of the slot is visible");
+  return ok;
+}
+
+} // namespace
+
+int main() {
+  Log::init();
+  JobSystem::get().init();
+
+  bool ok = wall();
+  ok &= slottedWall();
+
+  JobSystem::get().shutdown();
+  std::printf(ok ? "Occlusion tests passed\n" : "Occlusion tests FAILED\n");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file